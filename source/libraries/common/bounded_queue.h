@@ -0,0 +1,133 @@
+/**
+ * @file bounded_queue.h
+ * @author Kevin Orbie
+ *
+ * @brief Defines a blocking, fixed capacity queue to connect pipeline stages running in different threads.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stddef.h>
+
+/* Standard C++ Libraries */
+#include <condition_variable>
+#include <chrono>
+#include <mutex>
+#include <deque>
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Multi producer / multi consumer FIFO with a maximum size.
+ *
+ * @details A full queue makes push() block, which propagates back-pressure to the producing stage
+ * instead of letting latency pile up in an ever growing queue. close() wakes up every waiting thread,
+ * after which push() fails and pop() only returns the remaining items, until reopen().
+ */
+template<typename T>
+class BoundedQueue final {
+   public:
+    BoundedQueue(size_t capacity): capacity_(capacity) {};
+
+    BoundedQueue(const BoundedQueue& other)            = delete;
+    BoundedQueue& operator=(const BoundedQueue& other) = delete;
+
+    /**
+     * @brief Add an item, blocking while the queue is full.
+     * @return False if the queue was closed (the item is not added).
+     */
+    bool push(T item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        not_full_.wait(lock, [this]{ return closed_ || items_.size() < capacity_; });
+        if (closed_) { return false; }
+
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    };
+
+    /**
+     * @brief Add an item, waiting at most timeout_ms for space.
+     * @return False on timeout, or if the queue was closed (the item is then left untouched).
+     */
+    bool push(T& item, int timeout_ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool space = not_full_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{
+            return closed_ || items_.size() < capacity_;
+        });
+        if (!space || closed_) { return false; }
+
+        items_.push_back(std::move(item));
+        lock.unlock();
+        not_empty_.notify_one();
+        return true;
+    };
+
+    /**
+     * @brief Take the oldest item, waiting at most timeout_ms for one to arrive.
+     * @return False on timeout, or if the queue is closed and empty.
+     */
+    bool pop(T& item, int timeout_ms) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        bool available = not_empty_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{
+            return closed_ || !items_.empty();
+        });
+        if (!available || items_.empty()) { return false; }
+
+        item = std::move(items_.front());
+        items_.pop_front();
+        lock.unlock();
+        not_full_.notify_one();
+        return true;
+    };
+
+    /**
+     * @brief Take the oldest item without waiting.
+     * @return False if the queue is empty.
+     */
+    bool tryPop(T& item) {
+        return pop(item, 0);
+    };
+
+    /**
+     * @brief Refuse new items, and wake up all blocked threads.
+     */
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        not_full_.notify_all();
+        not_empty_.notify_all();
+    };
+
+    /**
+     * @brief Accept new items again after close() (items still queued are kept).
+     */
+    void reopen() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = false;
+    };
+
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    };
+
+    size_t capacity() const { return capacity_; };
+
+   private:
+    const size_t capacity_;
+    bool closed_ = false;
+    std::deque<T> items_;
+
+    std::mutex mutex_;
+    std::condition_variable not_full_;
+    std::condition_variable not_empty_;
+};
@@ -9,7 +9,7 @@
 
 /* ========================== Include ========================== */
 /* Standard C Libraries */
-// None
+#include <stdint.h>
 
 /* Standard C++ Libraries */
 #include <chrono>
@@ -32,4 +32,12 @@ inline timestamp_t now() {
     return std::chrono::high_resolution_clock::now();
 }
 
+/**
+ * @brief Monotonic time in microseconds, used to timestamp frames.
+ * @note Has an arbitrary epoch, so only comparable between machines through a clock offset estimate.
+ */
+inline int64_t micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 }  // common
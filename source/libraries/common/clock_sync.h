@@ -0,0 +1,91 @@
+/**
+ * @file clock_sync.h
+ * @author Kevin Orbie
+ *
+ * @brief Defines an NTP-style estimate of the clock offset between two machines.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <atomic>
+#include <deque>
+#include <mutex>
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief One clock synchronization exchange (all times from common::micros() on the respective machine).
+ * @note Sent as raw memory over the control link, so only use fixed size members.
+ */
+struct ClockSync {
+    int64_t t0 = 0;  // Request sent (local).
+    int64_t t1 = 0;  // Request recieved (remote).
+    int64_t t2 = 0;  // Reply sent (remote).
+};
+
+/**
+ * @brief Estimates the offset of a remote clock, from a number of ClockSync exchanges.
+ *
+ * @details Every exchange gives offset = ((t1 - t0) + (t2 - t3)) / 2, which is exact if the request
+ * and reply took equally long. The exchange with the smallest round trip (t3 - t0) - (t2 - t1) out of
+ * the last few has the least queueing delay, and is used as estimate.
+ */
+class ClockOffset final {
+    static constexpr size_t WINDOW = 16;
+
+    struct Sample {
+        int64_t offset;
+        int64_t round_trip;
+    };
+
+   public:
+    /**
+     * @brief Add the result of an exchange, of which the reply was recieved at local time t3.
+     */
+    void update(ClockSync const& sync, int64_t t3) {
+        Sample sample = {((sync.t1 - sync.t0) + (sync.t2 - t3)) / 2, (t3 - sync.t0) - (sync.t2 - sync.t1)};
+        if (sample.round_trip < 0) {
+            return;  // Invalid exchange.
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        samples_.push_back(sample);
+        if (samples_.size() > WINDOW) {
+            samples_.pop_front();
+        }
+
+        Sample best = samples_.front();
+        for (Sample const& candidate: samples_) {
+            if (candidate.round_trip < best.round_trip) {
+                best = candidate;
+            }
+        }
+        offset_ = best.offset;
+        valid_ = true;
+    };
+
+    /**
+     * @brief Remote time minus local time (us), i.e. local time + offset() = remote time.
+     */
+    int64_t offset() const { return offset_; };
+
+    /**
+     * @brief Whether at least one exchange completed.
+     */
+    bool valid() const { return valid_; };
+
+   private:
+    std::deque<Sample> samples_;
+    std::mutex mutex_;
+
+    std::atomic<int64_t> offset_ = {0};
+    std::atomic<bool> valid_ = {false};
+};
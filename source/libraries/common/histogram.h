@@ -0,0 +1,104 @@
+/**
+ * @file histogram.h
+ * @author Kevin Orbie
+ *
+ * @brief Defines a fixed bucket latency histogram.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdio.h>   // snprintf()
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <algorithm>
+#include <string>
+#include <mutex>
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Thread-safe histogram of durations, with roughly logarithmic millisecond buckets.
+ * @note Percentiles are reported as the upper bound of the bucket they fall in.
+ */
+class Histogram final {
+    static constexpr int BUCKET_COUNT = 12;
+    static constexpr double BUCKET_BOUNDS_MS[BUCKET_COUNT] = {1, 2, 5, 10, 20, 35, 50, 75, 100, 200, 500, 1e9};
+
+   public:
+    /**
+     * @brief Add one duration (in seconds).
+     */
+    void add(double duration) {
+        double duration_ms = duration * 1e3;
+        int bucket = 0;
+        while (bucket < BUCKET_COUNT - 1 && duration_ms > BUCKET_BOUNDS_MS[bucket]) {
+            bucket++;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        buckets_[bucket]++;
+        count_++;
+        total_ms_ += duration_ms;
+        max_ms_ = std::max(max_ms_, duration_ms);
+    };
+
+    /**
+     * @brief Upper bound (in ms) of the bucket containing the given percentile [0, 100].
+     */
+    double percentile(double percent) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return percentileLocked(percent);
+    };
+
+    uint64_t count() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return count_;
+    };
+
+    /**
+     * @brief One line summary: "mean/p50/p95/max (count)" in ms.
+     */
+    std::string summary() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        char summary_str[96];
+        snprintf(summary_str, sizeof(summary_str), "%.1f/%.0f/%.0f/%.1fms (%lu)", 
+                 (count_ > 0) ? total_ms_ / count_ : 0.0, percentileLocked(50), percentileLocked(95), max_ms_, count_);
+        return std::string(summary_str);
+    };
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::fill(buckets_, buckets_ + BUCKET_COUNT, 0);
+        count_ = 0;
+        total_ms_ = 0.0;
+        max_ms_ = 0.0;
+    };
+
+   private:
+    double percentileLocked(double percent) {
+        if (count_ == 0) { return 0.0; }
+
+        uint64_t target = static_cast<uint64_t>(percent / 100.0 * count_ + 0.5);
+        uint64_t seen = 0;
+        for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+            seen += buckets_[bucket];
+            if (seen >= target && seen > 0) {
+                return std::min(BUCKET_BOUNDS_MS[bucket], max_ms_);
+            }
+        }
+        return max_ms_;
+    };
+
+   private:
+    uint64_t buckets_[BUCKET_COUNT] = {};
+    uint64_t count_ = 0;
+    double total_ms_ = 0.0;
+    double max_ms_ = 0.0;
+    std::mutex mutex_;
+};
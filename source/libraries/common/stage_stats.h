@@ -0,0 +1,88 @@
+/**
+ * @file stage_stats.h
+ * @author Kevin Orbie
+ *
+ * @brief Defines a small helper to collect and periodically log the timings of pipeline stages.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdio.h>  // snprintf()
+
+/* Standard C++ Libraries */
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <mutex>
+
+/* Custom C++ Libraries */
+#include "logger.h"
+#include "clock.h"
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Thread-safe accumulator of (mean / max) durations per named stage.
+ *
+ * @example {@code
+ *  StageStats stats("Reciever", {"demux", "decode"});
+ *  stats.add(0, common::seconds(begin, end));
+ *  stats.report(1.0);  // Logs & resets at most once per second.
+ * }
+ */
+class StageStats final {
+    struct Stage {
+        std::string name;
+        int    count = 0;
+        double total = 0.0;
+        double max   = 0.0;
+    };
+
+   public:
+    StageStats(std::string const& name, std::vector<std::string> const& stage_names): name_(name) {
+        for (std::string const& stage_name: stage_names) {
+            stages_.push_back({stage_name});
+        }
+    };
+
+    /**
+     * @brief Add one measurement (in seconds) to the given stage.
+     */
+    void add(size_t stage, double duration) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stage &s = stages_.at(stage);
+        s.count++;
+        s.total += duration;
+        s.max = std::max(s.max, duration);
+    };
+
+    /**
+     * @brief Log all stages (in ms) and reset them, if at least interval seconds passed since the last report.
+     */
+    void report(double interval) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        timestamp_t curr_time = common::now();
+        if (common::seconds(last_report_, curr_time) < interval) {
+            return;
+        }
+
+        std::string line;
+        char stage_str[128];
+        for (Stage &s: stages_) {
+            double mean = (s.count > 0) ? s.total / s.count : 0.0;
+            snprintf(stage_str, sizeof(stage_str), " %s %.2f/%.2fms (%d)", s.name.c_str(), mean * 1e3, s.max * 1e3, s.count);
+            line += stage_str;
+            s = {s.name};
+        }
+        LOGI("%s timings [mean/max]:%s", name_.c_str(), line.c_str());
+        last_report_ = curr_time;
+    };
+
+   private:
+    std::string name_;
+    std::vector<Stage> stages_;
+    timestamp_t last_report_ = common::now();
+    std::mutex mutex_;
+};
@@ -0,0 +1,92 @@
+/**
+ * @file triple_buffer.h
+ * @author Kevin Orbie
+ *
+ * @brief Defines a lock-free, single producer / single consumer, latest-value exchange.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <atomic>
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Three buffers that are rotated between one writer and one reader, without them ever blocking each other.
+ *
+ * @details The writer owns the back buffer, the reader owns the front buffer, and the middle buffer is
+ * exchanged between them with a single atomic swap. A fresh bit on the middle index tells the reader a
+ * newer value was published since its last update. Values that are published but never read are
+ * simply overwritten, so the reader always sees the newest complete value.
+ *
+ * @example {@code
+ *  // Writer thread
+ *  buffer.back() = produce();
+ *  buffer.publish();
+ *
+ *  // Reader thread
+ *  buffer.update();
+ *  consume(buffer.front());
+ * }
+ */
+template<typename T>
+class TripleBuffer final {
+    static constexpr uint8_t INDEX_MASK = 0b011;
+    static constexpr uint8_t FRESH_BIT  = 0b100;
+
+   public:
+    TripleBuffer() = default;
+    TripleBuffer(const T& initial): buffers_{initial, initial, initial} {};
+
+    /* The atomic index (and handed out references) make copies / moves unsafe. */
+    TripleBuffer(const TripleBuffer& other)            = delete;
+    TripleBuffer& operator=(const TripleBuffer& other) = delete;
+
+    /* ----------------------- Writer Interface ----------------------- */
+    /**
+     * @brief The buffer the writer can freely fill (only valid until the next publish()).
+     */
+    T& back() { return buffers_[back_]; };
+
+    /**
+     * @brief Make the back buffer available to the reader, and take over the (stale) middle buffer.
+     */
+    void publish() {
+        uint8_t previous_middle = middle_.exchange(back_ | FRESH_BIT, std::memory_order_acq_rel);
+        back_ = previous_middle & INDEX_MASK;
+    };
+
+    /* ----------------------- Reader Interface ----------------------- */
+    /**
+     * @brief Swap in the newest published value, if any.
+     * @return True if front() now holds a value that was not read before.
+     */
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & FRESH_BIT)) {
+            return false;
+        }
+
+        uint8_t previous_middle = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous_middle & INDEX_MASK;
+        return true;
+    };
+
+    /**
+     * @brief The buffer the reader can freely use (only valid until the next update()).
+     */
+    T& front() { return buffers_[front_]; };
+
+   private:
+    T buffers_[3] = {};
+    uint8_t back_  = 0;  // Only touched by the writer.
+    uint8_t front_ = 1;  // Only touched by the reader.
+    std::atomic<uint8_t> middle_ = {2};
+};
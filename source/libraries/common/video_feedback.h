@@ -0,0 +1,84 @@
+/**
+ * @file video_feedback.h
+ * @author Kevin Orbie
+ * 
+ * @brief Defines the video stream quality feedback, sent from the video reciever back to the transmitter.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <stdexcept>
+#include <vector>
+#include <string>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Reception statistics of one video stream, over one reporting period.
+ * @note Sent as raw memory over the control link, so only use fixed size members.
+ */
+struct VideoFeedback {
+    uint16_t port       = 0;     // UDP port of the video stream, identifies the stream.
+    uint32_t frames     = 0;     // Number of frames decoded in this period.
+    float    loss       = 0.0f;  // Fraction of frames that were lost or corrupted [0, 1].
+    float    decode_lag = 0.0f;  // Mean time between recieving a packet and its frame being decoded (seconds).
+    float    rtt        = 0.0f;  // Round trip time of the control link (seconds), filled in by the robot.
+};
+
+/**
+ * @brief The port that identifies the video stream at the given address (e.g. "udp://127.0.0.1:8999").
+ * @return 0 if the address has no valid port.
+ */
+inline uint16_t streamPort(std::string const& address) {
+    try {
+        int port = std::stoi(address.substr(address.rfind(':') + 1));
+        if (port < 0 || port > UINT16_MAX) { throw std::out_of_range("port"); }
+        return static_cast<uint16_t>(port);
+    } catch (const std::exception& error) {
+        LOGW("Could not parse the port of '%s'.", address.c_str());
+        return 0;
+    }
+}
+
+/**
+ * @brief The interface a class should implement if it accepts video feedback.
+ */
+class VideoFeedbackSink {
+   public:
+    virtual ~VideoFeedbackSink(){}; 
+
+    /* Rule of Five. */
+    VideoFeedbackSink()                                            = default;
+    VideoFeedbackSink(VideoFeedbackSink && other)                  = default;
+    VideoFeedbackSink(const VideoFeedbackSink& other)              = default;
+    VideoFeedbackSink& operator=(VideoFeedbackSink && other)       = default;
+    VideoFeedbackSink& operator=(const VideoFeedbackSink& other)   = default;
+
+    virtual void sink(VideoFeedback feedback) = 0;
+};
+
+
+class VideoFeedbackSplitter: public VideoFeedbackSink {
+   public:
+    VideoFeedbackSplitter(std::vector<VideoFeedbackSink*> sinks = {}): sinks_(sinks) {};
+    void sink(VideoFeedback feedback) {
+        for (VideoFeedbackSink *sink: sinks_) {
+            sink->sink(feedback);
+        }
+    };
+
+    void add(VideoFeedbackSink* sink) {
+        sinks_.push_back(sink);
+    }
+
+   private:
+    std::vector<VideoFeedbackSink*> sinks_ = {};
+};
@@ -73,13 +73,15 @@ class DepthImageCloud {
         shader_->setInt("image_width", depth_texture_->getWidth());
         shader_->setInt("image_height", depth_texture_->getHeight());
 
-        if (depth_texture_) {
+        if (depth_texture_) {  /* A single R16 plane (unit 0). */
             shader_->setInt("depthTexture", 0);
             depth_texture_->bind(0);
         }
 
-        if (color_texture_) {
-            shader_->setInt("colorTexture", 1);
+        if (color_texture_) {  /* Y, U & V planes on units 1, 2 & 3. */
+            shader_->setInt("colorYTexture", 1);
+            shader_->setInt("colorUTexture", 2);
+            shader_->setInt("colorVTexture", 3);
             color_texture_->bind(1);
         }
 
@@ -52,7 +52,7 @@ void Application::glsetup() {
     LOGI("Initializing OpenGL.");
 
     /* Initialize OpenGL Objects */
-    state->depth_video = std::make_shared<Texture>();
+    state->depth_video = std::make_shared<Texture>(GL_NEAREST);  // Each point reads one exact depth value.
     state->color_video = std::make_shared<Texture>();
 
     state->frustum = std::make_unique<Frustum>(0.00245f, 0.45101245f, 105.0f, 58.0f, state->color_video);
@@ -169,26 +169,16 @@ bool Application::processFrame(float timedelta, int width, int height, Input& us
         input_sink_->sink(input);
     }
 
-    /* Load Image (optional) */
+    /* Load Image (optional), as planes: the shaders convert to RGB. */
     if (depth_frame_provider_) {
         // NOTE: Depth image must be loaded first
-        Frame new_frame = depth_frame_provider_->getFrame(state->time, PixelFormat::YUV);
-        state->depth_video->load(
-            new_frame.image.getData(), 
-            new_frame.image.getWidth(), 
-            new_frame.image.getHeight(), 
-            GL_RGB
-        );
+        Frame new_frame = depth_frame_provider_->getFrame(state->time, PixelFormat::DEPTH16);
+        state->depth_video->load(new_frame.image, new_frame.sequence);
     }
 
     if (color_frame_provider_) {
-        Frame new_frame = color_frame_provider_->getFrame(state->time, PixelFormat::YUV);
-        state->color_video->load(
-            new_frame.image.getData(), 
-            new_frame.image.getWidth(), 
-            new_frame.image.getHeight(), 
-            GL_RGB
-        );
+        Frame new_frame = color_frame_provider_->getFrame(state->time, PixelFormat::YUV420P);
+        state->color_video->load(new_frame.image, new_frame.sequence);
     }
 
     /* (optional) Update Follow Camera */
@@ -103,8 +103,11 @@ class QuadScreen {
         shader_->setMat4("view", view);
         shader_->setMat4("projection", projection);
 
-        /* Set texture. */
+        /* Set texture (the Y, U & V planes on units 0, 1 & 2). */
         if (texture_) {
+            shader_->setInt("yTexture", 0);
+            shader_->setInt("uTexture", 1);
+            shader_->setInt("vTexture", 2);
             texture_->bind(0);
         }
 
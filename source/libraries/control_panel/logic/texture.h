@@ -8,6 +8,8 @@
 /* ========================== Include ========================== */
 /* C/C++ Libraries */
 #include <cassert>
+#include <cstring>
+#include <cstdint>
 
 /* Third Party Libraries */
 #include <stb_image.h>
@@ -18,6 +20,12 @@
 
 /* Custom c++ Libraries */
 #include "common/logger.h"
+#include "video/image.h"
+
+
+/* ========================== Defines ========================== */
+#define TEXTURE_MAX_PLANES 3  // Y, U & V
+#define TEXTURE_PBO_COUNT  3  // Pixel unpack buffers cycled through (one filled, one uploading, one spare).
 
 
 /* ========================== Classes ========================== */
@@ -25,36 +33,87 @@
 /**
  * @brief A texture to be used by OpenGL.
  * @note Making this a seperate class, allows the same texture to be used by multiple classes.
+ *
+ * @details Planar YUV images are uploaded as is, one single channel (R8) texture per plane, which shaders sample
+ * on consecutive texture units (see bind()). The (linear) chroma samplers upsample the smaller chroma planes, and
+ * the shader converts YUV to RGB, so frames need no CPU conversion before drawing.
+ *
+ * Frames are streamed through a ring of pixel unpack buffers (PBOs): load() copies the new frame into a PBO, and
+ * uploads the frame copied on the previous call from its PBO into the (immutable) texture storage. The GPU pulls
+ * that data asynchronously, so the render thread never waits for an upload, at the cost of one frame delay.
  */
 class Texture {
+    /* Describes one texture plane of an image. */
+    struct PlaneFormat {
+        int width = 0;
+        int height = 0;
+        GLenum internal_format = 0;  // Sized, e.g. GL_R8.
+        GLenum format = GL_RED;
+        GLenum type = GL_UNSIGNED_BYTE;
+        int bytes_per_pixel = 1;
+    };
+
+    /* A frame that was copied into a PBO, waiting to be uploaded. */
+    struct PendingUpload {
+        bool pending = false;
+        int pbo = 0;
+        int width = 0;
+        int height = 0;
+        int num_planes = 0;
+        PlaneFormat planes[TEXTURE_MAX_PLANES];
+        size_t offset[TEXTURE_MAX_PLANES] = {0, 0, 0};  // Plane start in the PBO, in bytes.
+        int linesize[TEXTURE_MAX_PLANES] = {0, 0, 0};   // Row stride in bytes.
+    };
+
    public:
-    Texture() {
-        /* Setting up Texture Data. */
-        glGenTextures(1, &texture_);
-        glBindTexture(GL_TEXTURE_2D, texture_);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);	
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    /**
+     * @param filter: GL_LINEAR for smooth scaling (e.g. video), GL_NEAREST to read back exact texels (e.g. depth).
+     */
+    Texture(GLint filter=GL_LINEAR): filter_(filter) {
+        /* Setting up Texture Data (no mipmaps, the textures change every frame). */
+        glGenTextures(TEXTURE_MAX_PLANES, planes_);
+        for (int plane = 0; plane < TEXTURE_MAX_PLANES; plane++) {
+            setParameters(plane);
+        }
+        glGenBuffers(TEXTURE_PBO_COUNT, pbos_);
     }
 
     /* Rule of five. */
     ~Texture() {
-        glDeleteTextures(1, &texture_);
+        glDeleteTextures(TEXTURE_MAX_PLANES, planes_);
+        glDeleteBuffers(TEXTURE_PBO_COUNT, pbos_);
     };
 
     Texture(Texture &other) = delete;  // Prevent the creation of duplicate textures.
-    Texture(Texture &&other) = default; 
+    Texture(Texture &&other) = default;
     Texture& operator=(Texture &other) = delete;
     Texture& operator=(Texture &&other) = default;
 
-    void load(uint8_t* data, int width, int height, GLenum format=GL_RGBA) {
-        if (data) {   
-            //std::cout << "Loading Texture: width, height, channels = " << width << ", " << height << ", " << channels << std::endl;
-            glBindTexture(GL_TEXTURE_2D, texture_);
-            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
+    /**
+     * @brief Upload packed (interleaved) pixel data into a single texture, straight away (e.g. for static images).
+     * @param linesize: Row stride of the given data in bytes (0 if rows are tightly packed).
+     */
+    void load(uint8_t* data, int width, int height, GLenum format=GL_RGBA, int linesize=0) {
+        if (data) {
+            int bytes_per_pixel = (format == GL_RGBA) ? 4 : (format == GL_RGB) ? 3 : 1;
+            PlaneFormat plane = {width, height, (format == GL_RGBA) ? GLenum(GL_RGBA8) : GLenum(GL_RGB8), format, GL_UNSIGNED_BYTE, bytes_per_pixel};
+            allocate(0, plane);
+
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            if (linesize % bytes_per_pixel == 0) {
+                glPixelStorei(GL_UNPACK_ROW_LENGTH, linesize / bytes_per_pixel);
+                glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+            } else {
+                /* Stride is not a whole number of pixels, upload row by row. */
+                for (int row = 0; row < height; row++) {
+                    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, row, width, 1, format, GL_UNSIGNED_BYTE, data + row * linesize);
+                }
+            }
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
 
+            pending_.pending = false;
+            last_sequence_ = 0;
+            num_planes_ = 1;
             width_ = width;
             height_ = height;
         } else {
@@ -62,23 +121,180 @@ class Texture {
         }
     }
 
+    /**
+     * @brief Stream the Y, U & V planes of a planar image (YUV420P / YUV422P) into separate R8 textures, without conversion.
+     *
+     * @param sequence: Number of the frame (0 if unknown), the upload is skipped if it did not change.
+     * @note The image becomes visible on the next call (it is uploaded from its PBO then).
+     */
+    void load(Image &image, uint32_t sequence=0) {
+        /* Hand the frame of the previous call to the GPU (this only queues a copy from its PBO). */
+        upload();
+
+        if (image.getFormat() == PixelFormat::EMPTY) {
+            return;  // No frame yet.
+        }
+        if (sequence != 0 && sequence == last_sequence_) {
+            return;  // Nothing new, the textures are up to date.
+        }
+
+        PendingUpload next = {};
+        if (!describe(image, next)) {
+            return;
+        }
+
+        /* Copy the frame into the next PBO (in one go, the planes of an Image share one buffer). */
+        size_t size = image.getSize();
+        next.pbo = (pending_.pbo + 1) % TEXTURE_PBO_COUNT;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[next.pbo]);
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);  // Orphan: never wait on a pending upload.
+        void *mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        if (mapped) {
+            memcpy(mapped, image.getData(0), size);
+            next.pending = (glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER) == GL_TRUE);
+        } else {
+            LOGW("Failed to map a pixel unpack buffer, dropping the frame.");
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        pending_ = next;
+        last_sequence_ = sequence;
+    }
+
+    /**
+     * @brief Bind the loaded planes to consecutive texture units, starting at texture_unit_id.
+     */
     void bind(const int texture_unit_id=0) {
         assert(texture_unit_id >= 0);
 
         /* There are a limited amount of texture units. */
         int max_texture_units = 0;
         glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &max_texture_units);
-        assert(texture_unit_id < max_texture_units);
+        assert(texture_unit_id + num_planes_ <= max_texture_units);
 
-        glActiveTexture(GL_TEXTURE0 + texture_unit_id);
-        glBindTexture(GL_TEXTURE_2D, texture_);
+        for (int plane = 0; plane < num_planes_; plane++) {
+            glActiveTexture(GL_TEXTURE0 + texture_unit_id + plane);
+            glBindTexture(GL_TEXTURE_2D, planes_[plane]);
+        }
     }
 
     int getWidth() { return width_; };
     int getHeight() { return height_; };
+    int getPlanes() { return num_planes_; };
 
    private:
-    unsigned int texture_;
+    /**
+     * @brief Describe the texture planes of the given image, and where they are in its buffer.
+     * @return False if the image format can't be streamed.
+     */
+    static bool describe(Image &image, PendingUpload &upload) {
+        int width  = image.getWidth();
+        int height = image.getHeight();
+        int chroma_width  = (width + 1) >> 1;
+        int chroma_height = height;
+        upload.width = width;
+        upload.height = height;
+        switch (image.getFormat()) {
+            case PixelFormat::YUV420P: chroma_height = (height + 1) >> 1; break;
+            case PixelFormat::YUV422P: break;
+            case PixelFormat::DEPTH16:
+                /* Full precision depth, read back normalized ([0, 65535] -> [0.0, 1.0]). */
+                upload.num_planes = 1;
+                upload.planes[0] = {width, height, GL_R16, GL_RED, GL_UNSIGNED_SHORT, 2};
+                upload.offset[0] = 0;
+                upload.linesize[0] = image.getLinesize(0);
+                return true;
+            default:
+                LOGW("Only planar YUV & DEPTH16 images can be loaded as planes (got format '%d')!", static_cast<int>(image.getFormat()));
+                return false;
+        }
+
+        upload.num_planes = 3;
+        upload.planes[0] = {width, height, GL_R8};
+        upload.planes[1] = {chroma_width, chroma_height, GL_R8};
+        upload.planes[2] = {chroma_width, chroma_height, GL_R8};
+        for (int plane = 0; plane < upload.num_planes; plane++) {
+            upload.offset[plane]   = static_cast<size_t>(image.getData(plane) - image.getData(0));
+            upload.linesize[plane] = image.getLinesize(plane);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Copy the pending frame from its PBO into the textures (asynchronous on the GPU side).
+     */
+    void upload() {
+        if (!pending_.pending) {
+            return;
+        }
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbos_[pending_.pbo]);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (int plane = 0; plane < pending_.num_planes; plane++) {
+            PlaneFormat const& format = pending_.planes[plane];
+            allocate(plane, format);
+
+            /* With a PBO bound, the data pointer is an offset into it. */
+            glPixelStorei(GL_UNPACK_ROW_LENGTH, pending_.linesize[plane] / format.bytes_per_pixel);
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, format.width, format.height, format.format, format.type,
+                            reinterpret_cast<const void*>(pending_.offset[plane]));
+        }
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+        num_planes_ = pending_.num_planes;
+        width_ = pending_.width;
+        height_ = pending_.height;
+        pending_.pending = false;
+    }
+
+    /**
+     * @brief Bind a plane's texture, (re)creating its storage only when its size or format changed.
+     */
+    void allocate(int plane, PlaneFormat const& format) {
+        PlaneFormat &current = sizes_[plane];
+        if (current.width == format.width && current.height == format.height && current.internal_format == format.internal_format) {
+            glBindTexture(GL_TEXTURE_2D, planes_[plane]);
+            return;
+        }
+
+        if (GLAD_GL_VERSION_4_2) {
+            /* Immutable storage can't be resized, so start from a new texture. */
+            if (current.width != 0) {
+                glDeleteTextures(1, &planes_[plane]);
+                glGenTextures(1, &planes_[plane]);
+                setParameters(plane);
+            }
+            glBindTexture(GL_TEXTURE_2D, planes_[plane]);
+            glTexStorage2D(GL_TEXTURE_2D, 1, format.internal_format, format.width, format.height);
+        } else {
+            /* OpenGL < 4.2: mutable storage, only specified on size changes as well. */
+            glBindTexture(GL_TEXTURE_2D, planes_[plane]);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            glTexImage2D(GL_TEXTURE_2D, 0, format.internal_format, format.width, format.height, 0, format.format, format.type, nullptr);
+        }
+        current = format;
+    }
+
+    void setParameters(int plane) {
+        glBindTexture(GL_TEXTURE_2D, planes_[plane]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter_);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter_);
+    }
+
+   private:
+    GLint filter_;
+    unsigned int planes_[TEXTURE_MAX_PLANES];
+    PlaneFormat sizes_[TEXTURE_MAX_PLANES];  // Current storage of each plane.
+
+    /* Streaming */
+    unsigned int pbos_[TEXTURE_PBO_COUNT];
+    PendingUpload pending_;
+    uint32_t last_sequence_ = 0;
+
+    int num_planes_ = 0;
     int width_ = 0;
     int height_ = 0;
 };
@@ -18,6 +18,10 @@ uniform mat4 projection;
 out vec2 imageCoord;
 
 
+/* ------------------------ Constants ------------------------ */
+const float DEPTH_RANGE = 65.535;  // Normalized R16 depth to meters (DEPTH16 holds millimeters).
+
+
 /* ------------------------ Functions ------------------------ */
 // None
 
@@ -29,9 +33,9 @@ void main()
     float v = (floor(float(gl_InstanceID) / float(image_width)) / float(image_height));
     imageCoord = vec2(u, v);
 
-    float depth = 1.0 - texture(depthTexture, imageCoord).x;
+    float depth = texture(depthTexture, imageCoord).x * DEPTH_RANGE;  // In meters.
 
-    if (depth == 1.0) {
+    if (depth == 0.0) {  // No depth measured
         gl_Position = vec4(2.0, 0.0, 0.0, 1.0);  // Outisde of Camera View Frustum, discarded
     } else {
         vec3 point_pos = vec3(0.00245f, (1.0 - v), u);
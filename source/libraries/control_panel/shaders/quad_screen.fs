@@ -3,30 +3,36 @@
 // Pipeline Data
 in vec2 TexCoord;
 
-// Texture Data
-uniform sampler2D screenTexture;
+// Texture Data (planar YUV, the chroma planes can be subsampled)
+uniform sampler2D yTexture;
+uniform sampler2D uTexture;
+uniform sampler2D vTexture;
 
 // Output Color
 out vec4 FragColor;
 
 
 /* ------------------------ Functions ------------------------ */
-// None
+/**
+ * @brief Convert limited range YUV (BT.601, in [0, 1]) to RGB.
+ */
+vec3 yuvToRgb(vec3 yuv) {
+    yuv = yuv * 255.0 - vec3(16.0, 128.0, 128.0);
+    return vec3(
+        1.164 * yuv.x                  + 1.596 * yuv.z, 
+        1.164 * yuv.x - 0.392 * yuv.y - 0.813 * yuv.z, 
+        1.164 * yuv.x + 2.017 * yuv.y
+    ) / 255.0;
+}
 
 
 /* ----------------------- Entry Point ----------------------- */
 void main()
 {
     // Display YUV as GREYSCALE
-    // FragColor = vec4(texture(screenTexture, TexCoord).xxx, 1.0);
-
-    // Convert YUV to RGB
-    vec4 texColor = texture(screenTexture, TexCoord);
-    texColor = vec4(texColor.x * 255 - 16, texColor.y * 255 - 128, texColor.z * 255 - 128, 1.0);
-    FragColor = vec4(
-        1.164 * texColor.x                      + 1.596 * texColor.z, 
-        1.164 * texColor.x - 0.392 * texColor.y - 0.813 * texColor.z, 
-        1.164 * texColor.x + 2.017 * texColor.y,
-        255.0
-    ) / 255;
+    // FragColor = vec4(texture(yTexture, TexCoord).xxx, 1.0);
+
+    // Convert YUV to RGB (the chroma samplers upsample the chroma planes)
+    vec3 yuv = vec3(texture(yTexture, TexCoord).r, texture(uTexture, TexCoord).r, texture(vTexture, TexCoord).r);
+    FragColor = vec4(clamp(yuvToRgb(yuv), 0.0, 1.0), 1.0);
 }
@@ -17,6 +17,7 @@
 #include <sys/types.h>      // Syscall datatypes
 #include <sys/socket.h>     // Sockets support
 #include <netinet/in.h>     // Internet domain address support (sockaddr_in)
+#include <netinet/tcp.h>    // TCP_INFO
 
 /* Standard C++ Libraries */
 #include <system_error>
@@ -138,6 +139,17 @@ bool Connection::recieve(char* buffer, int bytes) const {
     return true;
 };
 
+double Connection::rtt() const {
+    struct tcp_info info;
+    socklen_t info_length = sizeof(info);
+
+    if (!valid() || getsockopt(connection_fd_, IPPROTO_TCP, TCP_INFO, &info, &info_length) < 0) {
+        return -1.0;
+    }
+
+    return info.tcpi_rtt * 1e-6;  // us to s
+};
+
 /* ----------------------------------- Transmission ----------------------------------- */
 bool Connection::send(char* buffer, int bytes) const {
     LOGI("Sending Bytes: %d bytes, buffer @ %p ", bytes, buffer);
@@ -44,6 +44,12 @@ class Connection {
      */
     bool wait(int timeout_ms);
 
+    /**
+     * @brief The kernel's smoothed round trip time estimate of this (TCP) connection.
+     * @return The RTT in seconds, or a negative value if not available.
+     */
+    double rtt() const;
+
     bool valid() const { return connection_fd_ >= 0; };
 
    private:
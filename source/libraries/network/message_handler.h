@@ -36,7 +36,7 @@ class MessageHandler {
     MessageHandler& operator=(const MessageHandler& other)   = default;
 
    public:
-    // TODO: Add new messages here.
+    virtual void on(Message<MessageID::CLOCK_SYNC> *msg) {};
 };
 } // namespace client
 
@@ -60,5 +60,7 @@ class MessageHandler {
     
    public:
     virtual void on(Message<MessageID::CMD_DRIVE> *msg) {};
+    virtual void on(Message<MessageID::VIDEO_FEEDBACK> *msg) {};
+    virtual void on(Message<MessageID::CLOCK_SYNC> *msg) {};
 };
 } // namespace server
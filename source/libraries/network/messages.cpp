@@ -25,7 +25,9 @@ namespace message {
  */
 MessageBase::des_mapping_t MessageBase::deserializers_ { 
 
-MAP_MESSAGE(MessageID::CMD_DRIVE)
+MAP_MESSAGE(MessageID::CMD_DRIVE),
+MAP_MESSAGE(MessageID::VIDEO_FEEDBACK),
+MAP_MESSAGE(MessageID::CLOCK_SYNC)
 
 };
 
@@ -12,6 +12,8 @@
 // None
 
 /* Custom C++ Libraries */
+#include "common/video_feedback.h"
+#include "common/clock_sync.h"
 #include "common/input.h"
 #include "message.h"
 
@@ -45,7 +47,9 @@ template<> class Message<msg_id>: public MessageBase {       \
 enum class MessageID {
     EMPTY = 0,               // Empty Message
     
-ADD_MESSAGE(CMD_DRIVE)   // Command the robot to update it's Drive Control State.
+ADD_MESSAGE(CMD_DRIVE),      // Command the robot to update it's Drive Control State.
+ADD_MESSAGE(VIDEO_FEEDBACK), // Report the reception quality of a video stream to the robot.
+ADD_MESSAGE(CLOCK_SYNC)      // Clock offset estimation request (remote to robot) & reply (robot to remote).
 
 };
 
@@ -56,6 +60,8 @@ ADD_MESSAGE(CMD_DRIVE)   // Command the robot to update it's Drive Control State
  * for every message type, for the associated payload type.
  */
 CREATE_MESSAGE(MessageID::CMD_DRIVE, Input);
+CREATE_MESSAGE(MessageID::VIDEO_FEEDBACK, VideoFeedback);
+CREATE_MESSAGE(MessageID::CLOCK_SYNC, ClockSync);
 
 
 /**
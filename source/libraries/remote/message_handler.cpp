@@ -20,7 +20,30 @@
 
 
 namespace remote {
+/* ========================== Defines ========================== */
+#define CLOCK_SYNC_INTERVAL_US 1000000  // Time between clock offset measurements.
+
+
 /* ========================== Classes ========================== */
-// Nothing yet to implement
+/**
+ * @brief Periodically ask the robot for its time, to estimate the clock offset.
+ */
+void MessageHandler::requestClockSync() {
+    int64_t curr_time = common::micros();
+    if (!message_transmitter_ || !clock_offset_ || curr_time - last_clock_sync_us_ < CLOCK_SYNC_INTERVAL_US) {
+        return;
+    }
+
+    ClockSync sync = {};
+    sync.t0 = curr_time;
+    message_transmitter_->pushSendQueue(std::make_unique<Message<MessageID::CLOCK_SYNC>>(sync));
+    last_clock_sync_us_ = curr_time;
+};
+
+void MessageHandler::on(Message<MessageID::CLOCK_SYNC> *msg) {
+    if (clock_offset_) {
+        clock_offset_->update(msg->value(), common::micros());
+    }
+};
 
 } // namespace remote
\ No newline at end of file
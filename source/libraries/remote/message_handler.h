@@ -11,11 +11,13 @@
 // None
 
 /* Standard C++ Libraries */
-// None
+#include <memory>
 
 /* Custom C++ Libraries */
+#include "common/clock_sync.h"
 #include "common/looper.h"
 #include "common/utils.h"  // gettid()
+#include "common/clock.h"
 #include "network/message_handler.h"
 #include "network/message_transciever.h"
 
@@ -24,18 +26,22 @@ namespace remote {
 using namespace message;
 /* =========================== Macros ========================== */
 #define PIPE_MESSAGE(msg_id) \
-case msg_id: \
+case msg_id: { \
     Message<msg_id> *message = dynamic_cast<Message<msg_id>*>(message_base); \
     on(message);    \
-    break           
+    break;          \
+}
 
 
 /* ========================== Classes ========================== */
 class MessageHandler final: public client::MessageHandler, public Looper {
    public:
-    MessageHandler(Reciever *recv): message_reciever_(recv) {};
+    MessageHandler(Reciever *recv, Transmitter *trans=nullptr, ClockOffset *clock_offset=nullptr): 
+        message_reciever_(recv), message_transmitter_(trans), clock_offset_(clock_offset) {};
 
     void iteration() override {
+        requestClockSync();
+
         /* If running in seperate thread, block this thread block until message vailable. */
         if (threaded()) {
             bool message_available = message_reciever_->waitForMessage(1000);
@@ -66,7 +72,7 @@ class MessageHandler final: public client::MessageHandler, public Looper {
 
         /* Pipe given message to correct handler. */
         switch (id) {
-            // Not yet any messages
+            PIPE_MESSAGE(MessageID::CLOCK_SYNC);
 
             default:
                 LOGW("Recieved message, with ID %d, has not handler.", static_cast<int>(id));
@@ -75,10 +81,16 @@ class MessageHandler final: public client::MessageHandler, public Looper {
     };
 
     /* --------------------- Specifc Message Handlers --------------------- */
-    // None yet
+    void on(Message<MessageID::CLOCK_SYNC> *msg) override;
+
+   private:
+    void requestClockSync();
 
    private:
     Reciever *message_reciever_;
+    Transmitter *message_transmitter_ = nullptr;
+    ClockOffset *clock_offset_ = nullptr;
+    int64_t last_clock_sync_us_ = 0;
 };
 
 } // namespace remote
\ No newline at end of file
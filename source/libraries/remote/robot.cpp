@@ -22,7 +22,7 @@ namespace remote {
 /* ========================== Classes ========================== */
 void Robot::connect() {
     client::Client::connect();
-    message_handler_ = std::make_unique<MessageHandler>(message_reciever_.get());
+    message_handler_ = std::make_unique<MessageHandler>(message_reciever_.get(), message_transmitter_.get(), &clock_offset_);
 };
 
 void Robot::iteration() {
@@ -48,6 +48,12 @@ void Robot::sink(Input input) {
     message_transmitter_->pushSendQueue(std::move(msg));
 };
 
+void Robot::sink(VideoFeedback feedback) {
+    /* Forward over channel. */
+    std::unique_ptr<message::MessageBase> msg = std::make_unique<message::Message<message::MessageID::VIDEO_FEEDBACK>>(feedback);
+    message_transmitter_->pushSendQueue(std::move(msg));
+};
+
 Frame Robot::getFrame(double curr_time, PixelFormat fmt) {
     return {};
 };
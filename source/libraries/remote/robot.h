@@ -16,6 +16,8 @@
 
 /* Custom C++ Libraries */
 #include "common/looper.h"
+#include "common/video_feedback.h"
+#include "common/clock_sync.h"
 #include "common/input_sink.h"
 #include "video/frame_provider.h"
 #include "network/client.h"
@@ -28,7 +30,7 @@ namespace remote {
 /**
  * @brief This is the interface to the robot for a remote controller.
  */
-class Robot final: public client::Client, public InputSink, public FrameProvider {
+class Robot final: public client::Client, public InputSink, public VideoFeedbackSink, public FrameProvider {
    public:
     Robot(std::string server_address, int port): client::Client(server_address, port){};
     void connect() override;
@@ -41,13 +43,22 @@ class Robot final: public client::Client, public InputSink, public FrameProvider
     /* Input Sink. */
     void sink(Input input) override;
 
+    /* Video Feedback Sink. */
+    void sink(VideoFeedback feedback) override;
+
     /* Frame Provider. */
     Frame getFrame(double curr_time, PixelFormat fmt);
     void startStream();
     void stopStream();
 
+    /**
+     * @brief Estimated offset of the robot's clock (valid once connected for a while).
+     */
+    ClockOffset* clockOffset() { return &clock_offset_; };
+
    private:
     std::unique_ptr<MessageHandler> message_handler_;
+    ClockOffset clock_offset_;
 };
 
 
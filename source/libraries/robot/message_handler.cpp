@@ -17,6 +17,7 @@
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
+#include "common/clock.h"
 
 
 namespace robot {
@@ -32,4 +33,20 @@ void MessageHandler::on(Message<MessageID::CMD_DRIVE> *msg) {
     }
 };
 
+void MessageHandler::on(Message<MessageID::VIDEO_FEEDBACK> *msg) {
+    if (video_feedback_sink_) {
+        video_feedback_sink_->sink(msg->value());
+    }
+};
+
+void MessageHandler::on(Message<MessageID::CLOCK_SYNC> *msg) {
+    /* Answer with our clock, as fast as possible. */
+    ClockSync sync = msg->value();
+    sync.t1 = common::micros();
+    if (message_transmitter_) {
+        sync.t2 = common::micros();
+        message_transmitter_->pushSendQueue(std::make_unique<Message<MessageID::CLOCK_SYNC>>(sync));
+    }
+};
+
 } // namespace remote
\ No newline at end of file
@@ -14,6 +14,7 @@
 // None
 
 /* Custom C++ Libraries */
+#include "common/video_feedback.h"
 #include "common/input_sink.h"
 #include "common/utils.h"  // gettid()
 #include "network/message_handler.h"
@@ -34,7 +35,8 @@ case msg_id: { \
 /* ========================== Classes ========================== */
 class MessageHandler: public server::MessageHandler, public Looper {
    public:
-    MessageHandler(Reciever *recv, InputSink *input_sink=nullptr): message_reciever_(recv), input_sink_(input_sink) {};
+    MessageHandler(Reciever *recv, Transmitter *trans=nullptr, InputSink *input_sink=nullptr, VideoFeedbackSink *video_feedback_sink=nullptr): 
+        message_reciever_(recv), message_transmitter_(trans), input_sink_(input_sink), video_feedback_sink_(video_feedback_sink) {};
 
     void iteration() {
         /* If running in seperate thread, block this thread block until message vailable. */
@@ -68,6 +70,8 @@ class MessageHandler: public server::MessageHandler, public Looper {
         /* Pipe given message to correct handler. */
         switch (id) {
             PIPE_MESSAGE(MessageID::CMD_DRIVE);
+            PIPE_MESSAGE(MessageID::VIDEO_FEEDBACK);
+            PIPE_MESSAGE(MessageID::CLOCK_SYNC);
             
             default:
                 LOGW("Recieved message, with ID %d, has not handler.", static_cast<int>(id));
@@ -77,10 +81,14 @@ class MessageHandler: public server::MessageHandler, public Looper {
 
     /* --------------------- Specifc Message Handlers --------------------- */
     void on(Message<MessageID::CMD_DRIVE> *msg) override;
+    void on(Message<MessageID::VIDEO_FEEDBACK> *msg) override;
+    void on(Message<MessageID::CLOCK_SYNC> *msg) override;
 
    private:
     Reciever *message_reciever_;
+    Transmitter *message_transmitter_ = nullptr;
     InputSink *input_sink_ = nullptr;
+    VideoFeedbackSink *video_feedback_sink_ = nullptr;
 };
 
 } // namespace remote
@@ -23,7 +23,14 @@ namespace robot {
 /* ========================== Classes ========================== */
 void Remote::connect() {
     server::Server::connect();
-    message_handler_ = std::make_unique<MessageHandler>(message_reciever_.get(), input_sink_);
+    message_handler_ = std::make_unique<MessageHandler>(message_reciever_.get(), message_transmitter_.get(), input_sink_, this);
+};
+
+void Remote::sink(VideoFeedback feedback) {
+    feedback.rtt = static_cast<float>(connection_.rtt());
+    if (video_feedback_sink_) {
+        video_feedback_sink_->sink(feedback);
+    }
 };
 
 void Remote::iteration() {
@@ -16,6 +16,7 @@
 
 /* Custom C++ Libraries */
 #include "common/looper.h"
+#include "common/video_feedback.h"
 #include "common/input_sink.h"
 #include "network/server.h"
 #include "message_handler.h"
@@ -23,10 +24,14 @@
 
 namespace robot {
 /* ========================== Classes ========================== */
-class Remote final: public server::Server {
+class Remote final: public server::Server, public VideoFeedbackSink {
    public:
-    Remote(int port, InputSink *input_sink=nullptr): server::Server(port), input_sink_(input_sink){};
+    Remote(int port, InputSink *input_sink=nullptr, VideoFeedbackSink *video_feedback_sink=nullptr): 
+        server::Server(port), input_sink_(input_sink), video_feedback_sink_(video_feedback_sink){};
     void connect() override;
+
+    /* Video Feedback Sink (adds the control link RTT to the remote's feedback). */
+    void sink(VideoFeedback feedback) override;
     
     /* Looper Interface. */
     void iteration() override;
@@ -37,6 +42,7 @@ class Remote final: public server::Server {
    private:
     std::unique_ptr<MessageHandler> message_handler_;
     InputSink* input_sink_;
+    VideoFeedbackSink* video_feedback_sink_;
 };
 
 } // namespace robot
@@ -0,0 +1,98 @@
+/**
+ * @file aligned_allocator.h
+ * @author Kevin Orbie
+ *
+ * @brief STL allocator that hands out cache-line aligned (and optionally hugepage backed) memory.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdlib.h>     // aligned_alloc(), free()
+#include <stddef.h>     // size_t
+#include <sys/mman.h>   // madvise()
+
+/* Standard C++ Libraries */
+#include <new>          // std::bad_alloc
+#include <utility>      // std::forward
+
+
+/* ========================== Defines ========================== */
+// NOTE: Hugepages are only requested when built with IMAGE_HUGEPAGES (cmake -DIMAGE_HUGEPAGES=ON).
+
+/* Alignment (in bytes) of every image plane start and row stride (one cache line, a full AVX-512 register). */
+constexpr size_t IMAGE_ALIGNMENT = 64;
+
+/* Buffers of at least this size are aligned to, and advised as, transparent hugepages. */
+constexpr size_t HUGEPAGE_THRESHOLD = 1 << 20;  // 1 MiB
+constexpr size_t HUGEPAGE_SIZE      = 2 << 20;  // 2 MiB
+constexpr size_t HUGEPAGE_MAX_WASTE = 8;        // Unless rounding up wastes more than 1/8th of the buffer.
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Allocates IMAGE_ALIGNMENT aligned memory, and leaves default constructed elements uninitialized.
+ *
+ * @note With IMAGE_HUGEPAGES, large allocations are hugepage aligned and marked with MADV_HUGEPAGE, which reduces
+ * TLB misses when walking over full frames (only has an effect if transparent hugepages are set to 'madvise' or
+ * 'always'). Buffers that would be padded by more than 1/HUGEPAGE_MAX_WASTE keep the default alignment.
+ */
+template<typename T>
+class AlignedAllocator {
+   public:
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template<typename U> AlignedAllocator(const AlignedAllocator<U>&) {};
+
+    T* allocate(size_t count) {
+        size_t bytes = count * sizeof(T);
+        size_t alignment = IMAGE_ALIGNMENT;
+
+        #ifdef IMAGE_HUGEPAGES
+        size_t huge_bytes = (bytes + HUGEPAGE_SIZE - 1) / HUGEPAGE_SIZE * HUGEPAGE_SIZE;
+        if (bytes >= HUGEPAGE_THRESHOLD && (huge_bytes - bytes) * HUGEPAGE_MAX_WASTE <= bytes) {
+            alignment = HUGEPAGE_SIZE;
+        }
+        #endif
+
+        /* NOTE: aligned_alloc() requires the size to be a multiple of the alignment. */
+        size_t padded_bytes = (bytes + alignment - 1) / alignment * alignment;
+        void *ptr = aligned_alloc(alignment, padded_bytes);
+        if (!ptr) {
+            throw std::bad_alloc();
+        }
+
+        #ifdef IMAGE_HUGEPAGES
+        if (alignment == HUGEPAGE_SIZE) {
+            madvise(ptr, padded_bytes, MADV_HUGEPAGE);  // Only a hint, failure is not an issue.
+        }
+        #endif
+
+        return static_cast<T*>(ptr);
+    };
+
+    void deallocate(T* ptr, size_t /* count */) {
+        free(ptr);
+    };
+
+    /**
+     * @brief Default-initialize instead of value-initialize, so resizing does not zero the buffer.
+     */
+    template<typename U>
+    void construct(U* ptr) {
+        ::new(static_cast<void*>(ptr)) U;
+    };
+
+    template<typename U, typename... Args>
+    void construct(U* ptr, Args&&... args) {
+        ::new(static_cast<void*>(ptr)) U(std::forward<Args>(args)...);
+    };
+};
+
+template<typename T, typename U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return true; };
+
+template<typename T, typename U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) { return false; };
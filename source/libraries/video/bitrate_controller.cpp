@@ -0,0 +1,100 @@
+/**
+ * @file bitrate_controller.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Defines a closed-loop adaptive bitrate (& resolution) controller for the video encoder.
+ */
+
+/* ============================ Includes ============================ */
+#include "bitrate_controller.h"
+
+/* Standard C Libraries */
+// None
+
+/* Standard C++ Libraries */
+#include <algorithm>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+
+
+/* ============================ Defines ============================= */
+#define LOSS_THRESHOLD      0.02f  // Max. fraction of lost frames, before backing off.
+#define RTT_MARGIN          0.02f  // Allowed RTT increase (seconds) on top of twice the base RTT, before backing off.
+#define DECREASE_FACTOR     0.7    // Multiplicative bitrate decrease on congestion.
+#define INCREASE_STEP       0.1    // Additive bitrate increase, as fraction of the max. bitrate.
+#define STABLE_REPORTS      3      // Consecutive good reports needed before increasing the bitrate.
+#define STEP_DOWN_FRACTION  0.6    // Step down a resolution when below this fraction of its pro-rata bitrate.
+#define STEP_UP_FRACTION    0.8    // Step up a resolution when above this fraction of its pro-rata bitrate.
+
+/* Resolution ladder, as scale of the max. resolution (the 2x / 4x box downscale pyramid). */
+static constexpr float LADDER[] = {1.0f, 0.5f, 0.25f};
+static constexpr int LADDER_SIZE = sizeof(LADDER) / sizeof(LADDER[0]);
+
+
+/* ============================ Classes ============================ */
+BitrateController::BitrateController(EncoderConfig const& max_config, int64_t min_bitrate): 
+    max_config_(max_config), config_(max_config), min_bitrate_(std::min(min_bitrate, max_config.bitrate)) {
+}
+
+float BitrateController::pixelRatio(int level) const {
+    return LADDER[level] * LADDER[level];
+}
+
+void BitrateController::setLevel(int level) {
+    level_ = level;
+    config_.width  = static_cast<int>(max_config_.width  * LADDER[level]) & ~1;  // Even, for chroma subsampling.
+    config_.height = static_cast<int>(max_config_.height * LADDER[level]) & ~1;
+}
+
+bool BitrateController::update(VideoFeedback const& feedback) {
+    if (feedback.frames == 0) {
+        return false;  // Nothing recieved, nothing to judge.
+    }
+
+    EncoderConfig previous = config_;
+
+    /* Classify the report. */
+    if (feedback.rtt > 0.0f) {
+        min_rtt_ = (min_rtt_ < 0.0f) ? feedback.rtt : std::min(min_rtt_, feedback.rtt);
+    }
+    bool lossy        = feedback.loss > LOSS_THRESHOLD;
+    bool queueing     = feedback.rtt > 0.0f && feedback.rtt > 2.0f * min_rtt_ + RTT_MARGIN;
+    bool decoder_slow = feedback.decode_lag > 1.0f / config_.fps;
+
+    if (lossy || queueing) {
+        /* Network congestion: back off quickly. */
+        stable_reports_ = 0;
+        config_.bitrate = std::max(min_bitrate_, static_cast<int64_t>(config_.bitrate * DECREASE_FACTOR));
+
+    } else if (decoder_slow) {
+        /* Reciever can't keep up: less pixels to decode. */
+        stable_reports_ = 0;
+        if (level_ + 1 < LADDER_SIZE) {
+            setLevel(level_ + 1);
+        }
+
+    } else if (++stable_reports_ >= STABLE_REPORTS) {
+        /* Stable: probe for more bandwidth. */
+        stable_reports_ = 0;
+        config_.bitrate = std::min(max_config_.bitrate, config_.bitrate + static_cast<int64_t>(max_config_.bitrate * INCREASE_STEP));
+
+        /* Only go up in resolution when stable, as every resolution change costs a keyframe. */
+        if (level_ > 0 && config_.bitrate >= max_config_.bitrate * pixelRatio(level_ - 1) * STEP_UP_FRACTION) {
+            setLevel(level_ - 1);
+        }
+    }
+
+    /* Don't spread a too low bitrate over too many pixels. */
+    if (level_ + 1 < LADDER_SIZE && config_.bitrate < max_config_.bitrate * pixelRatio(level_) * STEP_DOWN_FRACTION) {
+        setLevel(level_ + 1);
+    }
+
+    if (config_ == previous) {
+        return false;
+    }
+
+    LOGI("Adaptive bitrate (loss %.1f%%, decode lag %.1fms, rtt %.1fms): %dx%d @ %ld kbps", 
+         feedback.loss * 100.0f, feedback.decode_lag * 1e3f, feedback.rtt * 1e3f, config_.width, config_.height, config_.bitrate / 1000);
+    return true;
+}
@@ -0,0 +1,62 @@
+/**
+ * @file bitrate_controller.h
+ * @author Kevin Orbie
+ * 
+ * @brief Declares a closed-loop adaptive bitrate (& resolution) controller for the video encoder.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+#include "common/video_feedback.h"
+#include "video_encoder.h"
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Adapts the encoder bitrate and resolution to the reception quality reported by the reciever.
+ *
+ * @details Additive increase / multiplicative decrease on the bitrate: packet loss or a growing control link RTT 
+ * (queues filling up) cut the bitrate, while a few stable reports in a row raise it again, up to the configured maximum.
+ * When the bitrate gets too low for the current resolution, the resolution is stepped down (and back up once the 
+ * bitrate recovers). A decoder that can not keep up also lowers the resolution, as a lower bitrate would not help it.
+ */
+class BitrateController final {
+   public:
+    /**
+     * @param max_config: The best configuration to strive for (and the base for all others).
+     * @param min_bitrate: Never go below this bitrate (bits / second).
+     */
+    BitrateController(EncoderConfig const& max_config, int64_t min_bitrate=250000);
+
+    /**
+     * @brief Process one feedback report.
+     * @return True if the target configuration changed.
+     */
+    bool update(VideoFeedback const& feedback);
+
+    /**
+     * @brief Current target configuration.
+     */
+    EncoderConfig const& config() const { return config_; };
+
+   private:
+    void setLevel(int level);
+    float pixelRatio(int level) const;
+
+   private:
+    EncoderConfig max_config_;
+    EncoderConfig config_;
+    int64_t min_bitrate_;
+
+    int level_ = 0;           // Index in the resolution ladder (0 = full resolution).
+    int stable_reports_ = 0;  // Consecutive reports without any issues.
+    float min_rtt_ = -1.0f;   // Lowest RTT seen (seconds), i.e. the RTT with empty queues.
+};
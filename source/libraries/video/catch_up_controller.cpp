@@ -0,0 +1,82 @@
+/**
+ * @file catch_up_controller.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Defines the controller that decides which packets a live video reciever skips to catch up after a stall.
+ */
+
+/* ============================ Includes ============================ */
+#include "catch_up_controller.h"
+
+/* Standard C Libraries */
+// None
+
+/* Standard C++ Libraries */
+#include <algorithm>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+
+
+/* ============================ Classes ============================ */
+/**
+ * @brief Update the live reference & the lag with the timestamp of the given packet.
+ */
+void CatchUpController::track(int64_t dts_us, int64_t dequeue_us) {
+    int64_t offset = dequeue_us - dts_us;
+    if (dequeue_us - window_start_us_ > static_cast<int64_t>(LIVE_WINDOW * 1e6)) {
+        live_offset_us_[1] = live_offset_us_[0];
+        live_offset_us_[0] = offset;
+        window_start_us_   = dequeue_us;
+    }
+    live_offset_us_[0] = std::min(live_offset_us_[0], offset);
+    last_offset_us_ = offset;
+
+    int64_t lag_us = offset - std::min(live_offset_us_[0], live_offset_us_[1]);
+    if (lag_us > static_cast<int64_t>(LIVE_RESYNC * 1e6)) {
+        LOGW("VideoReciever (port %d) timestamps jumped by %.1f s, resyncing.", port_, lag_us * 1e-6);
+        live_offset_us_[0] = live_offset_us_[1] = offset;
+        lag_us = 0;
+    }
+    lag_ms_ = lag_us * 1e-3;
+}
+
+bool CatchUpController::skip(Packet const& packet, bool backlog, int64_t dequeue_us) {
+    /* How far behind live is this packet? */
+    if (packet.has_dts) {
+        track(packet.dts_us, dequeue_us);
+    }
+    double lag = lag_ms_ * 1e-3;
+
+    if (!active_) {
+        if (lag <= CATCHUP_ENTER_LAG && !backlog) {
+            return false;
+        }
+        LOGW("VideoReciever (port %d) is %.0f ms behind live, catching up.", port_, lag * 1e3);
+        active_   = true;
+        skipping_ = true;
+        skip_start_us_ = dequeue_us;
+        catch_ups_++;
+    }
+
+    if (packet.random_access) {
+        /* Decoding can restart here, keep skipping after it while still far behind. */
+        skipping_ = (lag > CATCHUP_ENTER_LAG);
+        skip_start_us_ = dequeue_us;
+        return false;
+    }
+    if (skipping_ && (dequeue_us - skip_start_us_) > static_cast<int64_t>(CATCHUP_MAX_SKIP * 1e6)) {
+        /* The stream has no (frequent) random access points: accept the current lag as live. */
+        LOGW("VideoReciever (port %d) found no random access point in %.1f s, decoding in order.", port_, CATCHUP_MAX_SKIP);
+        live_offset_us_[0] = live_offset_us_[1] = last_offset_us_;
+        skipping_ = false;
+        lag_ms_ = 0.0;
+        lag = 0.0;
+    }
+    if (!skipping_ && lag <= CATCHUP_EXIT_LAG && !backlog) {
+        LOGI("VideoReciever (port %d) caught up with live.", port_);
+        active_ = false;
+        return false;
+    }
+    return skipping_ || packet.disposable;
+}
@@ -0,0 +1,91 @@
+/**
+ * @file catch_up_controller.h
+ * @author Kevin Orbie
+ *
+ * @brief Declares the controller that decides which packets a live video reciever skips to catch up after a stall.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Defines ========================== */
+#define CATCHUP_ENTER_LAG 0.2  // Seconds behind live, at which catching up starts.
+#define CATCHUP_EXIT_LAG  0.05 // Seconds behind live, at which catching up stops.
+#define CATCHUP_MAX_SKIP  3.0  // Max. seconds of skipping, while waiting for a random access point.
+#define LIVE_WINDOW       10.0 // Seconds over which the live reference (min. dequeue time - dts) is tracked.
+#define LIVE_RESYNC       30.0 // Seconds behind live, taken as a timestamp discontinuity instead.
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Tracks how far behind live the decoded packets are, and decides whether to skip them to catch up.
+ *
+ * @details Live is the smallest (dequeue time - dts) seen over the last LIVE_WINDOW seconds, so clock drift is
+ * followed. Falling more than CATCHUP_ENTER_LAG behind, or a full packet queue (the socket backs up), starts
+ * catching up: packets are skipped up to the next random access point, where decoding resumes if that got us close
+ * enough to live. Non-reference frames are dropped until back within CATCHUP_EXIT_LAG.
+ */
+class CatchUpController final {
+   public:
+    struct Packet {
+        bool    has_dts       = false;
+        int64_t dts_us        = 0;      // Decode timestamp, in microseconds.
+        bool    random_access = false;  // Decoding can (re)start at this packet.
+        bool    disposable    = false;  // No other frame references this one.
+    };
+
+   public:
+    /**
+     * @param port: Only used to tell recievers apart in the logs.
+     */
+    CatchUpController(int port=0): port_(port) {};
+
+    /**
+     * @brief Process the next packet (in decode order).
+     * @param backlog: Whether the packet queue in front of the decoder is full.
+     * @param dequeue_us: When the packet was taken from that queue (common::micros()).
+     * @return True if the packet should be dropped without decoding.
+     */
+    bool skip(Packet const& packet, bool backlog, int64_t dequeue_us);
+
+    /**
+     * @brief Whether packets are being skipped to catch up.
+     */
+    bool active() const { return active_; };
+
+    /**
+     * @brief How far behind live the last packet was (milliseconds).
+     */
+    double lagMs() const { return lag_ms_; };
+
+    /**
+     * @brief Number of times the reciever fell behind, and started catching up.
+     */
+    uint64_t catchUps() const { return catch_ups_; };
+
+   private:
+    void track(int64_t dts_us, int64_t dequeue_us);
+
+   private:
+    int port_;
+
+    bool    active_   = false;
+    bool    skipping_ = false;  // Skipping up to the next random access point.
+    int64_t skip_start_us_ = 0;
+    int64_t live_offset_us_[2] = {INT64_MAX, INT64_MAX};  // Min. (dequeue time - dts), this & the previous window.
+    int64_t last_offset_us_  = 0;
+    int64_t window_start_us_ = 0;
+
+    double   lag_ms_    = 0.0;
+    uint64_t catch_ups_ = 0;
+};
@@ -0,0 +1,179 @@
+/**
+ * @file frame_hub.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Implements a frame provider that fans the frames of one source out to multiple consumers.
+ */
+
+/* ============================ Includes ============================ */
+#include "frame_hub.h"
+
+/* Standard C Libraries */
+// None
+
+/* Standard C++ Libraries */
+#include <stdexcept>
+#include <algorithm>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+
+
+/* ============================ Subscription ============================ */
+std::shared_ptr<const Frame> FrameHub::Subscription::next(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    bool available = frame_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{ return !frames_.empty(); });
+    if (!available) {
+        return nullptr;
+    }
+
+    std::shared_ptr<const Frame> frame = std::move(frames_.front());
+    frames_.pop_front();
+    return frame;
+}
+
+std::shared_ptr<const Frame> FrameHub::Subscription::getSharedFrame(double /* curr_time */, PixelFormat requested_format) {
+    std::shared_ptr<const Frame> shared = next(0);
+    if (!shared) {
+        return nullptr;  // Nothing new.
+    }
+
+    PixelFormat format = shared->image.getFormat();
+    if (format == PixelFormat::EMPTY || requested_format == PixelFormat::EMPTY || requested_format == format) {
+        return shared;
+    }
+
+    /* Another format: a converted copy, for this consumer only. */
+    std::shared_ptr<Frame> converted = std::make_shared<Frame>();
+    ImageView view = shared->image.view();
+    converted->image     = Image(view, requested_format);
+    converted->timestamp = shared->timestamp;
+    converted->sequence  = shared->sequence;
+    converted->source_id = shared->source_id;
+    return converted;
+}
+
+Frame FrameHub::Subscription::getFrame(double curr_time, PixelFormat requested_format) {
+    std::shared_ptr<const Frame> frame = getSharedFrame(curr_time, requested_format);
+    return (frame) ? *frame : Frame();
+}
+
+bool FrameHub::Subscription::waitForFrame(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return frame_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{ return !frames_.empty(); });
+}
+
+void FrameHub::Subscription::deliver(std::shared_ptr<const Frame> const& frame) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (frames_.size() >= capacity_) {
+            dropped_++;
+            if (policy_ == DropPolicy::DROP_NEWEST) {
+                return;
+            }
+            frames_.pop_front();
+        }
+        frames_.push_back(frame);
+    }
+    frame_cv_.notify_one();
+}
+
+
+/* ============================== Hub =============================== */
+FrameHub::FrameHub(FrameProvider *source, PixelFormat format): source_(source), format_(format) {
+    newest_ = subscribe(1, DropPolicy::DROP_OLDEST);
+}
+
+FrameHub::~FrameHub() {
+    stopStream();
+}
+
+std::shared_ptr<FrameHub::Subscription> FrameHub::subscribe(size_t capacity, DropPolicy policy) {
+    std::shared_ptr<Subscription> subscription = std::make_shared<Subscription>(capacity, policy);
+
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    subscriptions_.push_back(subscription);
+    return subscription;
+}
+
+void FrameHub::publish(Frame frame) {
+    /* Stored once, shared by every subscription. */
+    std::shared_ptr<const Frame> shared = std::make_shared<const Frame>(std::move(frame));
+
+    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+    subscriptions_.erase(std::remove_if(subscriptions_.begin(), subscriptions_.end(), [&shared](std::weak_ptr<Subscription> const& weak){
+        std::shared_ptr<Subscription> subscription = weak.lock();
+        if (!subscription) {
+            return true;  // Released by its consumer.
+        }
+        subscription->deliver(shared);
+        return false;
+    }), subscriptions_.end());
+}
+
+Frame FrameHub::getFrame(double curr_time, PixelFormat requested_format) {
+    return newest_->getFrame(curr_time, requested_format);
+}
+
+std::shared_ptr<const Frame> FrameHub::getSharedFrame(double curr_time, PixelFormat requested_format) {
+    return newest_->getSharedFrame(curr_time, requested_format);
+}
+
+bool FrameHub::waitForFrame(int timeout_ms) {
+    return newest_->waitForFrame(timeout_ms);
+}
+
+void FrameHub::startStream() {
+    if (capturing_) {
+        return;
+    }
+
+    start_time_ = std::chrono::steady_clock::now();
+    capturing_ = true;
+    capture_thread_ = std::thread([this](){
+        while (capturing_) {
+            capture();
+        }
+    });
+}
+
+void FrameHub::stopStream() {
+    capturing_ = false;
+    if (capture_thread_.joinable()) {
+        capture_thread_.join();
+    }
+}
+
+/**
+ * @brief Wait for the next frame of the source, and publish it (Blocking, paced by the source).
+ */
+void FrameHub::capture() {
+    if (!source_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        return;
+    }
+
+    Frame frame;
+    try {
+        if (!source_->waitForFrame(FRAME_HUB_WAIT_MS)) {
+            return;  // Nothing new (yet).
+        }
+        double curr_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+        frame = source_->getFrame(curr_time, format_);
+    } catch (const std::runtime_error& error) {
+        /* E.g. the camera was disconnected, which the consumers notice by the lack of new frames. */
+        LOGE("Frame hub source failed (%s), stopped capturing.", error.what());
+        capturing_ = false;
+        return;
+    }
+
+    /* Sources that can't wait return the same (or an empty) frame, until a new one is available. */
+    bool empty = (frame.image.getFormat() == PixelFormat::EMPTY);
+    if (empty || (frame.sequence != 0 && frame.sequence == last_sequence_)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return;
+    }
+    last_sequence_ = frame.sequence;
+
+    publish(std::move(frame));
+}
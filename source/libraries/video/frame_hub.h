@@ -0,0 +1,162 @@
+/**
+ * @file frame_hub.h
+ * @author Kevin Orbie
+ *
+ * @brief Declares a frame provider that fans the frames of one source out to multiple consumers.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Standard C++ Libraries */
+#include <condition_variable>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <deque>
+
+/* Custom C++ Libraries */
+#include "frame_provider.h"
+
+
+/* ========================== Defines ========================== */
+#define FRAME_HUB_WAIT_MS 100  // Max time the capture thread waits on the source (bounds stopStream()).
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Captures the frames of a single source (e.g. a VideoCam, which can only be read by one caller) on its own
+ * thread, and publishes every frame once to all of its subscriptions.
+ *
+ * @details Every frame is stored once, and shared (reference counted, read-only) by all subscriptions that
+ * still hold it. Each subscription buffers frames independently, with its own capacity and drop policy, so a slow
+ * consumer (e.g. a recorder) never holds up a fast one (e.g. the transmitter), nor the capture itself.
+ *
+ * @note The hub is a FrameProvider itself as well, which returns the newest frame.
+ *
+ * @example {@code
+ *  camera.startStream();
+ *  FrameHub hub = FrameHub(&camera);
+ *  std::shared_ptr<FrameHub::Subscription> stream = hub.subscribe();  // Newest frame only.
+ *  std::shared_ptr<FrameHub::Subscription> vision = hub.subscribe(4, FrameHub::DropPolicy::DROP_NEWEST);
+ *  hub.startStream();
+ *
+ *  std::shared_ptr<const Frame> frame = vision->next(100);
+ * }
+ */
+class FrameHub final: public FrameProvider {
+   public:
+    /* What a full subscription does with a new frame. */
+    enum class DropPolicy {
+        DROP_OLDEST,  // Make room by dropping the oldest queued frame (with capacity 1: keep only the newest frame).
+        DROP_NEWEST,  // Drop the new frame (keeps a gapless run of frames, up to the capacity).
+    };
+
+    /**
+     * @brief One consumer's view of the hub.
+     * @note Also a FrameProvider, so it can replace the source for any existing consumer.
+     */
+    class Subscription final: public FrameProvider {
+       public:
+        Subscription(size_t capacity, DropPolicy policy): capacity_((capacity > 0) ? capacity : 1), policy_(policy) {};
+
+        Subscription(const Subscription& other)            = delete;
+        Subscription& operator=(const Subscription& other) = delete;
+
+        /**
+         * @brief Take the oldest buffered frame, waiting at most timeout_ms for one to arrive.
+         * @return The shared frame, or nullptr on timeout.
+         */
+        std::shared_ptr<const Frame> next(int timeout_ms);
+
+        /**
+         * @brief Take the oldest buffered frame, or nullptr if there is nothing new (Non-blocking, see waitForFrame()).
+         * @note The shared frame itself is handed out (no copy), unless another format is requested.
+         */
+        std::shared_ptr<const Frame> getSharedFrame(double curr_time, PixelFormat requested_format) override;
+
+        /**
+         * @brief Same as getSharedFrame(), but copied (an empty Frame if there is nothing new).
+         */
+        Frame getFrame(double curr_time, PixelFormat requested_format) override;
+        bool waitForFrame(int timeout_ms) override;
+
+        /* The stream is owned by the hub. */
+        void startStream() override {};
+        void stopStream() override {};
+
+        /**
+         * @brief Number of frames dropped because this subscription was full.
+         */
+        uint64_t dropped() const { return dropped_; };
+
+       private:
+        friend class FrameHub;
+        void deliver(std::shared_ptr<const Frame> const& frame);
+
+       private:
+        const size_t capacity_;
+        const DropPolicy policy_;
+
+        std::mutex mutex_;
+        std::condition_variable frame_cv_;
+        std::deque<std::shared_ptr<const Frame>> frames_;  // Guarded by mutex_.
+
+        std::atomic<uint64_t> dropped_ = {0};
+    };
+
+   public:
+    /**
+     * @param source: The provider to capture from (not owned), or nullptr to only publish() manually.
+     * @param format: Format in which frames are captured (and shared without conversion).
+     */
+    FrameHub(FrameProvider *source, PixelFormat format=PixelFormat::YUV422);
+    ~FrameHub();
+
+    FrameHub(const FrameHub& other)            = delete;
+    FrameHub& operator=(const FrameHub& other) = delete;
+
+    /**
+     * @brief Add a consumer, which recieves all frames published from now on.
+     * @note Thread-safe. The subscription is removed when the consumer releases it.
+     */
+    std::shared_ptr<Subscription> subscribe(size_t capacity=1, DropPolicy policy=DropPolicy::DROP_OLDEST);
+
+    /**
+     * @brief Hand a frame to all subscriptions (done by the capture thread, for frames of the source).
+     * @note Thread-safe.
+     */
+    void publish(Frame frame);
+
+    /* Frame Provider Interface */
+    Frame getFrame(double curr_time, PixelFormat requested_format) override;
+    std::shared_ptr<const Frame> getSharedFrame(double curr_time, PixelFormat requested_format) override;
+    bool waitForFrame(int timeout_ms) override;
+    void startStream() override;  // Starts the capture thread (the source must already be streaming).
+    void stopStream() override;
+
+   private:
+    void capture();  // Capture thread.
+
+   private:
+    FrameProvider *source_ = nullptr;
+    PixelFormat format_;
+
+    /* Subscriptions */
+    std::mutex subscriptions_mutex_;
+    std::vector<std::weak_ptr<Subscription>> subscriptions_;  // Guarded by subscriptions_mutex_.
+    std::shared_ptr<Subscription> newest_;  // Backs this hub's own getFrame().
+
+    /* Capture Thread */
+    std::thread capture_thread_;
+    std::atomic<bool> capturing_ = {false};
+    uint32_t last_sequence_ = 0;  // Only touched by the capture thread.
+    std::chrono::steady_clock::time_point start_time_;
+};
@@ -11,6 +11,8 @@
 /* Standard C++ Libraries */
 #include <vector>
 #include <string>
+#include <memory>
+#include <atomic>
 #include <stdexcept>
 
 /* Custom C++ Libraries */
@@ -21,6 +23,9 @@
 /* ========================== Classes ========================== */
 struct Frame {
     Image image;
+    int64_t  timestamp = 0;  // Capture time (common::micros() on this machine), 0 if unknown.
+    uint32_t sequence  = 0;  // Capture sequence number, 0 if unknown.
+    uint32_t source_id = 0;  // Source that captured the frame (unique per source in this process), 0 if unknown.
 };
 
 class FrameProvider {
@@ -42,4 +47,30 @@ class FrameProvider {
     virtual Frame getFrame(double curr_time, PixelFormat requested_format) = 0;
     virtual void startStream() = 0;
     virtual void stopStream() = 0;
+
+    /**
+     * @brief Block until getFrame() may return a new frame, or at most timeout_ms.
+     * @return False on timeout. Providers that can't wait return true right away (the caller then polls getFrame()).
+     */
+    virtual bool waitForFrame(int /* timeout_ms */) { return true; };
+
+    /**
+     * @brief Like getFrame(), but hands out a shared, read-only frame (or nullptr if there is no new frame).
+     * @note Providers that already share their frames (e.g. a FrameHub) override this, to hand them out without a copy.
+     */
+    virtual std::shared_ptr<const Frame> getSharedFrame(double curr_time, PixelFormat requested_format) {
+        Frame frame = getFrame(curr_time, requested_format);
+        if (frame.image.getFormat() == PixelFormat::EMPTY) {
+            return nullptr;
+        }
+        return std::make_shared<const Frame>(std::move(frame));
+    };
+
+    /**
+     * @brief A new source id (see Frame::source_id), unique in this process.
+     */
+    static uint32_t newSourceId() {
+        static std::atomic<uint32_t> source_count = {0};
+        return ++source_count;
+    };
 };
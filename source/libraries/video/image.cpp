@@ -25,9 +25,17 @@ ImageView::ImageView(std::vector<uint8_t*> data, std::vector<int> linesize, int
     switch (fmt) {
         case PixelFormat::YUV:
         case PixelFormat::YUV422:
+        case PixelFormat::GREY:
+        case PixelFormat::DEPTH16:
+        case PixelFormat::RGB24:
+        case PixelFormat::RGBA:
             expected_num_planes = 1;
             break;
 
+        case PixelFormat::NV12:
+            expected_num_planes = 2;
+            break;
+
         case PixelFormat::YUV420P:
         case PixelFormat::YUV422P:
             expected_num_planes = 3;
@@ -45,7 +53,7 @@ ImageView::ImageView(std::vector<uint8_t*> data, std::vector<int> linesize, int
     }
 };
 
-void ImageView::copyFrom(ImageView& view) {
+void ImageView::copyFrom(ImageView& view, ColorSpace color_space) {
     /* Verify parameters, based on given view. */
     if (height_ != view.height_ || width_ != view.width_) {
         LOGE("Invalid Argument: The given view's dimensions (%d, %d) do not match this image's dimensions (%d, %d).", view.width_, view.height_, width_, height_);
@@ -53,61 +61,101 @@ void ImageView::copyFrom(ImageView& view) {
     }
 
     /* Convert the given view. */
-    switch (view.format_) {
-        case PixelFormat::YUV422 : convertYUV422 (view, *this); break;
-        case PixelFormat::YUV422P: convertYUV422P(view, *this); break;
-        case PixelFormat::YUV420P: convertYUV420P(view, *this); break;
+    convert(view, *this, color_space);
+};
+
+ImageView ImageView::subView(int x, int y, int width, int height) {
+    /* Verify the region lies within this view. */
+    if (x < 0 || y < 0 || width < 0 || height < 0 || x + width > width_ || y + height > height_) {
+        LOGE("Invalid Argument: The region (%d, %d, %d, %d) exceeds this view's dimensions (%d, %d).", x, y, width, height, width_, height_);
+        throw std::invalid_argument("The given region exceeds this view's dimensions.");
+    }
+
+    /* Chroma samples can't be split. */
+    bool even_x = (format_ == PixelFormat::YUV422 || format_ == PixelFormat::YUV422P || format_ == PixelFormat::YUV420P || format_ == PixelFormat::NV12);
+    bool even_y = (format_ == PixelFormat::YUV420P || format_ == PixelFormat::NV12);
+    if ((even_x && (x % 2 != 0)) || (even_y && (y % 2 != 0))) {
+        LOGE("Invalid Argument: The offset (%d, %d) splits chroma samples of format '%d'.", x, y, static_cast<int>(format_));
+        throw std::invalid_argument("The given offset splits chroma samples.");
+    }
+
+    /* Offset every plane start, keep the strides. */
+    std::vector<uint8_t*> data = data_;
+    switch (format_) {
+        case PixelFormat::YUV:
+            data[0] += y * linesize_[0] + x * 3;
+            break;
+
+        case PixelFormat::GREY:
+            data[0] += y * linesize_[0] + x;
+            break;
+
+        case PixelFormat::YUV422:
+        case PixelFormat::DEPTH16:
+            data[0] += y * linesize_[0] + x * 2;
+            break;
+
+        case PixelFormat::RGB24:
+            data[0] += y * linesize_[0] + x * 3;
+            break;
 
-        default: 
-            LOGW("No conversions supported from format '%d'!", static_cast<int>(view.format_));
+        case PixelFormat::RGBA:
+            data[0] += y * linesize_[0] + x * 4;
             break;
+
+        case PixelFormat::NV12:
+            data[0] += y * linesize_[0] + x;
+            data[1] += (y >> 1) * linesize_[1] + x;  // (x / 2) UV pairs.
+            break;
+
+        case PixelFormat::YUV422P:
+            data[0] += y * linesize_[0] + x;
+            data[1] += y * linesize_[1] + (x >> 1);
+            data[2] += y * linesize_[2] + (x >> 1);
+            break;
+
+        case PixelFormat::YUV420P:
+            data[0] += y * linesize_[0] + x;
+            data[1] += (y >> 1) * linesize_[1] + (x >> 1);
+            data[2] += (y >> 1) * linesize_[2] + (x >> 1);
+            break;
+
+        default:
+            LOGE("Sub views of format '%d' are not supported.", static_cast<int>(format_));
+            throw std::invalid_argument("Unsupported sub view format.");
     }
+
+    return ImageView(data, linesize_, width, height, format_);
 };
 
 
 /* ============================================ Image Class ============================================ */
 Image::Image(int width, int height, PixelFormat fmt)
-  : width_(width), height_(height), format_(fmt), data_(getSize(fmt, width, height)) {};
+  : width_(width), height_(height), format_(fmt), layout_(getLayout(fmt, width, height)), data_(layout_.size) {};
 
-Image::Image(ImageView &other_view, PixelFormat fmt)
+Image::Image(ImageView &other_view, PixelFormat fmt, ColorSpace color_space)
   : Image(other_view.getWidth(), other_view.getHeight(), (fmt == PixelFormat::EMPTY) ? other_view.getFormat():fmt) {
     ImageView local_view = view();
-    local_view.copyFrom(other_view);
+    local_view.copyFrom(other_view, color_space);
 };
 
 ImageView Image::view() {
     std::vector<uint8_t*> data_ptrs;
     std::vector<int> linesizes;
 
-    switch (format_) {
-        case PixelFormat::YUV:
-            data_ptrs = {data_.data()};
-            linesizes = {3 * width_};
-            break;
-
-        case PixelFormat::YUV422:
-            data_ptrs = {data_.data()};
-            linesizes = {2 * width_};
-            break;
-        
-        case PixelFormat::YUV420P:
-            data_ptrs = {data_.data(), data_.data() + width_ * height_, data_.data() + width_ * height_ + (width_ >> 1) * (height_ >> 1)};
-            linesizes = {width_, width_ >> 1, width_ >> 1};
-            break;
-
-        case PixelFormat::YUV422P:
-            data_ptrs = {data_.data(), data_.data() + width_ * height_, data_.data() + width_ * height_ + (width_ >> 1) * height_};
-            linesizes = {width_, width_ >> 1, width_ >> 1};
-            break;
-        
-        default:
-            break;
+    for (int plane = 0; plane < layout_.num_planes; plane++) {
+        data_ptrs.push_back(data_.data() + layout_.offset[plane]);
+        linesizes.push_back(layout_.linesize[plane]);
     }
 
     return ImageView(data_ptrs, linesizes, width_, height_, format_);
 };
 
-void Image::to(PixelFormat fmt) {
+ImageView Image::view() const {
+    return const_cast<Image*>(this)->view();
+};
+
+void Image::to(PixelFormat fmt, ColorSpace color_space) {
     /* Test if conversion is required. */
     if (fmt == format_) { return; }
 
@@ -117,7 +165,7 @@ void Image::to(PixelFormat fmt) {
     Image new_image = Image(width_, height_, fmt);
     ImageView new_image_view = new_image.view();
     ImageView curr_image_view = view();
-    new_image_view.copyFrom(curr_image_view);
+    new_image_view.copyFrom(curr_image_view, color_space);
 
     /* Swap this frame with the new Image data. */
     std::swap(*this, new_image);
@@ -131,18 +179,77 @@ void Image::zero() {
     data_.resize(prev_data_length, 0);
 };
 
-int Image::getSize(PixelFormat fmt, int width, int height) {
-    int size = 0;
+PlaneLayout Image::getLayout(PixelFormat fmt, int width, int height) {
+    PlaneLayout layout = {};
+    int row_bytes[3] = {0, 0, 0};
+
+    /* Chroma planes of odd sized images still need to cover the last pixel column / row. */
+    int half_width  = (width + 1) >> 1;
+    int half_height = (height + 1) >> 1;
 
     switch (fmt) {
-        case PixelFormat::YUV    : size = width * height * 3; break;
-        case PixelFormat::YUV422 : size = width * height * 2; break;
-        case PixelFormat::YUV420P: size = (width * height * 5) << 2; break;
-        case PixelFormat::YUV422P: size = width * height * 2; break;
+        case PixelFormat::YUV:
+            layout.num_planes = 1;
+            row_bytes[0] = width * 3; layout.height[0] = height;
+            break;
+
+        case PixelFormat::YUV422:
+            layout.num_planes = 1;
+            row_bytes[0] = half_width * 4; layout.height[0] = height;
+            break;
+
+        case PixelFormat::GREY:
+            layout.num_planes = 1;
+            row_bytes[0] = width; layout.height[0] = height;
+            break;
+
+        case PixelFormat::DEPTH16:
+            layout.num_planes = 1;
+            row_bytes[0] = width * 2; layout.height[0] = height;
+            break;
+
+        case PixelFormat::RGB24:
+            layout.num_planes = 1;
+            row_bytes[0] = width * 3; layout.height[0] = height;
+            break;
+
+        case PixelFormat::RGBA:
+            layout.num_planes = 1;
+            row_bytes[0] = width * 4; layout.height[0] = height;
+            break;
+
+        case PixelFormat::NV12:
+            layout.num_planes = 2;
+            row_bytes[0] = width;          layout.height[0] = height;
+            row_bytes[1] = half_width * 2; layout.height[1] = half_height;
+            break;
+
+        case PixelFormat::YUV420P:
+            layout.num_planes = 3;
+            row_bytes[0] = width;      layout.height[0] = height;
+            row_bytes[1] = half_width; layout.height[1] = half_height;
+            row_bytes[2] = half_width; layout.height[2] = half_height;
+            break;
+
+        case PixelFormat::YUV422P:
+            layout.num_planes = 3;
+            row_bytes[0] = width;      layout.height[0] = height;
+            row_bytes[1] = half_width; layout.height[1] = height;
+            row_bytes[2] = half_width; layout.height[2] = height;
+            break;
         
         default:
             break;
     }
 
-    return size;
+    /* Align every row stride, which (as a result) also aligns every plane start. */
+    size_t offset = 0;
+    for (int plane = 0; plane < layout.num_planes; plane++) {
+        layout.linesize[plane] = static_cast<int>((row_bytes[plane] + IMAGE_ALIGNMENT - 1) / IMAGE_ALIGNMENT * IMAGE_ALIGNMENT);
+        layout.offset[plane] = offset;
+        offset += static_cast<size_t>(layout.linesize[plane]) * layout.height[plane];
+    }
+    layout.size = offset;
+
+    return layout;
 };
@@ -7,6 +7,7 @@
 /* ========================== Include ========================== */
 /* Standard C Libraries */
 #include <stdint.h>
+#include <stddef.h>
 
 /* Standard C++ Libraries */
 #include <vector>
@@ -15,6 +16,7 @@
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
+#include "aligned_allocator.h"
 
 
 /* ========================== Classes ========================== */
@@ -24,7 +26,42 @@ enum class PixelFormat {
     YUV420P,
     YUV422,
     YUV422P,
-    GREY
+    GREY,     // 8-bit luma, 1 plane (the Y plane as is, when converted from YUV).
+    DEPTH16,  // 16-bit (little-endian) depth values, 1 plane.
+    RGB24,    // Packed RGBRGB..., 1 plane.
+    RGBA,     // Packed RGBARGBA..., 1 plane (opaque when converted from other formats).
+    NV12      // Y plane, followed by one interleaved UVUV... plane (4:2:0). NOTE: keep last, see PIXEL_FORMAT_COUNT.
+};
+
+
+/**
+ * @brief Matrix used when converting between (limited range) YUV and RGB formats.
+ */
+enum class ColorSpace {
+    BT601,  // SD video, and most webcams.
+    BT709   // HD video.
+};
+
+
+/**
+ * @brief Resampling filter used when scaling between ImageViews.
+ */
+enum class ScaleFilter {
+    BOX,       // Exact integer factors only (e.g. 2x, 4x), falls back to BILINEAR otherwise.
+    BILINEAR
+};
+
+
+/**
+ * @brief Describes how the planes of an image are laid out in one contiguous buffer.
+ * @note Every plane starts on, and every row stride is a multiple of, IMAGE_ALIGNMENT bytes.
+ */
+struct PlaneLayout {
+    int    num_planes  = 0;
+    int    linesize[3] = {0, 0, 0};  // Row stride in bytes.
+    int    height[3]   = {0, 0, 0};  // Number of rows.
+    size_t offset[3]   = {0, 0, 0};  // Plane start w.r.t. the buffer start, in bytes.
+    size_t size        = 0;          // Total buffer size in bytes.
 };
 
 
@@ -33,20 +70,38 @@ class ImageView final {
     ImageView(std::vector<uint8_t*> data, std::vector<int> linesize, int width, int height, PixelFormat fmt);
 
     /**
-     * @brief Copy and cast the image data from this view to the other view.
+     * @brief Copy and cast the image data from the given view to this view.
+     * @param color_space: Matrix used when converting between YUV and RGB.
+     */
+    void copyFrom(ImageView& view, ColorSpace color_space=ColorSpace::BT601);
+
+    /**
+     * @brief Whether copyFrom() can convert from the src to the dst format.
      */
-    void copyFrom(ImageView& view);
+    static bool canConvert(PixelFormat src, PixelFormat dst);
+
+    /**
+     * @brief Convert and rescale the image data from the given view to this view's format & dimensions, in a single pass.
+     * @note Supports YUV, YUV422, YUV422P & YUV420P on both sides, and DEPTH16 to DEPTH16 (nearest neighbour, ignores the filter).
+     */
+    void scaleFrom(ImageView& view, ScaleFilter filter=ScaleFilter::BOX);
+
+    /**
+     * @brief A view of a rectangular region of this view, sharing its data & strides (no copy).
+     * @note The offset must be even in directions with chroma subsampling (x for YUV422(P), x & y for YUV420P & NV12).
+     */
+    ImageView subView(int x, int y, int width, int height);
 
     /* Getters */
     int getWidth(){ return width_; };
     int getHeight(){ return height_; };
     PixelFormat getFormat() { return format_; };
+    uint8_t* getData(int plane=0) { return data_[plane]; };
+    int getLinesize(int plane=0) { return linesize_[plane]; };
 
    private:
-    /* Conversion Functions. */
-    static void convertYUV422(ImageView& src, ImageView& dst);
-    static void convertYUV420P(ImageView& src, ImageView& dst);
-    static void convertYUV422P(ImageView& src, ImageView& dst);
+    /* Conversion Function, dispatches to the Kernel<Src, Dst> of both formats (see image_conversion.cpp). */
+    static void convert(ImageView& src, ImageView& dst, ColorSpace color_space);
 
    private:
     PixelFormat format_ = PixelFormat::EMPTY;
@@ -72,34 +127,46 @@ class Image final {
     /**
      * @brief Creates an Image with a copy of image data from the given ImageView.
      */
-    Image(ImageView &other_view, PixelFormat fmt=PixelFormat::EMPTY);
+    Image(ImageView &other_view, PixelFormat fmt=PixelFormat::EMPTY, ColorSpace color_space=ColorSpace::BT601);
 
     /**
      * @brief Returns a view of the imagedata stored in this Image (only valid as long as this Image exists).
      */
     ImageView view();
 
+    /**
+     * @brief Returns a view of a read-only (e.g. shared) Image.
+     * @note ImageView has no read-only flavour: only read through it (e.g. as the source of a copy, or an encoder).
+     */
+    ImageView view() const;
+
     /**
      * @brief Internally changes this Image's PixelFormat to the requested format.
      */
-    void to(PixelFormat fmt);
+    void to(PixelFormat fmt, ColorSpace color_space=ColorSpace::BT601);
 
     /**
      * @brief Set all image data values to zero.
      */
     void zero();
 
+    /**
+     * @brief Calculate the exact, aligned plane layout of an image with the given format and dimensions.
+     */
+    static PlaneLayout getLayout(PixelFormat fmt, int width, int height);
+
     /* Getters */
-    int getWidth(){ return width_; };
-    int getHeight(){ return height_; };
-    uint8_t* getData(){ return data_.data(); };
-    PixelFormat getFormat() { return format_; };
+    int getWidth() const { return width_; };
+    int getHeight() const { return height_; };
+    size_t getSize() const { return data_.size(); };
+    uint8_t* getData(int plane=0){ return data_.data() + layout_.offset[plane]; };
+    int getLinesize(int plane=0) const { return layout_.linesize[plane]; };
+    PixelFormat getFormat() const { return format_; };
 
    private:
-    static int getSize(PixelFormat fmt, int width, int height);
-
     PixelFormat format_ = PixelFormat::EMPTY;
-    std::vector<uint8_t> data_ = {};
+    PlaneLayout layout_ = {};
+    std::vector<uint8_t, AlignedAllocator<uint8_t>> data_ = {};
     int height_ = 0;
     int width_ = 0;
 };
@@ -1,5 +1,8 @@
 /**
  * @brief Implements conversions between different image pixel formats.
+ *
+ * @details Every supported conversion is a Kernel<Src, Dst> specialization, which knows the layout of both formats
+ * at compile time (see pixel_traits.h). The kernels are collected in a constexpr table, indexed once per copyFrom().
  */
 
 /* ========================== Include ========================== */
@@ -7,207 +10,560 @@
 
 /* Standard C Libraries */
 #include <stdint.h>
+#include <string.h>  // memcpy(), memset()
 
 /* Standard C++ Libraries */
+#include <type_traits>
+#include <utility>  // std::index_sequence
 #include <vector>
 #include <string>
-#include <stdexcept>
+#include <array>
+#include <algorithm>  // std::min()
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
+#include "pixel_traits.h"
+#include "simd.h"
 
 
-/* ========================== Classes ========================== */
-void ImageView::convertYUV422(ImageView& src, ImageView& dst) {
-    /**
-     * @note YUV 422 has 1 Cr & 1 Cb value per 2 Y values (YUYV = 2 pixels, using same U,V).
-     */
-    int width = src.width_;
-    int height = src.height_;
-
-    /* Validate Arguments. */
-    if (src.format_ != PixelFormat::YUV422) {
-        LOGE("Invalid Argument: Expected src to have the YUV422P pixel format.");
-        throw std::invalid_argument("The given src does not have the YUV422P pixel format.");
+/* ========================= Functions ========================= */
+/**
+ * @brief (Limited range) YUV to RGB matrix of the given color space.
+ */
+static simd::YUVToRGBCoefficients toRGBCoefficients(ColorSpace color_space) {
+    switch (color_space) {
+        case ColorSpace::BT709: return {75, 115, 14, 34, 135};
+        default:                return {75, 102, 25, 52, 129};
     }
+}
 
-    /* Convert to Destiation Format. */
-    switch (dst.format_) {
-        /* ------------------------ YUV422 to YUV422 ------------------------- */
-        case PixelFormat::YUV422: {
-            /* Process 1 pixel / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Image pixel coordinate system. */
-                for (int xidx = 0; xidx < width * 2; xidx++) { /* Byte coordinate system. */
-                    int src_offset = (yidx * src.linesize_[0] + xidx);
-                    int dst_offset = (yidx * dst.linesize_[0] + xidx);
-                    *(dst.data_[0] + dst_offset) = *(src.data_[0] + src_offset);
-                }
-            }
+/**
+ * @brief RGB to (limited range) YUV matrix of the given color space.
+ */
+static simd::RGBToYUVCoefficients toYUVCoefficients(ColorSpace color_space) {
+    switch (color_space) {
+        case ColorSpace::BT709: return {{47, 157, 16}, {-26, -87, 112}, {112, -102, -10}, 16};
+        default:                return {{66, 129, 25}, {-38, -74, 112}, {112, -94, -18}, 16};
+    }
+}
 
-            break;
-        }
-
-        /* -------------------------- YUV422 to YUV -------------------------- */
-        case PixelFormat::YUV: {
-            /* Process 2 pixel / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Pixel Height Coordinate. */
-                for (int xidx = 0; xidx < width; xidx+=2) { /* Pixel Width Coordinate. */
-                    /* Converting even pixel. */
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 0) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 0);  // Y1
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 1) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 1);  // U (use same U for even / uneven pixel)
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 2) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 3);  // V (use same V for even / uneven pixel)
-                
-                    /* Converting uneven pixel. */
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 3) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 2);  // Y2
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 4) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 1);  // U (use same U for even / uneven pixel)
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 5) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 3);  // V (use same V for even / uneven pixel)
-                }
+/**
+ * @brief RGB to (full range) luma matrix of the given color space, for GREY.
+ */
+static simd::RGBToYUVCoefficients toGreyCoefficients(ColorSpace color_space) {
+    switch (color_space) {
+        case ColorSpace::BT709: return {{54, 183, 19}, {0, 0, 0}, {0, 0, 0}, 0};
+        default:                return {{77, 150, 29}, {0, 0, 0}, {0, 0, 0}, 0};
+    }
+}
+
+
+/* ========================== Kernels ========================== */
+/**
+ * @brief The planes of a view, copied once out of its vectors for the kernels' inner loops.
+ */
+struct Planes {
+    uint8_t* data[3] = {nullptr, nullptr, nullptr};
+    int linesize[3]  = {0, 0, 0};
+    int width  = 0;
+    int height = 0;
+
+    uint8_t* row(int plane, int yidx) const { return data[plane] + yidx * linesize[plane]; };
+};
+
+template<PixelFormat Src, PixelFormat Dst, typename Enable=void>
+struct Kernel {
+    static constexpr bool supported = false;
+};
+
+template<PixelFormat F> using Traits = PixelTraits<F>;
+template<bool Condition> using When  = typename std::enable_if<Condition>::type;
+
+
+/* ------------------------- Any to Itself ------------------------- */
+template<PixelFormat F>
+struct Kernel<F, F, When<(Traits<F>::num_planes > 0)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Copy row by row (strides may differ). */
+        for (int plane = 0; plane < Traits<F>::num_planes; plane++) {
+            int row_bytes = Traits<F>::rowBytes(plane, src.width);
+            for (int yidx = 0; yidx < Traits<F>::rowCount(plane, src.height); yidx++) {
+                memcpy(dst.row(plane, yidx), src.row(plane, yidx), row_bytes);
             }
-            break;
-        }
-
-        /* ------------------------ YUV422 to YUV422P ------------------------ */
-        case PixelFormat::YUV422P: {
-            /* Setup Plane Variables. */
-            uint8_t* dst_planar_y_base = dst.data_[0];
-            uint8_t* dst_planar_u_base = dst.data_[1];
-            uint8_t* dst_planar_v_base = dst.data_[2];
-
-            /* Process two pixels / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Pixel coordinate in y directions. */
-                for (int xidx = 0; xidx < width; xidx+=2) { /* Pixel coordinate in x direction (left 1 of 2). */
-                    *(dst_planar_y_base + yidx * dst.linesize_[0] + xidx + 0)    = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 0);  // Y1 (even pixel)
-                    *(dst_planar_y_base + yidx * dst.linesize_[0] + xidx + 1)    = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 2);  // Y2 (uneven pixel)
-                    *(dst_planar_u_base + yidx * dst.linesize_[1] + (xidx >> 1)) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 1);  // U (use for even / uneven pixel)
-                    *(dst_planar_v_base + yidx * dst.linesize_[2] + (xidx >> 1)) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 3);  // V (use for even / uneven pixel)
-                }
+        }
+    };
+};
+
+/* ----------------------- YUV planar to GREY ----------------------- */
+template<PixelFormat Src>
+struct Kernel<Src, PixelFormat::GREY, When<(Traits<Src>::num_planes > 1)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Only the luma. */
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            memcpy(dst.row(0, yidx), src.row(0, yidx), src.width);
+        }
+    };
+};
+
+/* ----------------------- YUV planar to YUV ----------------------- */
+template<PixelFormat Src>
+struct Kernel<Src, PixelFormat::YUV, When<(Traits<Src>::num_planes == 3)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process 1 row / iteration (a subsampled chroma row is used for multiple rows). */
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            int chroma_row = yidx >> Traits<Src>::chroma_shift_y;
+            simd::interleaveYUV(src.row(0, yidx), src.row(1, chroma_row), src.row(2, chroma_row), dst.row(0, yidx), src.width);
+        }
+    };
+};
+
+/* --------------------- YUV planar to RGB(A) --------------------- */
+template<PixelFormat Src, PixelFormat Dst>
+struct Kernel<Src, Dst, When<(Traits<Src>::num_planes == 3 && Traits<Dst>::is_rgb)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        /* Process 1 row / iteration (a subsampled chroma row is used for multiple rows). */
+        simd::YUVToRGBCoefficients matrix = toRGBCoefficients(color_space);
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            int chroma_row = yidx >> Traits<Src>::chroma_shift_y;
+            simd::yuvToRGB(src.row(0, yidx), src.row(1, chroma_row), src.row(2, chroma_row), dst.row(0, yidx), src.width, Traits<Dst>::bytes_per_pixel, matrix);
+        }
+    };
+};
+
+/* ------------------------ YUV422 to YUV ------------------------ */
+template<>
+struct Kernel<PixelFormat::YUV422, PixelFormat::YUV> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process 2 pixel / iteration (use same U, V for the even / uneven pixel). */
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            uint8_t* out = dst.row(0, yidx);
+            for (int xidx = 0; xidx < src.width; xidx += 2) {
+                out[xidx * 3 + 0] = in[xidx * 2 + 0];  // Y1
+                out[xidx * 3 + 1] = in[xidx * 2 + 1];  // U
+                out[xidx * 3 + 2] = in[xidx * 2 + 3];  // V
+                out[xidx * 3 + 3] = in[xidx * 2 + 2];  // Y2
+                out[xidx * 3 + 4] = in[xidx * 2 + 1];  // U
+                out[xidx * 3 + 5] = in[xidx * 2 + 3];  // V
             }
-            
-            break;
-        }
-
-        /* -------------------------- YUV422 to GREY -------------------------- */
-        case PixelFormat::GREY: {
-            /* Process 2 pixel / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Pixel Height Coordinate. */
-                for (int xidx = 0; xidx < width; xidx+=2) { /* Pixel Width Coordinate. */
-                    /* Converting even pixel. */
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 0) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 0);  // Y1
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 1) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 1);  // U (use same U for even / uneven pixel)
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 2) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 3);  // V (use same V for even / uneven pixel)
-                
-                    /* Converting uneven pixel. */
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 3) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 2);  // Y2
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 4) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 1);  // U (use same U for even / uneven pixel)
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 5) = *(src.data_[0] + yidx * src.linesize_[0] + xidx * 2 + 3);  // V (use same V for even / uneven pixel)
-                }
+        }
+    };
+};
+
+/* ---------------------- YUV422 to YUV422P ---------------------- */
+template<>
+struct Kernel<PixelFormat::YUV422, PixelFormat::YUV422P> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process two pixels / iteration. */
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            uint8_t* out_y = dst.row(0, yidx);
+            uint8_t* out_u = dst.row(1, yidx);
+            uint8_t* out_v = dst.row(2, yidx);
+            for (int xidx = 0; xidx < src.width; xidx += 2) {
+                out_y[xidx + 0]    = in[xidx * 2 + 0];  // Y1 (even pixel)
+                out_y[xidx + 1]    = in[xidx * 2 + 2];  // Y2 (uneven pixel)
+                out_u[xidx >> 1]   = in[xidx * 2 + 1];  // U (use for even / uneven pixel)
+                out_v[xidx >> 1]   = in[xidx * 2 + 3];  // V (use for even / uneven pixel)
             }
-            break;
         }
-        
-        default:
-            LOGW("Conversion from format '%d' to '%d' is not supported!", static_cast<int>(src.format_), static_cast<int>(dst.format_));
-            break;
-    }
+    };
 };
 
-void ImageView::convertYUV420P(ImageView& src, ImageView& dst) {
-    int width = src.width_;
-    int height = src.height_;
+/* ---------------------- YUV422 to YUV420P ---------------------- */
+template<>
+struct Kernel<PixelFormat::YUV422, PixelFormat::YUV420P> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process two rows / iteration: deinterleave, and average the chroma of both rows (in one pass). */
+        int height = src.height;
+        for (int yidx = 0; yidx < height; yidx += 2) {
+            const uint8_t* src_row0 = src.row(0, yidx);
+            const uint8_t* src_row1 = (yidx + 1 < height) ? src_row0 + src.linesize[0] : src_row0;  // Odd height: repeat last row.
+            uint8_t* dst_y0 = dst.row(0, yidx);
+            uint8_t* dst_y1 = (yidx + 1 < height) ? dst_y0 + dst.linesize[0] : dst_y0;
+            simd::deinterleaveYUYV420(src_row0, src_row1, dst_y0, dst_y1, dst.row(1, yidx >> 1), dst.row(2, yidx >> 1), src.width);
+        }
+    };
+};
 
-    /* Validate Arguments. */
-    if (src.format_ != PixelFormat::YUV420P) {
-        LOGE("Invalid Argument: Expected src to have the YUV420P pixel format.");
-        throw std::invalid_argument("The given src does not have the YUV420P pixel format.");
-    }
+/* ------------------------ YUV422 to NV12 ------------------------ */
+template<>
+struct Kernel<PixelFormat::YUV422, PixelFormat::NV12> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process two rows / iteration: deinterleave & average the chroma of both rows, then interleave it as UV pairs. */
+        int height = src.height;
+        int half_width = (src.width + 1) >> 1;
+        std::vector<uint8_t> u(half_width), v(half_width);
+        for (int yidx = 0; yidx < height; yidx += 2) {
+            const uint8_t* src_row0 = src.row(0, yidx);
+            const uint8_t* src_row1 = (yidx + 1 < height) ? src_row0 + src.linesize[0] : src_row0;  // Odd height: repeat last row.
+            uint8_t* dst_y0 = dst.row(0, yidx);
+            uint8_t* dst_y1 = (yidx + 1 < height) ? dst_y0 + dst.linesize[0] : dst_y0;
+            simd::deinterleaveYUYV420(src_row0, src_row1, dst_y0, dst_y1, u.data(), v.data(), src.width);
+            simd::interleavePairs(u.data(), v.data(), dst.row(1, yidx >> 1), half_width);
+        }
+    };
+};
 
-    /* Convert to Destiation Format. */
-    switch (dst.format_) {
-        /* ------------------------ YUV420P to YUV ------------------------ */
-        case PixelFormat::YUV: {
-            /* Setup Plane Variables. */
-            uint8_t* src_planar_y_base = src.data_[0];
-            uint8_t* src_planar_u_base = src.data_[1];
-            uint8_t* src_planar_v_base = src.data_[2];
-
-            /* Process 1 pixel / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Pixel Height Coordinate. */
-                for (int xidx = 0; xidx < width; xidx++) { /* Pixel Width Coordinate. */
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 0) = *(src_planar_y_base + yidx * src.linesize_[0] + xidx + 0);            // Y
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 1) = *(src_planar_u_base + (yidx >> 1) * src.linesize_[1] + (xidx >> 1));  // U (use same U for even / uneven pixel)
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 2) = *(src_planar_v_base + (yidx >> 1) * src.linesize_[2] + (xidx >> 1));  // V (use same V for even / uneven pixel)
-                }
+/* ------------------------ YUV422 to GREY ------------------------ */
+template<>
+struct Kernel<PixelFormat::YUV422, PixelFormat::GREY> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process 1 row / iteration: keep the luma (even) bytes. */
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            simd::extractEven(src.row(0, yidx), dst.row(0, yidx), src.width);
+        }
+    };
+};
+
+/* ----------------------- YUV422 to RGB(A) ----------------------- */
+template<PixelFormat Dst>
+struct Kernel<PixelFormat::YUV422, Dst, When<Traits<Dst>::is_rgb>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        /* Process 1 row / iteration: deinterleave into planar rows first. */
+        int width = src.width;
+        simd::YUVToRGBCoefficients matrix = toRGBCoefficients(color_space);
+        std::vector<uint8_t> y(width), u((width + 1) >> 1), v((width + 1) >> 1);
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* src_row = src.row(0, yidx);
+            simd::deinterleaveYUYV420(src_row, src_row, y.data(), y.data(), u.data(), v.data(), width);  // Average of one row.
+            simd::yuvToRGB(y.data(), u.data(), v.data(), dst.row(0, yidx), width, Traits<Dst>::bytes_per_pixel, matrix);
+        }
+    };
+};
+
+/* ----------------------- YUV420P to NV12 ----------------------- */
+template<>
+struct Kernel<PixelFormat::YUV420P, PixelFormat::NV12> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Copy the luma, interleave the chroma rows as UV pairs. */
+        int half_width = (src.width + 1) >> 1;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            memcpy(dst.row(0, yidx), src.row(0, yidx), src.width);
+        }
+        for (int yidx = 0; yidx < (src.height + 1) >> 1; yidx++) {
+            simd::interleavePairs(src.row(1, yidx), src.row(2, yidx), dst.row(1, yidx), half_width);
+        }
+    };
+};
+
+/* ---------------------- YUV422P to YUV420P ---------------------- */
+template<>
+struct Kernel<PixelFormat::YUV422P, PixelFormat::YUV420P> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        int half_width = (src.width + 1) >> 1;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            memcpy(dst.row(0, yidx), src.row(0, yidx), src.width);
+        }
+
+        /* Average every two chroma rows (the last row is repeated for uneven heights). */
+        for (int yidx = 0; yidx < (src.height + 1) >> 1; yidx++) {
+            int row0 = 2 * yidx;
+            int row1 = std::min(2 * yidx + 1, src.height - 1);
+            simd::averageRows(src.row(1, row0), src.row(1, row1), dst.row(1, yidx), half_width);
+            simd::averageRows(src.row(2, row0), src.row(2, row1), dst.row(2, yidx), half_width);
+        }
+    };
+};
+
+/* ----------------------- YUV422P to NV12 ----------------------- */
+template<>
+struct Kernel<PixelFormat::YUV422P, PixelFormat::NV12> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        int half_width = (src.width + 1) >> 1;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            memcpy(dst.row(0, yidx), src.row(0, yidx), src.width);
+        }
+
+        /* Average every two chroma rows (the last row is repeated for uneven heights), and interleave them as UV pairs. */
+        std::vector<uint8_t> u(half_width), v(half_width);
+        for (int yidx = 0; yidx < (src.height + 1) >> 1; yidx++) {
+            int row0 = 2 * yidx;
+            int row1 = std::min(2 * yidx + 1, src.height - 1);
+            simd::averageRows(src.row(1, row0), src.row(1, row1), u.data(), half_width);
+            simd::averageRows(src.row(2, row0), src.row(2, row1), v.data(), half_width);
+            simd::interleavePairs(u.data(), v.data(), dst.row(1, yidx), half_width);
+        }
+    };
+};
+
+/* --------------------- NV12 to YUV420P / YUV422P --------------------- */
+template<PixelFormat Dst>
+struct Kernel<PixelFormat::NV12, Dst, When<(Traits<Dst>::num_planes == 3)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        int half_width = (src.width + 1) >> 1;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            memcpy(dst.row(0, yidx), src.row(0, yidx), src.width);
+        }
+
+        /* Deinterleave the UV pairs (4:2:2 uses every chroma row for two rows). */
+        constexpr int shift = 1 - Traits<Dst>::chroma_shift_y;
+        for (int yidx = 0; yidx < Traits<Dst>::rowCount(1, src.height); yidx++) {
+            simd::deinterleavePairs(src.row(1, yidx >> shift), dst.row(1, yidx), dst.row(2, yidx), half_width);
+        }
+    };
+};
+
+/* --------------------- NV12 to YUV / RGB(A) --------------------- */
+template<PixelFormat Dst>
+struct Kernel<PixelFormat::NV12, Dst, When<(Dst == PixelFormat::YUV || Traits<Dst>::is_rgb)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        /* Process 1 row / iteration, deinterleaving every chroma row once (it is used for two rows). */
+        int half_width = (src.width + 1) >> 1;
+        simd::YUVToRGBCoefficients matrix = toRGBCoefficients(color_space);
+        std::vector<uint8_t> u(half_width), v(half_width);
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            if ((yidx & 1) == 0) {
+                simd::deinterleavePairs(src.row(1, yidx >> 1), u.data(), v.data(), half_width);
+            }
+            if (Dst == PixelFormat::YUV) {
+                simd::interleaveYUV(src.row(0, yidx), u.data(), v.data(), dst.row(0, yidx), src.width);
+            } else {
+                simd::yuvToRGB(src.row(0, yidx), u.data(), v.data(), dst.row(0, yidx), src.width, Traits<Dst>::bytes_per_pixel, matrix);
             }
-            break;
         }
-        
-        default:
-            LOGW("Conversion from format '%d' to '%d' is not supported!", static_cast<int>(src.format_), static_cast<int>(dst.format_));
-            break;
-    }
+    };
 };
 
-void ImageView::convertYUV422P(ImageView& src, ImageView& dst) {
-    int width = src.width_;
-    int height = src.height_;
+/* --------------------- GREY to YUV planar --------------------- */
+template<PixelFormat Dst>
+struct Kernel<PixelFormat::GREY, Dst, When<(Traits<Dst>::num_planes > 1)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* GREY is used as the luma as is, with neutral (128) chroma. */
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            memcpy(dst.row(0, yidx), src.row(0, yidx), src.width);
+        }
+        for (int plane = 1; plane < Traits<Dst>::num_planes; plane++) {
+            int row_bytes = Traits<Dst>::rowBytes(plane, src.width);
+            for (int yidx = 0; yidx < Traits<Dst>::rowCount(plane, src.height); yidx++) {
+                memset(dst.row(plane, yidx), 128, row_bytes);
+            }
+        }
+    };
+};
 
-    /* Validate Arguments. */
-    if (src.format_ != PixelFormat::YUV422P) {
-        LOGE("Invalid Argument: Expected src to have the YUV422P pixel format.");
-        throw std::invalid_argument("The given src does not have the YUV422P pixel format.");
-    }
+/* ------------------------ GREY to YUV422 ------------------------ */
+template<>
+struct Kernel<PixelFormat::GREY, PixelFormat::YUV422> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process 1 pixel / iteration (the last pair of uneven widths repeats the last pixel). */
+        int width = src.width;
+        int half_width = (width + 1) >> 1;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            uint8_t* out = dst.row(0, yidx);
+            for (int xidx = 0; xidx < 2 * half_width; xidx++) {
+                out[2 * xidx + 0] = in[std::min(xidx, width - 1)];
+                out[2 * xidx + 1] = 128;
+            }
+        }
+    };
+};
 
-    /* Convert to Destiation Format. */
-    switch (dst.format_) {
-        /* ---------------------- YUV422P to YUV422P ---------------------- */
-        case PixelFormat::YUV422P: {
-            /* Setup Plane Variables. */
-            uint8_t* src_planar_y_base = src.data_[0];
-            uint8_t* src_planar_u_base = src.data_[1];
-            uint8_t* src_planar_v_base = src.data_[2];
-
-            uint8_t* dst_planar_y_base = dst.data_[0];
-            uint8_t* dst_planar_u_base = dst.data_[1];
-            uint8_t* dst_planar_v_base = dst.data_[2];
-
-            /* Copy over ~1 pixel / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Pixel Height Coordinate. */
-                for (int xidx = 0; xidx < width; xidx++) { /* Pixel Width Coordinate. */
-
-                    /* Copy over Y pixel. */
-                    *(dst_planar_y_base + yidx * dst.linesize_[0] + xidx + 0) = *(src_planar_y_base + yidx * src.linesize_[0] + xidx + 0);
-
-                    /* Copy over U & V pixels (once for every two pixels). */
-                    if (xidx % 2 == 0) {
-                        *(dst_planar_u_base + yidx * dst.linesize_[1] + (xidx >> 1)) = *(src_planar_u_base + yidx * src.linesize_[1] + (xidx >> 1));  // U (use same U for even / uneven pixel)
-                        uint8_t val = *(src_planar_v_base + yidx * src.linesize_[2] + (xidx >> 1));
-                        *(dst_planar_v_base + yidx * dst.linesize_[2] + (xidx >> 1)) = val;  // V (use same V for even / uneven pixel)
-                    }
+/* -------------------- GREY to YUV / RGB(A) -------------------- */
+template<PixelFormat Dst>
+struct Kernel<PixelFormat::GREY, Dst, When<(Dst == PixelFormat::YUV || Traits<Dst>::is_rgb)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Process 1 pixel / iteration (the compiler does best here, with the channels known). */
+        constexpr int  channels = Traits<Dst>::bytes_per_pixel;
+        constexpr bool rgb      = Traits<Dst>::is_rgb;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            uint8_t* out = dst.row(0, yidx);
+            for (int xidx = 0; xidx < src.width; xidx++) {
+                out[channels * xidx + 0] = in[xidx];
+                out[channels * xidx + 1] = rgb ? in[xidx] : 128;
+                out[channels * xidx + 2] = rgb ? in[xidx] : 128;
+                if (channels == 4) {
+                    out[channels * xidx + 3] = 0xFF;
                 }
             }
-            break;
-        }
-
-        /* ------------------------ YUV422P to YUV ------------------------ */
-        case PixelFormat::YUV: {
-            /* Setup Plane Variables. */
-            uint8_t* src_planar_y_base = src.data_[0];
-            uint8_t* src_planar_u_base = src.data_[1];
-            uint8_t* src_planar_v_base = src.data_[2];
-
-            /* Process 1 pixel / iteration. */
-            for (int yidx = 0; yidx < height; yidx++) { /* Pixel Height Coordinate. */
-                for (int xidx = 0; xidx < width; xidx++) { /* Pixel Width Coordinate. */
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 0) = *(src_planar_y_base + yidx * src.linesize_[0] + xidx + 0);     // Y
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 1) = *(src_planar_u_base + yidx * src.linesize_[1] + (xidx >> 1));  // U (use same U for even / uneven pixel)
-                    *(dst.data_[0] + yidx * dst.linesize_[0] + xidx * 3 + 2) = *(src_planar_v_base + yidx * src.linesize_[2] + (xidx >> 1));  // V (use same V for even / uneven pixel)
+        }
+    };
+};
+
+/* -------------------- RGB24 to RGBA / RGBA to RGB24 -------------------- */
+template<PixelFormat Src, PixelFormat Dst>
+struct Kernel<Src, Dst, When<(Src != Dst && Traits<Src>::is_rgb && Traits<Dst>::is_rgb)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace) {
+        /* Add / drop the alpha channel (the compiler does best here, with the channels known). */
+        constexpr int src_channels = Traits<Src>::bytes_per_pixel;
+        constexpr int dst_channels = Traits<Dst>::bytes_per_pixel;
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            uint8_t* out = dst.row(0, yidx);
+            for (int xidx = 0; xidx < src.width; xidx++) {
+                out[dst_channels * xidx + 0] = in[src_channels * xidx + 0];
+                out[dst_channels * xidx + 1] = in[src_channels * xidx + 1];
+                out[dst_channels * xidx + 2] = in[src_channels * xidx + 2];
+                if (dst_channels == 4) {
+                    out[dst_channels * xidx + 3] = 0xFF;
                 }
             }
-            break;
         }
-        
-        default:
-            LOGW("Conversion from format '%d' to '%d' is not supported!", static_cast<int>(src.format_), static_cast<int>(dst.format_));
-            break;
+    };
+};
+
+/* ------------------------ RGB(A) to GREY ------------------------ */
+template<PixelFormat Src>
+struct Kernel<Src, PixelFormat::GREY, When<Traits<Src>::is_rgb>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        simd::RGBToYUVCoefficients grey = toGreyCoefficients(color_space);
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            simd::rgbToLuma(src.row(0, yidx), Traits<Src>::bytes_per_pixel, dst.row(0, yidx), src.width, grey);
+        }
+    };
+};
+
+/* ----------------------- RGB(A) to YUV422P ----------------------- */
+template<PixelFormat Src>
+struct Kernel<Src, PixelFormat::YUV422P, When<Traits<Src>::is_rgb>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        /* Chroma is subsampled by averaging 2 pixels. */
+        simd::RGBToYUVCoefficients matrix = toYUVCoefficients(color_space);
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            simd::rgbToLuma(in, Traits<Src>::bytes_per_pixel, dst.row(0, yidx), src.width, matrix);
+            simd::rgbToChroma(in, Traits<Src>::bytes_per_pixel, dst.row(1, yidx), dst.row(2, yidx), src.width, matrix);
+        }
+    };
+};
+
+/* ----------------------- RGB(A) to YUV422 ----------------------- */
+template<PixelFormat Src>
+struct Kernel<Src, PixelFormat::YUV422, When<Traits<Src>::is_rgb>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        /* Convert into planar rows, then pack them as YUYV. */
+        int width = src.width;
+        int half_width = (width + 1) >> 1;
+        simd::RGBToYUVCoefficients matrix = toYUVCoefficients(color_space);
+        std::vector<uint8_t> y(2 * half_width), u(half_width), v(half_width);
+        for (int yidx = 0; yidx < src.height; yidx++) {
+            const uint8_t* in = src.row(0, yidx);
+            simd::rgbToLuma(in, Traits<Src>::bytes_per_pixel, y.data(), width, matrix);
+            simd::rgbToChroma(in, Traits<Src>::bytes_per_pixel, u.data(), v.data(), width, matrix);
+            y[2 * half_width - 1] = y[width - 1];  // Uneven widths: repeat the last pixel.
+
+            uint8_t* out = dst.row(0, yidx);
+            for (int xidx = 0; xidx < half_width; xidx++) {
+                out[4 * xidx + 0] = y[2 * xidx];
+                out[4 * xidx + 1] = u[xidx];
+                out[4 * xidx + 2] = y[2 * xidx + 1];
+                out[4 * xidx + 3] = v[xidx];
+            }
+        }
+    };
+};
+
+/* ------------------- RGB(A) to YUV420P / NV12 ------------------- */
+template<PixelFormat Src, PixelFormat Dst>
+struct Kernel<Src, Dst, When<(Traits<Src>::is_rgb && Traits<Dst>::has_chroma && Traits<Dst>::chroma_shift_y == 1)>> {
+    static constexpr bool supported = true;
+    static void run(Planes const& src, Planes const& dst, ColorSpace color_space) {
+        /* Process two rows / iteration, averaging the chroma of 2x2 pixels. */
+        constexpr int channels = Traits<Src>::bytes_per_pixel;
+        int height = src.height;
+        int half_width = (src.width + 1) >> 1;
+        simd::RGBToYUVCoefficients matrix = toYUVCoefficients(color_space);
+        std::vector<uint8_t> chroma(4 * half_width);
+        uint8_t* u0 = chroma.data();
+        uint8_t* v0 = u0 + half_width;
+        uint8_t* u1 = v0 + half_width;
+        uint8_t* v1 = u1 + half_width;
+        for (int yidx = 0; yidx < height; yidx += 2) {
+            const uint8_t* row0 = src.row(0, yidx);
+            const uint8_t* row1 = (yidx + 1 < height) ? row0 + src.linesize[0] : row0;  // Odd height: repeat last row.
+
+            simd::rgbToLuma(row0, channels, dst.row(0, yidx), src.width, matrix);
+            if (yidx + 1 < height) {
+                simd::rgbToLuma(row1, channels, dst.row(0, yidx + 1), src.width, matrix);
+            }
+            simd::rgbToChroma(row0, channels, u0, v0, src.width, matrix);
+            simd::rgbToChroma(row1, channels, u1, v1, src.width, matrix);
+
+            if (Traits<Dst>::num_planes == 2) {
+                simd::averageRows(u0, u1, u0, half_width);
+                simd::averageRows(v0, v1, v0, half_width);
+                simd::interleavePairs(u0, v0, dst.row(1, yidx >> 1), half_width);
+            } else {
+                simd::averageRows(u0, u1, dst.row(1, yidx >> 1), half_width);
+                simd::averageRows(v0, v1, dst.row(2, yidx >> 1), half_width);
+            }
+        }
+    };
+};
+
+
+/* ======================= Dispatch Table ======================= */
+using ConvertFunction = void (*)(Planes const& src, Planes const& dst, ColorSpace color_space);
+
+template<size_t Index>
+constexpr ConvertFunction tableEntry() {
+    constexpr PixelFormat src = static_cast<PixelFormat>(Index / PIXEL_FORMAT_COUNT);
+    constexpr PixelFormat dst = static_cast<PixelFormat>(Index % PIXEL_FORMAT_COUNT);
+    if constexpr (Kernel<src, dst>::supported) {
+        return &Kernel<src, dst>::run;
+    } else {
+        return nullptr;
+    }
+}
+
+template<size_t... Index>
+constexpr std::array<ConvertFunction, sizeof...(Index)> makeTable(std::index_sequence<Index...>) {
+    return {{tableEntry<Index>()...}};
+}
+
+/* Indexed by [src * PIXEL_FORMAT_COUNT + dst], nullptr for unsupported conversions. */
+static constexpr std::array<ConvertFunction, PIXEL_FORMAT_COUNT * PIXEL_FORMAT_COUNT> CONVERSIONS =
+    makeTable(std::make_index_sequence<PIXEL_FORMAT_COUNT * PIXEL_FORMAT_COUNT>());
+
+
+/* ========================== Classes ========================== */
+bool ImageView::canConvert(PixelFormat src, PixelFormat dst) {
+    return CONVERSIONS[static_cast<int>(src) * PIXEL_FORMAT_COUNT + static_cast<int>(dst)] != nullptr;
+};
+
+void ImageView::convert(ImageView& src, ImageView& dst, ColorSpace color_space) {
+    int index = static_cast<int>(src.format_) * PIXEL_FORMAT_COUNT + static_cast<int>(dst.format_);
+    ConvertFunction kernel = CONVERSIONS[index];
+    if (!kernel) {
+        LOGW("Conversion from format '%d' to '%d' is not supported!", static_cast<int>(src.format_), static_cast<int>(dst.format_));
+        return;
     }
+
+    Planes src_planes, dst_planes;
+    for (size_t plane = 0; plane < src.data_.size() && plane < 3; plane++) {
+        src_planes.data[plane]     = src.data_[plane];
+        src_planes.linesize[plane] = src.linesize_[plane];
+    }
+    for (size_t plane = 0; plane < dst.data_.size() && plane < 3; plane++) {
+        dst_planes.data[plane]     = dst.data_[plane];
+        dst_planes.linesize[plane] = dst.linesize_[plane];
+    }
+    src_planes.width  = dst_planes.width  = src.width_;
+    src_planes.height = dst_planes.height = src.height_;
+
+    kernel(src_planes, dst_planes, color_space);
 };
@@ -0,0 +1,255 @@
+/**
+ * @brief Implements (fused format conversion &) rescaling between ImageViews.
+ */
+
+/* ========================== Include ========================== */
+#include "image.h"
+
+/* Standard C Libraries */
+#include <stdint.h>
+#include <string.h>  // memcpy()
+
+/* Standard C++ Libraries */
+#include <vector>
+#include <algorithm>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+#include "simd.h"
+
+
+/* ========================== Defines ========================== */
+#define MAX_BOX_FACTOR  8  // Larger integer factors are resampled bilinearly.
+
+
+/* ========================== Helpers ========================== */
+/**
+ * @brief Where the samples of one (Y, U or V) plane live, for packed & planar formats alike.
+ */
+struct PlaneSamples {
+    uint8_t *data = nullptr;
+    int linesize  = 0;
+    int step      = 1;  // Bytes between horizontally neighbouring samples.
+    int width     = 0;
+    int height    = 0;
+};
+
+/**
+ * @brief Describe the Y, U & V planes of the given view.
+ * @return False if the format is not supported.
+ */
+static bool getPlanes(ImageView& view, PlaneSamples planes[3]) {
+    int width  = view.getWidth();
+    int height = view.getHeight();
+    int half_width  = (width + 1) >> 1;
+    int half_height = (height + 1) >> 1;
+
+    switch (view.getFormat()) {
+        case PixelFormat::YUV:  /* YUVYUV... */
+            planes[0] = {view.getData() + 0, view.getLinesize(), 3, width, height};
+            planes[1] = {view.getData() + 1, view.getLinesize(), 3, width, height};
+            planes[2] = {view.getData() + 2, view.getLinesize(), 3, width, height};
+            return true;
+
+        case PixelFormat::YUV422:  /* YUYV... */
+            planes[0] = {view.getData() + 0, view.getLinesize(), 2, width,      height};
+            planes[1] = {view.getData() + 1, view.getLinesize(), 4, half_width, height};
+            planes[2] = {view.getData() + 3, view.getLinesize(), 4, half_width, height};
+            return true;
+
+        case PixelFormat::YUV422P:
+            planes[0] = {view.getData(0), view.getLinesize(0), 1, width,      height};
+            planes[1] = {view.getData(1), view.getLinesize(1), 1, half_width, height};
+            planes[2] = {view.getData(2), view.getLinesize(2), 1, half_width, height};
+            return true;
+
+        case PixelFormat::YUV420P:
+            planes[0] = {view.getData(0), view.getLinesize(0), 1, width,      height};
+            planes[1] = {view.getData(1), view.getLinesize(1), 1, half_width, half_height};
+            planes[2] = {view.getData(2), view.getLinesize(2), 1, half_width, half_height};
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Returns a unit stride version of the given source row (gathered in scratch, if needed).
+ */
+static const uint8_t* readRow(PlaneSamples const& plane, int yidx, std::vector<uint8_t>& scratch) {
+    const uint8_t *row = plane.data + static_cast<size_t>(yidx) * plane.linesize;
+    if (plane.step == 1) {
+        return row;
+    }
+
+    for (int xidx = 0; xidx < plane.width; xidx++) {
+        scratch[xidx] = row[xidx * plane.step];
+    }
+    return scratch.data();
+}
+
+/**
+ * @brief Store a unit stride row into the given destination row.
+ */
+static void writeRow(PlaneSamples const& plane, int yidx, const uint8_t *values) {
+    uint8_t *row = plane.data + static_cast<size_t>(yidx) * plane.linesize;
+    if (plane.step == 1) {
+        if (row != values) { memcpy(row, values, plane.width); }
+        return;
+    }
+
+    for (int xidx = 0; xidx < plane.width; xidx++) {
+        row[xidx * plane.step] = values[xidx];
+    }
+}
+
+/**
+ * @brief Area average over exact fx by fy blocks, using the vectorized kernels for 2x2 & 4x4.
+ */
+static void scaleBox(PlaneSamples const& src, PlaneSamples const& dst, int fx, int fy) {
+    std::vector<std::vector<uint8_t>> scratch(fy, std::vector<uint8_t>(src.width));
+    std::vector<const uint8_t*> rows(fy);
+    std::vector<uint8_t> output(dst.width);
+
+    for (int yidx = 0; yidx < dst.height; yidx++) {
+        for (int row = 0; row < fy; row++) {
+            rows[row] = readRow(src, yidx * fy + row, scratch[row]);
+        }
+
+        /* Write straight into unit stride destinations. */
+        uint8_t *out = (dst.step == 1) ? dst.data + static_cast<size_t>(yidx) * dst.linesize : output.data();
+
+        if (fx == 2 && fy == 2) {
+            simd::average2x2(rows[0], rows[1], out, dst.width);
+        } else if (fx == 4 && fy == 4) {
+            simd::average4x4(rows.data(), out, dst.width);
+        } else {
+            int count = fx * fy;
+            for (int xidx = 0; xidx < dst.width; xidx++) {
+                int sum = 0;
+                for (int row = 0; row < fy; row++) {
+                    for (int col = 0; col < fx; col++) {
+                        sum += rows[row][xidx * fx + col];
+                    }
+                }
+                out[xidx] = static_cast<uint8_t>((sum + count / 2) / count);
+            }
+        }
+
+        writeRow(dst, yidx, out);
+    }
+}
+
+/**
+ * @brief Map destination sample centers onto the source: lower index & 8-bit weight of the upper neighbour.
+ */
+static void bilinearMap(int src_size, int dst_size, std::vector<int>& lower, std::vector<int>& weight) {
+    lower.resize(dst_size);
+    weight.resize(dst_size);
+
+    float scale = static_cast<float>(src_size) / static_cast<float>(dst_size);
+    for (int idx = 0; idx < dst_size; idx++) {
+        float position = std::min(std::max((idx + 0.5f) * scale - 0.5f, 0.0f), static_cast<float>(src_size - 1));
+        lower[idx]  = static_cast<int>(position);
+        weight[idx] = static_cast<int>((position - lower[idx]) * 256.0f + 0.5f);
+    }
+}
+
+/**
+ * @brief Bilinear resampling (8-bit fixed point weights), for arbitrary factors.
+ */
+static void scaleBilinear(PlaneSamples const& src, PlaneSamples const& dst) {
+    std::vector<int> x_lower, x_weight, y_lower, y_weight;
+    bilinearMap(src.width,  dst.width,  x_lower, x_weight);
+    bilinearMap(src.height, dst.height, y_lower, y_weight);
+
+    std::vector<uint8_t> scratch_top(src.width), scratch_bottom(src.width);
+    std::vector<uint8_t> output(dst.width);
+
+    for (int yidx = 0; yidx < dst.height; yidx++) {
+        const uint8_t *top    = readRow(src, y_lower[yidx], scratch_top);
+        const uint8_t *bottom = readRow(src, std::min(y_lower[yidx] + 1, src.height - 1), scratch_bottom);
+        int wy = y_weight[yidx];
+
+        for (int xidx = 0; xidx < dst.width; xidx++) {
+            int x0 = x_lower[xidx];
+            int x1 = std::min(x0 + 1, src.width - 1);
+            int wx = x_weight[xidx];
+
+            int upper = top[x0]    * (256 - wx) + top[x1]    * wx;
+            int lower = bottom[x0] * (256 - wx) + bottom[x1] * wx;
+            output[xidx] = static_cast<uint8_t>((upper * (256 - wy) + lower * wy + (1 << 15)) >> 16);
+        }
+
+        writeRow(dst, yidx, output.data());
+    }
+}
+
+/**
+ * @brief Copy a plane of the same dimensions (only changing the sample layout).
+ */
+static void copyPlane(PlaneSamples const& src, PlaneSamples const& dst) {
+    std::vector<uint8_t> scratch(src.width);
+    for (int yidx = 0; yidx < dst.height; yidx++) {
+        writeRow(dst, yidx, readRow(src, yidx, scratch));
+    }
+}
+
+/**
+ * @brief Nearest neighbour resampling of 16-bit depth (interpolating would invent depths between edges).
+ */
+static void scaleDepthNearest(uint8_t const* src, int src_linesize, int src_width, int src_height,
+                              uint8_t* dst, int dst_linesize, int dst_width, int dst_height) {
+    std::vector<int> columns(dst_width);
+    for (int xidx = 0; xidx < dst_width; xidx++) {
+        columns[xidx] = static_cast<int>((static_cast<int64_t>(xidx) * 2 + 1) * src_width / (2 * dst_width));
+    }
+
+    for (int yidx = 0; yidx < dst_height; yidx++) {
+        int row = static_cast<int>((static_cast<int64_t>(yidx) * 2 + 1) * src_height / (2 * dst_height));
+        uint16_t const* input = reinterpret_cast<uint16_t const*>(src + row * src_linesize);
+        uint16_t* output = reinterpret_cast<uint16_t*>(dst + yidx * dst_linesize);
+        for (int xidx = 0; xidx < dst_width; xidx++) {
+            output[xidx] = input[columns[xidx]];
+        }
+    }
+}
+
+
+/* ========================== Classes ========================== */
+void ImageView::scaleFrom(ImageView& view, ScaleFilter filter) {
+    if (view.format_ == PixelFormat::DEPTH16 && format_ == PixelFormat::DEPTH16) {
+        scaleDepthNearest(view.data_[0], view.linesize_[0], view.width_, view.height_, data_[0], linesize_[0], width_, height_);
+        return;
+    }
+
+    PlaneSamples src[3];
+    PlaneSamples dst[3];
+    if (!getPlanes(view, src) || !getPlanes(*this, dst)) {
+        LOGW("Scaling from format '%d' to '%d' is not supported!", static_cast<int>(view.format_), static_cast<int>(format_));
+        return;
+    }
+
+    /* Every plane is resampled on its own, which also converts between chroma subsamplings. */
+    for (int plane = 0; plane < 3; plane++) {
+        if (dst[plane].width <= 0 || dst[plane].height <= 0) {
+            continue;
+        }
+
+        if (src[plane].width == dst[plane].width && src[plane].height == dst[plane].height) {
+            copyPlane(src[plane], dst[plane]);
+            continue;
+        }
+
+        int fx = src[plane].width  / dst[plane].width;
+        int fy = src[plane].height / dst[plane].height;
+        bool exact = (fx * dst[plane].width == src[plane].width) && (fy * dst[plane].height == src[plane].height);
+
+        if (filter == ScaleFilter::BOX && exact && fx <= MAX_BOX_FACTOR && fy <= MAX_BOX_FACTOR) {
+            scaleBox(src[plane], dst[plane], fx, fy);
+        } else {
+            scaleBilinear(src[plane], dst[plane]);
+        }
+    }
+};
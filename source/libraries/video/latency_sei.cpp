@@ -0,0 +1,254 @@
+/**
+ * @file latency_sei.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Defines how frame timing information is embedded in, and extracted from, an H.264 (Annex B) bitstream.
+ * @link H.264 spec, 7.3.2.3 (SEI RBSP), D.1.6 (User data unregistered SEI message) & D.1.8 (Recovery point SEI message).
+ */
+
+/* ============================ Includes ============================ */
+#include "latency_sei.h"
+
+/* Standard C Libraries */
+#include <string.h>  // memcmp()
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ============================ Defines ============================= */
+#define NAL_TYPE_SLICE          1
+#define NAL_TYPE_IDR            5
+#define NAL_TYPE_SEI            6
+#define SEI_USER_DATA_UNREG     5
+#define SEI_RECOVERY_POINT      6
+#define LATENCY_PAYLOAD_VERSION 1
+
+/* Identifies our user data, among other (e.g. x264 version info) user data SEI's. */
+static const uint8_t LATENCY_UUID[16] = {
+    0x72, 0x63, 0x61, 0x2d, 0x6c, 0x61, 0x74, 0x65,  // "rca-late"
+    0x6e, 0x63, 0x79, 0x2d, 0x73, 0x65, 0x69, 0x31   // "ncy-sei1"
+};
+
+/* UUID + version + sequence + 4 timestamps. */
+static constexpr size_t LATENCY_PAYLOAD_SIZE = 16 + 1 + 4 + 4 * 8;
+
+
+/* ============================ Functions =========================== */
+static void writeBigEndian(std::vector<uint8_t> &buffer, uint64_t value, int bytes) {
+    for (int idx = bytes - 1; idx >= 0; idx--) {
+        buffer.push_back(static_cast<uint8_t>(value >> (idx * 8)));
+    }
+}
+
+static uint64_t readBigEndian(const uint8_t *data, int bytes) {
+    uint64_t value = 0;
+    for (int idx = 0; idx < bytes; idx++) {
+        value = (value << 8) | data[idx];
+    }
+    return value;
+}
+
+/**
+ * @brief Find the next 3-byte start code (00 00 01) at or after offset.
+ * @return The offset of the start code, or size if none.
+ */
+static size_t findStartCode(const uint8_t *data, size_t size, size_t offset) {
+    for (size_t idx = offset; idx + 2 < size; idx++) {
+        if (data[idx] == 0 && data[idx + 1] == 0 && data[idx + 2] == 1) {
+            return idx;
+        }
+    }
+    return size;
+}
+
+/**
+ * @brief Undo the emulation prevention of the NAL unit payload data[begin, end).
+ */
+static std::vector<uint8_t> unescape(const uint8_t *data, size_t begin, size_t end) {
+    std::vector<uint8_t> rbsp;
+    int zeros = 0;
+    for (size_t idx = begin; idx < end; idx++) {
+        if (zeros >= 2 && data[idx] == 0x03) {
+            zeros = 0;
+            continue;
+        }
+        rbsp.push_back(data[idx]);
+        zeros = (data[idx] == 0x00) ? zeros + 1 : 0;
+    }
+    return rbsp;
+}
+
+std::vector<uint8_t> buildLatencySEI(LatencyStamp const& stamp) {
+    /* SEI message (RBSP). */
+    std::vector<uint8_t> rbsp;
+    rbsp.push_back(SEI_USER_DATA_UNREG);   // payload type (< 255)
+    rbsp.push_back(LATENCY_PAYLOAD_SIZE);  // payload size (< 255)
+    rbsp.insert(rbsp.end(), LATENCY_UUID, LATENCY_UUID + sizeof(LATENCY_UUID));
+    rbsp.push_back(LATENCY_PAYLOAD_VERSION);
+    writeBigEndian(rbsp, stamp.sequence, 4);
+    writeBigEndian(rbsp, static_cast<uint64_t>(stamp.capture_us), 8);
+    writeBigEndian(rbsp, static_cast<uint64_t>(stamp.encode_start_us), 8);
+    writeBigEndian(rbsp, static_cast<uint64_t>(stamp.encode_end_us), 8);
+    writeBigEndian(rbsp, static_cast<uint64_t>(stamp.send_us), 8);
+    rbsp.push_back(0x80);  // rbsp trailing bits
+
+    /* NAL unit, with emulation prevention (no 00 00 0x sequences with x <= 3 in the payload). */
+    std::vector<uint8_t> nal = {0x00, 0x00, 0x00, 0x01, NAL_TYPE_SEI};
+    int zeros = 0;
+    for (uint8_t byte: rbsp) {
+        if (zeros >= 2 && byte <= 0x03) {
+            nal.push_back(0x03);
+            zeros = 0;
+        }
+        nal.push_back(byte);
+        zeros = (byte == 0x00) ? zeros + 1 : 0;
+    }
+
+    return nal;
+}
+
+size_t findLatencySEIPosition(const uint8_t *data, size_t size) {
+    size_t offset = findStartCode(data, size, 0);
+    while (offset < size) {
+        size_t header = offset + 3;
+        if (header < size) {
+            int nal_type = data[header] & 0x1F;
+            if (nal_type >= 1 && nal_type <= 5) { /* Coded slice. */
+                /* Include the leading zero of a 4-byte start code. */
+                return (offset > 0 && data[offset - 1] == 0) ? offset - 1 : offset;
+            }
+        }
+        offset = findStartCode(data, size, header);
+    }
+    return size;
+}
+
+bool extractLatencySEI(const uint8_t *data, size_t size, LatencyStamp &stamp) {
+    size_t offset = findStartCode(data, size, 0);
+    while (offset < size) {
+        size_t header = offset + 3;
+        size_t next = findStartCode(data, size, header);
+
+        if (header < size && (data[header] & 0x1F) == NAL_TYPE_SEI) {
+            std::vector<uint8_t> rbsp = unescape(data, header + 1, next);
+
+            /* Only look at the first SEI message of the NAL unit (that is how we write it). */
+            if (rbsp.size() >= 2 + LATENCY_PAYLOAD_SIZE && rbsp[0] == SEI_USER_DATA_UNREG && rbsp[1] == LATENCY_PAYLOAD_SIZE &&
+                memcmp(rbsp.data() + 2, LATENCY_UUID, sizeof(LATENCY_UUID)) == 0 && rbsp[18] == LATENCY_PAYLOAD_VERSION) {
+                const uint8_t *payload = rbsp.data() + 19;
+                stamp.sequence        = static_cast<uint32_t>(readBigEndian(payload, 4));
+                stamp.capture_us      = static_cast<int64_t>(readBigEndian(payload + 4, 8));
+                stamp.encode_start_us = static_cast<int64_t>(readBigEndian(payload + 12, 8));
+                stamp.encode_end_us   = static_cast<int64_t>(readBigEndian(payload + 20, 8));
+                stamp.send_us         = static_cast<int64_t>(readBigEndian(payload + 28, 8));
+                return true;
+            }
+        }
+
+        /* Slices follow the SEI, no need to scan through them. */
+        if (header < size) {
+            int nal_type = data[header] & 0x1F;
+            if (nal_type >= 1 && nal_type <= 5) {
+                return false;
+            }
+        }
+        offset = next;
+    }
+    return false;
+}
+
+bool isDisposableAccessUnit(const uint8_t *data, size_t size) {
+    bool has_slice = false;
+    size_t offset = findStartCode(data, size, 0);
+    while (offset < size) {
+        size_t header = offset + 3;
+        if (header < size) {
+            int nal_type = data[header] & 0x1F;
+            int nal_ref_idc = (data[header] >> 5) & 0x03;
+            if (nal_type >= NAL_TYPE_SLICE && nal_type <= NAL_TYPE_IDR) {
+                if (nal_ref_idc != 0) {
+                    return false;
+                }
+                has_slice = true;
+            }
+        }
+        offset = findStartCode(data, size, header);
+    }
+    return has_slice;
+}
+
+bool isRandomAccessPoint(const uint8_t *data, size_t size) {
+    size_t offset = findStartCode(data, size, 0);
+    while (offset < size) {
+        size_t header = offset + 3;
+        size_t next = findStartCode(data, size, header);
+        if (header >= size) {
+            break;
+        }
+
+        int nal_type = data[header] & 0x1F;
+        if (nal_type == NAL_TYPE_IDR) {
+            return true;
+        } else if (nal_type >= NAL_TYPE_SLICE && nal_type < NAL_TYPE_IDR) {
+            return false;  // The SEI's come before the slices.
+        } else if (nal_type == NAL_TYPE_SEI) {
+            /* Walk all SEI messages of the NAL unit (up to the rbsp trailing bits). */
+            std::vector<uint8_t> rbsp = unescape(data, header + 1, next);
+            size_t idx = 0;
+            while (idx < rbsp.size() && rbsp[idx] != 0x80) {
+                size_t payload_type = 0, payload_size = 0;
+                while (idx < rbsp.size() && rbsp[idx] == 0xFF) { payload_type += 0xFF; idx++; }
+                if (idx >= rbsp.size()) { break; }
+                payload_type += rbsp[idx++];
+                while (idx < rbsp.size() && rbsp[idx] == 0xFF) { payload_size += 0xFF; idx++; }
+                if (idx >= rbsp.size()) { break; }
+                payload_size += rbsp[idx++];
+
+                if (payload_type == SEI_RECOVERY_POINT) {
+                    return true;
+                }
+                idx += payload_size;
+            }
+        }
+        offset = next;
+    }
+    return false;
+}
+
+std::vector<size_t> splitSlices(const uint8_t *data, size_t size) {
+    std::vector<size_t> chunks = {0};
+    bool after_slice = false;
+    size_t offset = findStartCode(data, size, 0);
+    while (offset < size) {
+        size_t header = offset + 3;
+        if (after_slice) {
+            /* Include the leading zero of a 4-byte start code. */
+            chunks.push_back((offset > 0 && data[offset - 1] == 0) ? offset - 1 : offset);
+        }
+
+        int nal_type = (header < size) ? (data[header] & 0x1F) : 0;
+        after_slice = (nal_type >= NAL_TYPE_SLICE && nal_type <= NAL_TYPE_IDR);
+        offset = findStartCode(data, size, header);
+    }
+    return chunks;
+}
+
+bool isSliceContinuation(const uint8_t *data, size_t size) {
+    size_t offset = findStartCode(data, size, 0);
+    while (offset < size) {
+        size_t header = offset + 3;
+        if (header + 1 < size) {
+            int nal_type = data[header] & 0x1F;
+            if (nal_type >= NAL_TYPE_SLICE && nal_type <= NAL_TYPE_IDR) {
+                /* first_mb_in_slice is the first ue(v) of the slice header, which is 0 only if its first bit is set. */
+                return (data[header + 1] & 0x80) == 0;
+            }
+        }
+        offset = findStartCode(data, size, header);
+    }
+    return false;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file latency_sei.h
+ * @author Kevin Orbie
+ * 
+ * @brief Declares how frame timing information is embedded in, and extracted from, an H.264 (Annex B) bitstream.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Standard C++ Libraries */
+#include <vector>
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Timing of one frame on the transmitting side (all in common::micros() of the transmitter).
+ */
+struct LatencyStamp {
+    uint32_t sequence        = 0;
+    int64_t  capture_us      = 0;  // Frame captured.
+    int64_t  encode_start_us = 0;  // Frame handed to the encoder.
+    int64_t  encode_end_us   = 0;  // Packet recieved from the encoder.
+    int64_t  send_us         = 0;  // Packet handed to the muxer.
+};
+
+
+/* ========================== Functions ========================== */
+/**
+ * @brief Build a "user data unregistered" SEI NAL unit (including start code) holding the given stamp.
+ */
+std::vector<uint8_t> buildLatencySEI(LatencyStamp const& stamp);
+
+/**
+ * @brief Find the byte offset in an access unit, at which the latency SEI should be inserted (before the first slice).
+ * @return The offset of the start code of the first VCL NAL unit, or size if there is none.
+ */
+size_t findLatencySEIPosition(const uint8_t *data, size_t size);
+
+/**
+ * @brief Search an access unit for a latency SEI, and decode it.
+ * @return True if a stamp was found.
+ */
+bool extractLatencySEI(const uint8_t *data, size_t size, LatencyStamp &stamp);
+
+/**
+ * @brief Whether no other frame references this access unit (all its slices have nal_ref_idc 0), so it can be dropped.
+ */
+bool isDisposableAccessUnit(const uint8_t *data, size_t size);
+
+/**
+ * @brief Whether decoding can (re)start at this access unit: an IDR frame, or a recovery point (e.g. intra refresh).
+ */
+bool isRandomAccessPoint(const uint8_t *data, size_t size);
+
+/**
+ * @brief Split an access unit into one chunk per slice, e.g. to send every slice as soon as possible.
+ * @return The offset at which every chunk starts: the first chunk holds everything up to & including the first slice, 
+ * every next chunk the NAL units up to & including the next slice.
+ */
+std::vector<size_t> splitSlices(const uint8_t *data, size_t size);
+
+/**
+ * @brief Whether this chunk continues a frame, i.e. its first slice does not start at the first macroblock.
+ */
+bool isSliceContinuation(const uint8_t *data, size_t size);
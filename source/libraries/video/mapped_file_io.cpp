@@ -0,0 +1,120 @@
+/**
+ * @file mapped_file_io.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Implements a memory-mapped file input for libavformat (custom AVIOContext).
+ */
+
+/* ============================ Includes ============================ */
+#include "mapped_file_io.h"
+
+/* Standard C Libraries */
+#include <errno.h>
+#include <fcntl.h>     // open()
+#include <string.h>    // memcpy(), strerror()
+#include <unistd.h>    // close()
+#include <sys/mman.h>  // mmap(), madvise()
+#include <sys/stat.h>  // fstat()
+
+/* Standard C++ Libraries */
+#include <stdexcept>
+#include <algorithm>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+
+
+/* ============================ Classes ============================ */
+MappedFileIO::MappedFileIO(std::string const& filepath) {
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd == -1) {
+        LOGE("Failed to open '%s' (error %d: %s)", filepath.c_str(), errno, strerror(errno));
+        throw std::runtime_error("Failed to open file");
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1 || file_stat.st_size <= 0) {
+        LOGE("Failed to get the size of '%s'.", filepath.c_str());
+        close(fd);
+        throw std::runtime_error("Failed to get file size");
+    }
+    size_ = static_cast<size_t>(file_stat.st_size);
+
+    /* The mapping stays valid after closing the file descriptor. */
+    void *mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        LOGE("Failed to map '%s' (error %d: %s)", filepath.c_str(), errno, strerror(errno));
+        throw std::runtime_error("Failed to map file");
+    }
+    data_ = static_cast<uint8_t*>(mapping);
+
+    /* Only a hint, failure is not an issue.
+     * NOTE: No MADV_SEQUENTIAL, its early page reclaim evicts the pages that looping & seeking read again. */
+    madvise(data_, size_, MADV_WILLNEED);  // Start reading in the background now.
+
+    /* libavformat reads through its own buffer, which it owns (and may reallocate). */
+    uint8_t *buffer = static_cast<uint8_t*>(av_malloc(MAPPED_IO_BUFFER_SIZE));
+    if (!buffer) {
+        munmap(data_, size_);
+        LOGE("Failed to allocate the AVIOContext buffer.");
+        throw std::runtime_error("Failed to allocate the AVIOContext buffer");
+    }
+
+    ptr_io_context = avio_alloc_context(buffer, MAPPED_IO_BUFFER_SIZE, 0, this, &MappedFileIO::read, nullptr, &MappedFileIO::seek);
+    if (!ptr_io_context) {
+        av_free(buffer);
+        munmap(data_, size_);
+        LOGE("Failed to allocate the AVIOContext.");
+        throw std::runtime_error("Failed to allocate the AVIOContext");
+    }
+}
+
+MappedFileIO::~MappedFileIO() {
+    if (ptr_io_context) {
+        av_freep(&ptr_io_context->buffer);
+        avio_context_free(&ptr_io_context);
+    }
+    munmap(data_, size_);
+}
+
+bool MappedFileIO::isLocalFile(std::string const& filepath) {
+    /* URLs (e.g. "udp://...") use their own protocol. */
+    if (filepath.find("://") != std::string::npos) {
+        return false;
+    }
+
+    struct stat file_stat;
+    return stat(filepath.c_str(), &file_stat) == 0 && S_ISREG(file_stat.st_mode);
+}
+
+int MappedFileIO::read(void *opaque, uint8_t *buffer, int buffer_size) {
+    MappedFileIO *self = static_cast<MappedFileIO*>(opaque);
+    if (self->offset_ >= self->size_) {
+        return AVERROR_EOF;
+    }
+
+    size_t count = std::min(static_cast<size_t>(buffer_size), self->size_ - self->offset_);
+    memcpy(buffer, self->data_ + self->offset_, count);
+    self->offset_ += count;
+    return static_cast<int>(count);
+}
+
+int64_t MappedFileIO::seek(void *opaque, int64_t offset, int whence) {
+    MappedFileIO *self = static_cast<MappedFileIO*>(opaque);
+
+    int64_t position = 0;
+    switch (whence & ~AVSEEK_FORCE) {
+        case AVSEEK_SIZE: return static_cast<int64_t>(self->size_);
+        case SEEK_SET: position = offset; break;
+        case SEEK_CUR: position = static_cast<int64_t>(self->offset_) + offset; break;
+        case SEEK_END: position = static_cast<int64_t>(self->size_) + offset; break;
+        default: return AVERROR(EINVAL);
+    }
+
+    if (position < 0 || position > static_cast<int64_t>(self->size_)) {
+        return AVERROR(EINVAL);
+    }
+    self->offset_ = static_cast<size_t>(position);
+    return position;
+}
@@ -0,0 +1,75 @@
+/**
+ * @file mapped_file_io.h
+ * @author Kevin Orbie
+ *
+ * @brief Declares a memory-mapped file input for libavformat (custom AVIOContext).
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Standard C++ Libraries */
+#include <string>
+
+/* Third Party C++ Libraries */
+extern "C" { // ffmpeg
+#include <libavformat/avformat.h>
+}
+
+/* Custom C++ Libraries */
+// None
+
+
+/* ========================== Defines ========================== */
+#define MAPPED_IO_BUFFER_SIZE (1 << 20)  // Bytes libavformat reads at once (the default file protocol uses 32 KiB).
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Serves a local file to libavformat from a read-only memory mapping.
+ *
+ * @details The whole file is mapped once and advised as needed soon (MADV_WILLNEED), so the kernel starts
+ * reading it in the background, and reads (including the repeated probing / seeking during open) are plain
+ * memory copies instead of system calls.
+ *
+ * @example {@code
+ *  MappedFileIO io = MappedFileIO(path);
+ *  format_context->pb = io.context();
+ *  format_context->flags |= AVFMT_FLAG_CUSTOM_IO;
+ *  avformat_open_input(&format_context, path, NULL, NULL);
+ * }
+ */
+class MappedFileIO final {
+   public:
+    MappedFileIO(std::string const& filepath);
+    ~MappedFileIO();
+
+    /* Owns the mapping & the AVIOContext, which can't be shared. */
+    MappedFileIO(const MappedFileIO& other)            = delete;
+    MappedFileIO& operator=(const MappedFileIO& other) = delete;
+
+    /**
+     * @brief The context to hand to libavformat (only valid as long as this object exists).
+     */
+    AVIOContext* context() { return ptr_io_context; };
+
+    /**
+     * @brief Whether the given input refers to a regular local file (and not e.g. a network stream).
+     */
+    static bool isLocalFile(std::string const& filepath);
+
+   private:
+    static int read(void *opaque, uint8_t *buffer, int buffer_size);
+    static int64_t seek(void *opaque, int64_t offset, int whence);
+
+   private:
+    uint8_t *data_   = nullptr;  // Mapped file.
+    size_t   size_   = 0;
+    size_t   offset_ = 0;        // Read position.
+
+    AVIOContext *ptr_io_context = nullptr;
+};
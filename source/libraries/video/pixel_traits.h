@@ -0,0 +1,72 @@
+/**
+ * @file pixel_traits.h
+ * @author Kevin Orbie
+ *
+ * @brief Compile time description of every PixelFormat's memory layout.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+// None
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+#include "image.h"
+
+
+/* ========================== Defines ========================== */
+constexpr int PIXEL_FORMAT_COUNT = static_cast<int>(PixelFormat::NV12) + 1;  // NOTE: NV12 must stay the last format.
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Layout shared by all formats, see the PixelTraits specializations below.
+ *
+ * @tparam Planes: Number of planes.
+ * @tparam BytesPerPixel: Bytes per pixel of the first plane (e.g. 2 for YUYV, 1 for the Y plane of planar formats).
+ * @tparam ShiftX & ShiftY: Chroma subsampling, as log2 of the number of pixels per chroma sample.
+ */
+template<int Planes, int BytesPerPixel, int ShiftX, int ShiftY, bool Chroma, bool RGB>
+struct PixelTraitsBase {
+    static constexpr int  num_planes      = Planes;
+    static constexpr int  bytes_per_pixel = BytesPerPixel;
+    static constexpr int  chroma_shift_x  = ShiftX;
+    static constexpr int  chroma_shift_y  = ShiftY;
+    static constexpr bool has_chroma      = Chroma;  // YUV formats.
+    static constexpr bool is_rgb          = RGB;     // Packed RGB(A), bytes_per_pixel is the number of channels.
+
+    /**
+     * @brief Number of bytes in one row of the given plane (without padding).
+     */
+    static constexpr int rowBytes(int plane, int width) {
+        int chroma_width = (width + (1 << ShiftX) - 1) >> ShiftX;
+        if (plane == 0) {
+            /* Packed formats store whole chroma groups (e.g. YUYV pairs). */
+            return (Planes == 1 && ShiftX > 0) ? chroma_width * (BytesPerPixel << ShiftX) : width * BytesPerPixel;
+        }
+        return (Planes == 2) ? chroma_width * 2 : chroma_width;  // Interleaved UV pairs, or one U / V plane.
+    };
+
+    /**
+     * @brief Number of rows in the given plane.
+     */
+    static constexpr int rowCount(int plane, int height) {
+        return (plane == 0) ? height : (height + (1 << ShiftY) - 1) >> ShiftY;
+    };
+};
+
+template<PixelFormat Format> struct PixelTraits;
+template<> struct PixelTraits<PixelFormat::EMPTY>:   PixelTraitsBase<0, 0, 0, 0, false, false> {};
+template<> struct PixelTraits<PixelFormat::YUV>:     PixelTraitsBase<1, 3, 0, 0, true,  false> {};
+template<> struct PixelTraits<PixelFormat::YUV420P>: PixelTraitsBase<3, 1, 1, 1, true,  false> {};
+template<> struct PixelTraits<PixelFormat::YUV422>:  PixelTraitsBase<1, 2, 1, 0, true,  false> {};
+template<> struct PixelTraits<PixelFormat::YUV422P>: PixelTraitsBase<3, 1, 1, 0, true,  false> {};
+template<> struct PixelTraits<PixelFormat::GREY>:    PixelTraitsBase<1, 1, 0, 0, false, false> {};
+template<> struct PixelTraits<PixelFormat::DEPTH16>: PixelTraitsBase<1, 2, 0, 0, false, false> {};
+template<> struct PixelTraits<PixelFormat::RGB24>:   PixelTraitsBase<1, 3, 0, 0, false, true > {};
+template<> struct PixelTraits<PixelFormat::RGBA>:    PixelTraitsBase<1, 4, 0, 0, false, true > {};
+template<> struct PixelTraits<PixelFormat::NV12>:    PixelTraitsBase<2, 1, 1, 1, true,  false> {};
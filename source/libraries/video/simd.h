@@ -0,0 +1,613 @@
+/**
+ * @file simd.h
+ * @author Kevin Orbie
+ *
+ * @brief Vectorized image row kernels (SSE2 on x86, NEON on ARM, with a scalar fallback).
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+#include <string.h>  // memcpy()
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+// None
+
+/* Platform Intrinsics */
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+
+/* ========================== Functions ========================== */
+namespace simd {
+
+/**
+ * @brief Rounded average of every 2x2 block: dst[x] = (row0[2x] + row0[2x+1] + row1[2x] + row1[2x+1] + 2) / 4.
+ *
+ * @param row0 & row1: Two consecutive (unit stride) source rows, of at least 2 * width bytes.
+ * @param width: Number of output pixels.
+ */
+inline void average2x2(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int width) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 output pixels / iteration. */
+    const __m128i low_mask = _mm_set1_epi16(0x00FF);
+    const __m128i rounding = _mm_set1_epi16(2);
+    for (; xidx + 16 <= width; xidx += 16) {
+        __m128i sums[2];
+        for (int half = 0; half < 2; half++) {
+            __m128i top    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * xidx + 16 * half));
+            __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * xidx + 16 * half));
+
+            /* Even + uneven bytes, as 16-bit lanes. */
+            __m128i top_pairs    = _mm_add_epi16(_mm_and_si128(top, low_mask), _mm_srli_epi16(top, 8));
+            __m128i bottom_pairs = _mm_add_epi16(_mm_and_si128(bottom, low_mask), _mm_srli_epi16(bottom, 8));
+            sums[half] = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(top_pairs, bottom_pairs), rounding), 2);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + xidx), _mm_packus_epi16(sums[0], sums[1]));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 output pixels / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        uint8x8_t averages[2];
+        for (int half = 0; half < 2; half++) {
+            uint16x8_t sum = vpaddlq_u8(vld1q_u8(row0 + 2 * xidx + 16 * half));
+            sum = vpadalq_u8(sum, vld1q_u8(row1 + 2 * xidx + 16 * half));
+            averages[half] = vrshrn_n_u16(sum, 2);
+        }
+        vst1q_u8(dst + xidx, vcombine_u8(averages[0], averages[1]));
+    }
+#endif
+
+    /* Remaining pixels. */
+    for (; xidx < width; xidx++) {
+        int sum = row0[2 * xidx] + row0[2 * xidx + 1] + row1[2 * xidx] + row1[2 * xidx + 1];
+        dst[xidx] = static_cast<uint8_t>((sum + 2) >> 2);
+    }
+}
+
+/**
+ * @brief Rounded average of every 4x4 block: dst[x] = (sum of rows[0..3][4x .. 4x+3] + 8) / 16.
+ *
+ * @param rows: Four consecutive (unit stride) source rows, of at least 4 * width bytes.
+ * @param width: Number of output pixels.
+ */
+inline void average4x4(const uint8_t* const rows[4], uint8_t* dst, int width) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 output pixels / iteration. */
+    const __m128i low_mask = _mm_set1_epi16(0x00FF);
+    const __m128i ones     = _mm_set1_epi16(1);
+    const __m128i rounding = _mm_set1_epi16(8);
+    for (; xidx + 16 <= width; xidx += 16) {
+        __m128i quads[4];
+        for (int chunk = 0; chunk < 4; chunk++) {
+            /* Sum the horizontal pairs of all 4 rows. */
+            __m128i pairs = _mm_setzero_si128();
+            for (int row = 0; row < 4; row++) {
+                __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[row] + 4 * xidx + 16 * chunk));
+                pairs = _mm_add_epi16(pairs, _mm_add_epi16(_mm_and_si128(data, low_mask), _mm_srli_epi16(data, 8)));
+            }
+            quads[chunk] = _mm_madd_epi16(pairs, ones);  // Neighbouring pairs, as 32-bit lanes.
+        }
+        __m128i low  = _mm_srli_epi16(_mm_add_epi16(_mm_packs_epi32(quads[0], quads[1]), rounding), 4);
+        __m128i high = _mm_srli_epi16(_mm_add_epi16(_mm_packs_epi32(quads[2], quads[3]), rounding), 4);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + xidx), _mm_packus_epi16(low, high));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 output pixels / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        uint16x4_t quads[4];
+        for (int chunk = 0; chunk < 4; chunk++) {
+            /* Sum the horizontal pairs of all 4 rows, then neighbouring pairs. */
+            uint16x8_t pairs = vpaddlq_u8(vld1q_u8(rows[0] + 4 * xidx + 16 * chunk));
+            for (int row = 1; row < 4; row++) {
+                pairs = vpadalq_u8(pairs, vld1q_u8(rows[row] + 4 * xidx + 16 * chunk));
+            }
+            quads[chunk] = vpadd_u16(vget_low_u16(pairs), vget_high_u16(pairs));
+        }
+        uint8x8_t low  = vrshrn_n_u16(vcombine_u16(quads[0], quads[1]), 4);
+        uint8x8_t high = vrshrn_n_u16(vcombine_u16(quads[2], quads[3]), 4);
+        vst1q_u8(dst + xidx, vcombine_u8(low, high));
+    }
+#endif
+
+    /* Remaining pixels. */
+    for (; xidx < width; xidx++) {
+        int sum = 0;
+        for (int row = 0; row < 4; row++) {
+            sum += rows[row][4 * xidx] + rows[row][4 * xidx + 1] + rows[row][4 * xidx + 2] + rows[row][4 * xidx + 3];
+        }
+        dst[xidx] = static_cast<uint8_t>((sum + 8) >> 4);
+    }
+}
+
+/**
+ * @brief Split two YUYV rows into two Y rows, and one U & V row averaged over both (4:2:2 to 4:2:0).
+ *
+ * @param row0 & row1: Two consecutive YUYV rows, of at least 2 * width bytes.
+ * @param width: Number of pixels (the chroma rows get (width + 1) / 2 samples).
+ */
+inline void deinterleaveYUYV420(const uint8_t* row0, const uint8_t* row1, uint8_t* y0, uint8_t* y1, uint8_t* u, uint8_t* v, int width) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 pixels / iteration. */
+    const __m128i low_mask = _mm_set1_epi16(0x00FF);
+    for (; xidx + 16 <= width; xidx += 16) {
+        __m128i top_a    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * xidx));
+        __m128i top_b    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + 2 * xidx + 16));
+        __m128i bottom_a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * xidx));
+        __m128i bottom_b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + 2 * xidx + 16));
+
+        /* Luma: the even bytes. */
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + xidx), _mm_packus_epi16(_mm_and_si128(top_a, low_mask), _mm_and_si128(top_b, low_mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + xidx), _mm_packus_epi16(_mm_and_si128(bottom_a, low_mask), _mm_and_si128(bottom_b, low_mask)));
+
+        /* Chroma: the uneven bytes (UVUV...), rounded average of both rows. */
+        __m128i chroma_a = _mm_avg_epu16(_mm_srli_epi16(top_a, 8), _mm_srli_epi16(bottom_a, 8));
+        __m128i chroma_b = _mm_avg_epu16(_mm_srli_epi16(top_b, 8), _mm_srli_epi16(bottom_b, 8));
+        __m128i chroma   = _mm_packus_epi16(chroma_a, chroma_b);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u + xidx / 2), _mm_packus_epi16(_mm_and_si128(chroma, low_mask), _mm_setzero_si128()));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v + xidx / 2), _mm_packus_epi16(_mm_srli_epi16(chroma, 8), _mm_setzero_si128()));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 32 pixels / iteration. */
+    for (; xidx + 32 <= width; xidx += 32) {
+        uint8x16x4_t top    = vld4q_u8(row0 + 2 * xidx);  // Y0, U, Y1, V
+        uint8x16x4_t bottom = vld4q_u8(row1 + 2 * xidx);
+
+        vst2q_u8(y0 + xidx, (uint8x16x2_t){{top.val[0], top.val[2]}});
+        vst2q_u8(y1 + xidx, (uint8x16x2_t){{bottom.val[0], bottom.val[2]}});
+        vst1q_u8(u + xidx / 2, vrhaddq_u8(top.val[1], bottom.val[1]));
+        vst1q_u8(v + xidx / 2, vrhaddq_u8(top.val[3], bottom.val[3]));
+    }
+#endif
+
+    /* Remaining pixels. */
+    for (; xidx < width; xidx += 2) {
+        y0[xidx] = row0[2 * xidx];
+        y1[xidx] = row1[2 * xidx];
+        if (xidx + 1 < width) {
+            y0[xidx + 1] = row0[2 * xidx + 2];
+            y1[xidx + 1] = row1[2 * xidx + 2];
+        }
+        u[xidx / 2] = static_cast<uint8_t>((row0[2 * xidx + 1] + row1[2 * xidx + 1] + 1) >> 1);
+        v[xidx / 2] = static_cast<uint8_t>((row0[2 * xidx + 3] + row1[2 * xidx + 3] + 1) >> 1);
+    }
+}
+
+/**
+ * @brief Interleave one Y row with its (horizontally subsampled) U & V rows into packed YUV (4:4:4).
+ *
+ * @param width: Number of pixels (the chroma rows hold (width + 1) / 2 samples).
+ */
+inline void interleaveYUV(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width) {
+    int xidx = 0;
+
+#if defined(__ARM_NEON)
+    /* 16 pixels / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        uint8x8_t u_half = vld1_u8(u + xidx / 2);
+        uint8x8_t v_half = vld1_u8(v + xidx / 2);
+
+        uint8x16x3_t yuv;
+        yuv.val[0] = vld1q_u8(y + xidx);
+        yuv.val[1] = vcombine_u8(vzip_u8(u_half, u_half).val[0], vzip_u8(u_half, u_half).val[1]);
+        yuv.val[2] = vcombine_u8(vzip_u8(v_half, v_half).val[0], vzip_u8(v_half, v_half).val[1]);
+        vst3q_u8(dst + 3 * xidx, yuv);
+    }
+#endif
+
+    /* Remaining pixels (plain SSE2 has no cheap 3-way interleave, the compiler does best here). */
+    for (; xidx < width; xidx++) {
+        dst[3 * xidx + 0] = y[xidx];
+        dst[3 * xidx + 1] = u[xidx >> 1];
+        dst[3 * xidx + 2] = v[xidx >> 1];
+    }
+}
+
+/**
+ * @brief Copy every even byte (e.g. the luma of a YUYV row).
+ *
+ * @param src: Row of at least 2 * width - 1 bytes.
+ * @param width: Number of output bytes.
+ */
+inline void extractEven(const uint8_t* src, uint8_t* dst, int width) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 bytes / iteration. */
+    const __m128i low_mask = _mm_set1_epi16(0x00FF);
+    for (; xidx + 16 <= width; xidx += 16) {
+        __m128i first  = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * xidx)), low_mask);
+        __m128i second = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * xidx + 16)), low_mask);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + xidx), _mm_packus_epi16(first, second));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 bytes / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        vst1q_u8(dst + xidx, vld2q_u8(src + 2 * xidx).val[0]);
+    }
+#endif
+
+    /* Remaining bytes. */
+    for (; xidx < width; xidx++) {
+        dst[xidx] = src[2 * xidx];
+    }
+}
+
+/**
+ * @brief Split interleaved pairs (e.g. the UVUV... plane of NV12) into two rows.
+ *
+ * @param count: Number of pairs.
+ */
+inline void deinterleavePairs(const uint8_t* src, uint8_t* first, uint8_t* second, int count) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 pairs / iteration. */
+    const __m128i low_mask = _mm_set1_epi16(0x00FF);
+    for (; xidx + 16 <= count; xidx += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * xidx));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 2 * xidx + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(first + xidx),  _mm_packus_epi16(_mm_and_si128(a, low_mask), _mm_and_si128(b, low_mask)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(second + xidx), _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8)));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 pairs / iteration. */
+    for (; xidx + 16 <= count; xidx += 16) {
+        uint8x16x2_t pairs = vld2q_u8(src + 2 * xidx);
+        vst1q_u8(first + xidx, pairs.val[0]);
+        vst1q_u8(second + xidx, pairs.val[1]);
+    }
+#endif
+
+    /* Remaining pairs. */
+    for (; xidx < count; xidx++) {
+        first[xidx]  = src[2 * xidx];
+        second[xidx] = src[2 * xidx + 1];
+    }
+}
+
+/**
+ * @brief Interleave two rows into pairs (e.g. U & V into the UVUV... plane of NV12).
+ *
+ * @param count: Number of pairs.
+ */
+inline void interleavePairs(const uint8_t* first, const uint8_t* second, uint8_t* dst, int count) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 pairs / iteration. */
+    for (; xidx + 16 <= count; xidx += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(first + xidx));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(second + xidx));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * xidx),      _mm_unpacklo_epi8(a, b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * xidx + 16), _mm_unpackhi_epi8(a, b));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 pairs / iteration. */
+    for (; xidx + 16 <= count; xidx += 16) {
+        vst2q_u8(dst + 2 * xidx, (uint8x16x2_t){{vld1q_u8(first + xidx), vld1q_u8(second + xidx)}});
+    }
+#endif
+
+    /* Remaining pairs. */
+    for (; xidx < count; xidx++) {
+        dst[2 * xidx]     = first[xidx];
+        dst[2 * xidx + 1] = second[xidx];
+    }
+}
+
+/**
+ * @brief Rounded average of two rows: dst[x] = (row0[x] + row1[x] + 1) / 2.
+ */
+inline void averageRows(const uint8_t* row0, const uint8_t* row1, uint8_t* dst, int width) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 bytes / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        __m128i top    = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + xidx));
+        __m128i bottom = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + xidx));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + xidx), _mm_avg_epu8(top, bottom));
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 bytes / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        vst1q_u8(dst + xidx, vrhaddq_u8(vld1q_u8(row0 + xidx), vld1q_u8(row1 + xidx)));
+    }
+#endif
+
+    /* Remaining bytes. */
+    for (; xidx < width; xidx++) {
+        dst[xidx] = static_cast<uint8_t>((row0[xidx] + row1[xidx] + 1) >> 1);
+    }
+}
+
+/**
+ * @brief Limited range YUV to RGB matrix, in 6-bit fixed point (e.g. R = (y * (Y - 16) + rv * (V - 128) + 32) >> 6).
+ * @note 6 bits keep every product within 16-bit lanes, overflows only happen past white (and saturate).
+ */
+struct YUVToRGBCoefficients {
+    int16_t y, rv, gu, gv, bu;
+};
+
+/**
+ * @brief RGB to YUV matrix, in 8-bit fixed point (e.g. Y = ((y[0] * R + y[1] * G + y[2] * B + 128) >> 8) + offset).
+ */
+struct RGBToYUVCoefficients {
+    int16_t y[3];
+    int16_t u[3];
+    int16_t v[3];
+    uint8_t y_offset;  // 16 for limited range luma, 0 for full range (e.g. GREY).
+};
+
+/**
+ * @brief Convert one Y row, with its (horizontally subsampled) U & V rows, to packed RGB (channels = 3) or RGBA (channels = 4, opaque).
+ *
+ * @param width: Number of pixels (the chroma rows hold (width + 1) / 2 samples).
+ */
+inline void yuvToRGB(const uint8_t* y, const uint8_t* u, const uint8_t* v, uint8_t* dst, int width, int channels, YUVToRGBCoefficients const& m) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 pixels / iteration. */
+    const __m128i zero     = _mm_setzero_si128();
+    const __m128i luma_off = _mm_set1_epi16(16);
+    const __m128i chroma_off = _mm_set1_epi16(128);
+    const __m128i rounding = _mm_set1_epi16(32);
+    const __m128i alpha    = _mm_set1_epi8(static_cast<char>(0xFF));
+    const __m128i y_coef = _mm_set1_epi16(m.y),  rv_coef = _mm_set1_epi16(m.rv);
+    const __m128i gu_coef = _mm_set1_epi16(m.gu), gv_coef = _mm_set1_epi16(m.gv), bu_coef = _mm_set1_epi16(m.bu);
+    for (; xidx + 16 <= width; xidx += 16) {
+        __m128i luma = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + xidx));
+        __m128i d = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + xidx / 2)), zero), chroma_off);
+        __m128i e = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + xidx / 2)), zero), chroma_off);
+
+        /* Every chroma sample covers two pixels. */
+        __m128i ds[2] = {_mm_unpacklo_epi16(d, d), _mm_unpackhi_epi16(d, d)};
+        __m128i es[2] = {_mm_unpacklo_epi16(e, e), _mm_unpackhi_epi16(e, e)};
+        __m128i cs[2] = {_mm_sub_epi16(_mm_unpacklo_epi8(luma, zero), luma_off), _mm_sub_epi16(_mm_unpackhi_epi8(luma, zero), luma_off)};
+
+        __m128i rgb[3][2];
+        for (int half = 0; half < 2; half++) {
+            __m128i base = _mm_adds_epi16(_mm_mullo_epi16(cs[half], y_coef), rounding);
+            rgb[0][half] = _mm_srai_epi16(_mm_adds_epi16(base, _mm_mullo_epi16(es[half], rv_coef)), 6);
+            rgb[1][half] = _mm_srai_epi16(_mm_subs_epi16(_mm_subs_epi16(base, _mm_mullo_epi16(ds[half], gu_coef)), _mm_mullo_epi16(es[half], gv_coef)), 6);
+            rgb[2][half] = _mm_srai_epi16(_mm_adds_epi16(base, _mm_mullo_epi16(ds[half], bu_coef)), 6);
+        }
+        __m128i r = _mm_packus_epi16(rgb[0][0], rgb[0][1]);
+        __m128i g = _mm_packus_epi16(rgb[1][0], rgb[1][1]);
+        __m128i b = _mm_packus_epi16(rgb[2][0], rgb[2][1]);
+
+        if (channels == 4) {
+            __m128i rg_low = _mm_unpacklo_epi8(r, g), rg_high = _mm_unpackhi_epi8(r, g);
+            __m128i ba_low = _mm_unpacklo_epi8(b, alpha), ba_high = _mm_unpackhi_epi8(b, alpha);
+            uint8_t* out = dst + 4 * xidx;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out +  0), _mm_unpacklo_epi16(rg_low, ba_low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi16(rg_low, ba_low));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), _mm_unpacklo_epi16(rg_high, ba_high));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 48), _mm_unpackhi_epi16(rg_high, ba_high));
+        } else {
+            /* Plain SSE2 has no cheap 3-way interleave, the compiler does best here. */
+            alignas(16) uint8_t planes[3][16];
+            _mm_store_si128(reinterpret_cast<__m128i*>(planes[0]), r);
+            _mm_store_si128(reinterpret_cast<__m128i*>(planes[1]), g);
+            _mm_store_si128(reinterpret_cast<__m128i*>(planes[2]), b);
+            for (int pixel = 0; pixel < 16; pixel++) {
+                dst[3 * (xidx + pixel) + 0] = planes[0][pixel];
+                dst[3 * (xidx + pixel) + 1] = planes[1][pixel];
+                dst[3 * (xidx + pixel) + 2] = planes[2][pixel];
+            }
+        }
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 pixels / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        uint8x16_t luma = vld1q_u8(y + xidx);
+        int16x8_t d = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(u + xidx / 2))), vdupq_n_s16(128));
+        int16x8_t e = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vld1_u8(v + xidx / 2))), vdupq_n_s16(128));
+
+        /* Every chroma sample covers two pixels. */
+        int16x8x2_t ds = vzipq_s16(d, d);
+        int16x8x2_t es = vzipq_s16(e, e);
+        int16x8_t cs[2] = {
+            vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(luma))),  vdupq_n_s16(16)),
+            vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(luma))), vdupq_n_s16(16))
+        };
+
+        uint8x8_t rgb[3][2];
+        for (int half = 0; half < 2; half++) {
+            int16x8_t base = vmulq_n_s16(cs[half], m.y);
+            rgb[0][half] = vqrshrun_n_s16(vqaddq_s16(base, vmulq_n_s16(es.val[half], m.rv)), 6);
+            rgb[1][half] = vqrshrun_n_s16(vqsubq_s16(vqsubq_s16(base, vmulq_n_s16(ds.val[half], m.gu)), vmulq_n_s16(es.val[half], m.gv)), 6);
+            rgb[2][half] = vqrshrun_n_s16(vqaddq_s16(base, vmulq_n_s16(ds.val[half], m.bu)), 6);
+        }
+
+        if (channels == 4) {
+            uint8x16x4_t rgba = {{vcombine_u8(rgb[0][0], rgb[0][1]), vcombine_u8(rgb[1][0], rgb[1][1]), vcombine_u8(rgb[2][0], rgb[2][1]), vdupq_n_u8(0xFF)}};
+            vst4q_u8(dst + 4 * xidx, rgba);
+        } else {
+            uint8x16x3_t rgb24 = {{vcombine_u8(rgb[0][0], rgb[0][1]), vcombine_u8(rgb[1][0], rgb[1][1]), vcombine_u8(rgb[2][0], rgb[2][1])}};
+            vst3q_u8(dst + 3 * xidx, rgb24);
+        }
+    }
+#endif
+
+    /* Remaining pixels. */
+    for (; xidx < width; xidx++) {
+        int c = y[xidx] - 16;
+        int d = u[xidx >> 1] - 128;
+        int e = v[xidx >> 1] - 128;
+        int base = m.y * c + 32;
+        int r = (base + m.rv * e) >> 6;
+        int g = (base - m.gu * d - m.gv * e) >> 6;
+        int b = (base + m.bu * d) >> 6;
+        uint8_t* out = dst + channels * xidx;
+        out[0] = static_cast<uint8_t>(r < 0 ? 0 : (r > 255 ? 255 : r));
+        out[1] = static_cast<uint8_t>(g < 0 ? 0 : (g > 255 ? 255 : g));
+        out[2] = static_cast<uint8_t>(b < 0 ? 0 : (b > 255 ? 255 : b));
+        if (channels == 4) {
+            out[3] = 0xFF;
+        }
+    }
+}
+
+/**
+ * @brief Luma of every pixel of a packed RGB (channels = 3) or RGBA (channels = 4) row.
+ */
+inline void rgbToLuma(const uint8_t* rgb, int channels, uint8_t* y, int width, RGBToYUVCoefficients const& m) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* RGBA only, 8 pixels / iteration (unsigned 16-bit sums, the weights add up to at most 256). */
+    if (channels == 4) {
+        const __m128i byte_mask = _mm_set1_epi32(0xFF);
+        const __m128i rounding  = _mm_set1_epi16(128);
+        const __m128i offset    = _mm_set1_epi16(m.y_offset);
+        for (; xidx + 8 <= width; xidx += 8) {
+            __m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 4 * xidx));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rgb + 4 * xidx + 16));
+            __m128i r = _mm_packs_epi32(_mm_and_si128(first, byte_mask), _mm_and_si128(second, byte_mask));
+            __m128i g = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(first, 8), byte_mask), _mm_and_si128(_mm_srli_epi32(second, 8), byte_mask));
+            __m128i b = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(first, 16), byte_mask), _mm_and_si128(_mm_srli_epi32(second, 16), byte_mask));
+
+            __m128i sum = _mm_add_epi16(_mm_mullo_epi16(r, _mm_set1_epi16(m.y[0])), _mm_mullo_epi16(g, _mm_set1_epi16(m.y[1])));
+            sum = _mm_add_epi16(_mm_add_epi16(sum, _mm_mullo_epi16(b, _mm_set1_epi16(m.y[2]))), rounding);
+            __m128i luma = _mm_add_epi16(_mm_srli_epi16(sum, 8), offset);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(y + xidx), _mm_packus_epi16(luma, luma));
+        }
+    }
+
+#elif defined(__ARM_NEON)
+    /* 16 pixels / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        uint8x16_t r, g, b;
+        if (channels == 4) {
+            uint8x16x4_t pixels = vld4q_u8(rgb + 4 * xidx);
+            r = pixels.val[0]; g = pixels.val[1]; b = pixels.val[2];
+        } else {
+            uint8x16x3_t pixels = vld3q_u8(rgb + 3 * xidx);
+            r = pixels.val[0]; g = pixels.val[1]; b = pixels.val[2];
+        }
+
+        uint8x8_t luma[2];
+        for (int half = 0; half < 2; half++) {
+            uint8x8_t rh = half ? vget_high_u8(r) : vget_low_u8(r);
+            uint8x8_t gh = half ? vget_high_u8(g) : vget_low_u8(g);
+            uint8x8_t bh = half ? vget_high_u8(b) : vget_low_u8(b);
+            uint16x8_t sum = vmull_u8(rh, vdup_n_u8(static_cast<uint8_t>(m.y[0])));
+            sum = vmlal_u8(sum, gh, vdup_n_u8(static_cast<uint8_t>(m.y[1])));
+            sum = vmlal_u8(sum, bh, vdup_n_u8(static_cast<uint8_t>(m.y[2])));
+            luma[half] = vadd_u8(vrshrn_n_u16(sum, 8), vdup_n_u8(m.y_offset));
+        }
+        vst1q_u8(y + xidx, vcombine_u8(luma[0], luma[1]));
+    }
+#endif
+
+    /* Remaining pixels. */
+    for (; xidx < width; xidx++) {
+        const uint8_t* pixel = rgb + channels * xidx;
+        y[xidx] = static_cast<uint8_t>(((m.y[0] * pixel[0] + m.y[1] * pixel[1] + m.y[2] * pixel[2] + 128) >> 8) + m.y_offset);
+    }
+}
+
+/**
+ * @brief Chroma of every horizontal pixel pair (averaged) of a packed RGB (channels = 3) or RGBA (channels = 4) row.
+ *
+ * @param width: Number of pixels (the chroma rows get (width + 1) / 2 samples).
+ */
+inline void rgbToChroma(const uint8_t* rgb, int channels, uint8_t* u, uint8_t* v, int width, RGBToYUVCoefficients const& m) {
+    int xidx = 0;
+
+#if defined(__ARM_NEON)
+    /* 16 pixels / iteration. */
+    for (; xidx + 16 <= width; xidx += 16) {
+        uint8x16_t r, g, b;
+        if (channels == 4) {
+            uint8x16x4_t pixels = vld4q_u8(rgb + 4 * xidx);
+            r = pixels.val[0]; g = pixels.val[1]; b = pixels.val[2];
+        } else {
+            uint8x16x3_t pixels = vld3q_u8(rgb + 3 * xidx);
+            r = pixels.val[0]; g = pixels.val[1]; b = pixels.val[2];
+        }
+
+        /* Rounded average of the pairs. */
+        int16x8_t rs = vreinterpretq_s16_u16(vrshrq_n_u16(vpaddlq_u8(r), 1));
+        int16x8_t gs = vreinterpretq_s16_u16(vrshrq_n_u16(vpaddlq_u8(g), 1));
+        int16x8_t bs = vreinterpretq_s16_u16(vrshrq_n_u16(vpaddlq_u8(b), 1));
+
+        int16x8_t us = vmlaq_n_s16(vmlaq_n_s16(vmulq_n_s16(rs, m.u[0]), gs, m.u[1]), bs, m.u[2]);
+        int16x8_t vs = vmlaq_n_s16(vmlaq_n_s16(vmulq_n_s16(rs, m.v[0]), gs, m.v[1]), bs, m.v[2]);
+        vst1_u8(u + xidx / 2, vmovn_u16(vreinterpretq_u16_s16(vaddq_s16(vrshrq_n_s16(us, 8), vdupq_n_s16(128)))));
+        vst1_u8(v + xidx / 2, vmovn_u16(vreinterpretq_u16_s16(vaddq_s16(vrshrq_n_s16(vs, 8), vdupq_n_s16(128)))));
+    }
+#endif
+
+    /* Remaining pixel pairs (on SSE2, the compiler does best here). */
+    for (; xidx < width; xidx += 2) {
+        const uint8_t* first  = rgb + channels * xidx;
+        const uint8_t* second = (xidx + 1 < width) ? first + channels : first;
+        int r = (first[0] + second[0] + 1) >> 1;
+        int g = (first[1] + second[1] + 1) >> 1;
+        int b = (first[2] + second[2] + 1) >> 1;
+        u[xidx / 2] = static_cast<uint8_t>(((m.u[0] * r + m.u[1] * g + m.u[2] * b + 128) >> 8) + 128);
+        v[xidx / 2] = static_cast<uint8_t>(((m.v[0] * r + m.v[1] * g + m.v[2] * b + 128) >> 8) + 128);
+    }
+}
+
+/**
+ * @brief Fill count 4-byte groups with the same (little-endian) pattern, e.g. YUYV pairs, RGBA pixels or DEPTH16 pairs.
+ *
+ * @param dst: Destination of at least 4 * count bytes (no alignment required).
+ */
+inline void fill32(uint8_t* dst, uint32_t pattern, int count) {
+    int xidx = 0;
+
+#if defined(__SSE2__)
+    /* 16 groups / iteration. */
+    __m128i value = _mm_set1_epi32(static_cast<int>(pattern));
+    for (; xidx + 16 <= count; xidx += 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * xidx +  0), value);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * xidx + 16), value);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * xidx + 32), value);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * xidx + 48), value);
+    }
+#elif defined(__ARM_NEON)
+    /* 16 groups / iteration. */
+    uint8x16_t value = vreinterpretq_u8_u32(vdupq_n_u32(pattern));
+    for (; xidx + 16 <= count; xidx += 16) {
+        vst1q_u8(dst + 4 * xidx +  0, value);
+        vst1q_u8(dst + 4 * xidx + 16, value);
+        vst1q_u8(dst + 4 * xidx + 32, value);
+        vst1q_u8(dst + 4 * xidx + 48, value);
+    }
+#endif
+
+    /* Remaining groups. */
+    for (; xidx < count; xidx++) {
+        memcpy(dst + 4 * xidx, &pattern, 4);
+    }
+}
+
+}  // simd
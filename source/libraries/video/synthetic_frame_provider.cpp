@@ -0,0 +1,272 @@
+/**
+ * @file synthetic_frame_provider.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Defines a frame provider that generates test frames, without any camera or file.
+ */
+
+/* ========================== Include ========================== */
+#include "synthetic_frame_provider.h"
+
+/* Standard C Libraries */
+#include <string.h>  // memset(), memcpy()
+
+/* Standard C++ Libraries */
+#include <cmath>
+#include <random>
+#include <algorithm>
+
+/* Custom C++ Libraries */
+#include "common/clock.h"
+#include "simd.h"
+
+
+/* ========================== Helpers ========================== */
+/* Values drawn into the luma (or depth, in mm) plane. */
+static const uint16_t LUMA_DARK   = 16;
+static const uint16_t LUMA_BRIGHT = 235;
+static const uint16_t DEPTH_FAR   = 3000;  // Background.
+static const uint16_t DEPTH_NEAR  = 1000;  // First box.
+static const uint16_t COUNTER_ZERO[2] = {LUMA_DARK, 500};     // {luma, depth}
+static const uint16_t COUNTER_ONE[2]  = {LUMA_BRIGHT, 5000};  // {luma, depth}
+static const uint16_t COUNTER_THRESHOLD[2] = {128, 2750};     // {luma, depth}
+
+/**
+ * @brief 16 bit checksum of a sequence number (Knuth's multiplicative hash).
+ */
+static uint16_t checksum(uint32_t sequence) {
+    return static_cast<uint16_t>((sequence * 2654435761u) >> 16);
+}
+
+/**
+ * @brief Width of one counter bit, or 0 if the image is too small to hold the counter.
+ */
+static int counterBitWidth(int width, int height) {
+    if (height < SYNTHETIC_COUNTER_HEIGHT) { return 0; }
+    return width / SYNTHETIC_COUNTER_BITS;
+}
+
+/**
+ * @brief The luma (or depth) value of pixel (x, y).
+ */
+static uint16_t lumaAt(Image &image, int x, int y) {
+    const uint8_t* row = image.getData(0) + static_cast<size_t>(y) * image.getLinesize(0);
+    switch (image.getFormat()) {
+        case PixelFormat::DEPTH16: return reinterpret_cast<const uint16_t*>(row)[x];
+        case PixelFormat::YUV422:  return row[2 * x];
+        case PixelFormat::YUV:     return row[3 * x];
+        case PixelFormat::RGB24:   return row[3 * x];
+        case PixelFormat::RGBA:    return row[4 * x];
+        default:                   return row[x];  // Planar formats: the Y plane.
+    }
+}
+
+
+/* ========================== Classes ========================== */
+SyntheticFrameProvider::SyntheticFrameProvider(SyntheticConfig const& config): config_(config), source_id_(newSourceId()) {
+    if (config_.width <= 0 || config_.height <= 0 || config_.format == PixelFormat::EMPTY) {
+        LOGE("Invalid synthetic video: %dx%d, format %d.", config_.width, config_.height, static_cast<int>(config_.format));
+        throw std::runtime_error("Invalid synthetic video configuration");
+    }
+    if (counterBitWidth(config_.width, config_.height) == 0) {
+        LOGW("Synthetic video of %dx%d is too small to hold the frame counter.", config_.width, config_.height);
+    }
+
+    frame_.image = Image(config_.width, config_.height, config_.format);
+    frame_.source_id = source_id_;
+
+    /* Pregenerate the noise, drawing it should only cost a copy. */
+    if (config_.motion == SyntheticConfig::Motion::NOISE) {
+        std::mt19937 generator(source_id_);
+        noise_.resize(SYNTHETIC_NOISE_SIZE);
+        for (uint8_t &value: noise_) { value = static_cast<uint8_t>(generator()); }
+    }
+};
+
+Frame SyntheticFrameProvider::getFrame(double curr_time, PixelFormat requested_format) {
+    /* Draw the frame that is due (sequence numbers start at 1, at time 0). */
+    uint32_t sequence = frame_.sequence + 1;
+    if (config_.fps > 0.0) {
+        sequence = static_cast<uint32_t>(std::floor(std::max(curr_time, 0.0) * config_.fps)) + 1;
+    }
+    if (!has_frame_ || sequence > frame_.sequence) {
+        draw(sequence);
+        frame_.sequence  = sequence;
+        frame_.timestamp = common::micros();
+        has_frame_ = true;
+        is_converted_ = false;
+    }
+
+    /* Convert (once per frame) if requested. */
+    if (requested_format == PixelFormat::EMPTY || requested_format == config_.format) {
+        return frame_;
+    }
+
+    if (!is_converted_) {
+        if (converted_.image.getFormat() != requested_format) {
+            converted_.image = Image(config_.width, config_.height, requested_format);
+        }
+        ImageView src_view = frame_.image.view();
+        ImageView dst_view = converted_.image.view();
+        dst_view.copyFrom(src_view);
+
+        converted_.timestamp = frame_.timestamp;
+        converted_.sequence  = frame_.sequence;
+        converted_.source_id = frame_.source_id;
+        is_converted_ = true;
+    }
+    return converted_;
+};
+
+bool SyntheticFrameProvider::readCounter(Image &image, uint32_t &sequence) {
+    int bit_width = counterBitWidth(image.getWidth(), image.getHeight());
+    if (bit_width == 0 || image.getFormat() == PixelFormat::EMPTY) { return false; }
+
+    /* Sample the center of every bit. */
+    bool depth = (image.getFormat() == PixelFormat::DEPTH16);
+    uint64_t bits = 0;
+    for (int bit = 0; bit < SYNTHETIC_COUNTER_BITS; bit++) {
+        uint16_t value = lumaAt(image, bit * bit_width + bit_width / 2, SYNTHETIC_COUNTER_HEIGHT / 2);
+        if (value >= COUNTER_THRESHOLD[depth]) {
+            bits |= (1ull << bit);
+        }
+    }
+
+    sequence = static_cast<uint32_t>(bits);
+    return static_cast<uint16_t>(bits >> 32) == checksum(sequence);
+};
+
+void SyntheticFrameProvider::draw(uint32_t sequence) {
+    bool depth = (config_.format == PixelFormat::DEPTH16);
+    int width  = config_.width;
+    int height = config_.height;
+
+    /* A still frame only needs its counter redrawn. */
+    if (!has_frame_ || config_.motion != SyntheticConfig::Motion::STATIC) {
+        fillBackground(sequence);
+    }
+
+    /* Moving boxes (each with its own speed & direction), below the counter. */
+    if (config_.motion != SyntheticConfig::Motion::STATIC) {
+        int box_width  = std::max(width / 8, 2);
+        int box_height = std::max(height / 6, 2);
+        int64_t range_x = std::max(width - box_width, 1);
+        int64_t range_y = std::max(height - SYNTHETIC_COUNTER_HEIGHT - box_height, 1);
+
+        for (int box = 0; box < config_.boxes; box++) {
+            int64_t x = (static_cast<int64_t>(sequence) * (8 + 4 * box) + box * range_x / config_.boxes) % range_x;
+            int64_t y = (static_cast<int64_t>(sequence) * (1 + box) + box * 97) % range_y;
+            uint16_t value = depth ? static_cast<uint16_t>(DEPTH_NEAR + 250 * (box % 8)) : LUMA_BRIGHT;
+            fillRect(static_cast<int>(x), SYNTHETIC_COUNTER_HEIGHT + static_cast<int>(y), box_width, box_height, value);
+        }
+    }
+
+    /* Frame counter: the sequence number, followed by its checksum. */
+    int bit_width = counterBitWidth(width, height);
+    if (bit_width == 0) { return; }
+
+    uint64_t bits = sequence | (static_cast<uint64_t>(checksum(sequence)) << 32);
+    for (int bit = 0; bit < SYNTHETIC_COUNTER_BITS; bit++) {
+        uint16_t value = ((bits >> bit) & 1) ? COUNTER_ONE[depth] : COUNTER_ZERO[depth];
+        fillRect(bit * bit_width, 0, bit_width, SYNTHETIC_COUNTER_HEIGHT, value);
+    }
+};
+
+void SyntheticFrameProvider::fillBackground(uint32_t sequence) {
+    Image &image = frame_.image;
+    PlaneLayout layout = Image::getLayout(config_.format, config_.width, config_.height);
+
+    /* Noise: copy rows from a (per frame) shifting place in the pregenerated noise. */
+    if (config_.motion == SyntheticConfig::Motion::NOISE) {
+        for (int plane = 0; plane < layout.num_planes; plane++) {
+            for (int yidx = 0; yidx < layout.height[plane]; yidx++) {
+                uint8_t* row = image.getData(plane) + static_cast<size_t>(yidx) * layout.linesize[plane];
+                size_t row_size = static_cast<size_t>(layout.linesize[plane]);
+                for (size_t done = 0; done < row_size;) {
+                    size_t start = (static_cast<size_t>(sequence) * 4099 + yidx * 1031 + plane * 7 + done) % SYNTHETIC_NOISE_SIZE;
+                    size_t count = std::min(row_size - done, SYNTHETIC_NOISE_SIZE - start);
+                    memcpy(row + done, noise_.data() + start, count);
+                    done += count;
+                }
+            }
+        }
+        return;
+    }
+
+    /* Still: a dark background (or a far wall), with neutral chroma. */
+    uint8_t* data = image.getData(0);
+    size_t size = layout.size;
+    switch (config_.format) {
+        case PixelFormat::DEPTH16:
+            simd::fill32(data, DEPTH_FAR | (DEPTH_FAR << 16), static_cast<int>(size / 4));
+            break;
+        case PixelFormat::YUV422:
+            simd::fill32(data, LUMA_DARK | (128 << 8) | (LUMA_DARK << 16) | (128u << 24), static_cast<int>(size / 4));
+            break;
+        case PixelFormat::RGBA:
+            simd::fill32(data, LUMA_DARK | (LUMA_DARK << 8) | (LUMA_DARK << 16) | (0xFFu << 24), static_cast<int>(size / 4));
+            break;
+        case PixelFormat::RGB24:
+        case PixelFormat::GREY:
+            memset(data, LUMA_DARK, size);
+            break;
+        case PixelFormat::YUV:
+            for (size_t idx = 0; idx + 3 <= size; idx += 3) {
+                data[idx] = LUMA_DARK;
+                data[idx + 1] = 128;
+                data[idx + 2] = 128;
+            }
+            break;
+        default:  // Planar YUV: a luma plane, followed by the chroma plane(s).
+            memset(data, LUMA_DARK, layout.offset[1]);
+            memset(data + layout.offset[1], 128, size - layout.offset[1]);
+            break;
+    }
+};
+
+void SyntheticFrameProvider::fillRect(int x, int y, int width, int height, uint16_t value) {
+    Image &image = frame_.image;
+
+    /* Clip to the image. */
+    int x_end = std::min(x + width, config_.width);
+    int y_end = std::min(y + height, config_.height);
+    x = std::max(x, 0);
+    y = std::max(y, 0);
+    if (x >= x_end || y >= y_end) { return; }
+
+    /* Only the luma (or depth) plane, the chroma stays neutral. */
+    uint8_t luma = static_cast<uint8_t>(std::min<uint16_t>(value, 255));
+    for (int yidx = y; yidx < y_end; yidx++) {
+        uint8_t* row = image.getData(0) + static_cast<size_t>(yidx) * image.getLinesize(0);
+
+        switch (config_.format) {
+            case PixelFormat::DEPTH16: {
+                /* Pairs of pixels, then the odd one out. */
+                int pairs = (x_end - x) / 2;
+                simd::fill32(row + 2 * x, value | (static_cast<uint32_t>(value) << 16), pairs);
+                if ((x_end - x) % 2) { reinterpret_cast<uint16_t*>(row)[x_end - 1] = value; }
+                break;
+            }
+            case PixelFormat::YUV422: {
+                /* Whole macropixels (YUYV) only. */
+                int start = x & ~1;
+                simd::fill32(row + 2 * start, luma | (128 << 8) | (luma << 16) | (128u << 24), (x_end - start + 1) / 2);
+                break;
+            }
+            case PixelFormat::RGBA:
+                simd::fill32(row + 4 * x, luma | (luma << 8) | (luma << 16) | (0xFFu << 24), x_end - x);
+                break;
+            case PixelFormat::RGB24:
+                memset(row + 3 * x, luma, 3 * (x_end - x));
+                break;
+            case PixelFormat::YUV:
+                for (int xidx = x; xidx < x_end; xidx++) {
+                    row[3 * xidx] = luma;
+                }
+                break;
+            default:  // GREY & the Y plane of planar YUV.
+                memset(row + x, luma, x_end - x);
+                break;
+        }
+    }
+};
@@ -0,0 +1,98 @@
+/**
+ * @file synthetic_frame_provider.h
+ * @author Kevin Orbie
+ *
+ * @brief Declares a frame provider that generates test frames, without any camera or file.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <vector>
+
+/* Custom C++ Libraries */
+#include "frame_provider.h"
+
+
+/* ========================== Defines ========================== */
+#define SYNTHETIC_COUNTER_BITS   48  // 32 bit frame counter + 16 bit checksum.
+#define SYNTHETIC_COUNTER_HEIGHT 16  // Rows of the counter (survives 4:2:0 subsampling & lossy encoding).
+#define SYNTHETIC_NOISE_SIZE     (1 << 18)  // Bytes of pregenerated noise.
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief All settings of the generated video.
+ */
+struct SyntheticConfig {
+    /* How much changes between two frames (i.e. how hard the frames are to encode). */
+    enum class Motion {
+        STATIC,  // A still background (only the frame counter changes).
+        BOXES,   // Boxes moving over a still background.
+        NOISE,   // Boxes moving over a background of noise, that changes every frame.
+    };
+
+    int width  = 1280;
+    int height = 720;
+    double fps = 30.0;  // Frames per second (of the caller's time), or <= 0 for a new frame on every call.
+    PixelFormat format = PixelFormat::YUV422;  // Generated format, other formats are converted once per frame.
+    Motion motion = Motion::BOXES;
+    int boxes = 1;
+};
+
+/**
+ * @brief Generates frames with moving boxes (or noise), that carry their frame counter.
+ *
+ * @details Frames are drawn with (SIMD) row fills & copies, so the provider is never the bottleneck in a benchmark.
+ * The frame counter is drawn in the top left corner as SYNTHETIC_COUNTER_BITS blocks (black = 0, white = 1): the
+ * sequence number, followed by a checksum of it. readCounter() decodes it, e.g. on the far side of a stream, to find
+ * lost, repeated or corrupted frames.
+ *
+ * @note Like a camera, sequence numbers skip the frames that were due while the caller didn't ask for one.
+ *
+ * @example {@code
+ *  SyntheticConfig config;
+ *  config.fps = 0;  // As fast as possible.
+ *  SyntheticFrameProvider provider = SyntheticFrameProvider(config);
+ *  Frame frame = provider.getFrame(time, PixelFormat::YUV422);
+ *  uint32_t sequence = 0;
+ *  bool valid = SyntheticFrameProvider::readCounter(frame.image, sequence);
+ * }
+ */
+class SyntheticFrameProvider final: public FrameProvider {
+   public:
+    SyntheticFrameProvider(SyntheticConfig const& config=SyntheticConfig());
+
+    /**
+     * @brief The frame due at curr_time (seconds), or the same frame again when the next frame isn't due yet (Non-blocking).
+     */
+    Frame getFrame(double curr_time, PixelFormat requested_format) override;
+    void startStream() override {};  // Frames are generated on demand.
+    void stopStream() override {};
+
+    /**
+     * @brief Decode the frame counter drawn into the given image.
+     * @return True if the counter's checksum is valid.
+     */
+    static bool readCounter(Image &image, uint32_t &sequence);
+
+   private:
+    void draw(uint32_t sequence);
+    void fillBackground(uint32_t sequence);
+    void fillRect(int x, int y, int width, int height, uint16_t value);
+
+   private:
+    SyntheticConfig config_;
+    uint32_t source_id_ = 0;
+
+    /* Frame Data */
+    Frame frame_ = {};       // In the configured format.
+    Frame converted_ = {};   // In the last requested format (if different).
+    bool has_frame_ = false;
+    bool is_converted_ = false;
+    std::vector<uint8_t> noise_;
+};
@@ -8,9 +8,14 @@
 #include <unistd.h>  // close()
 #include <assert.h>  // assert()
 #include <string.h>  // strerror(), memcpy()
+#include <time.h>    // clock_gettime()
 
 /* Standard C++ Libraries */
 #include <stdexcept>
+#include <utility>  // std::swap()
+#include <chrono>
+#include <cmath>    // std::abs()
+#include <algorithm>  // std::max()
 
 /* OS provided C extentions. */
 #include <sys/stat.h>     // Data returned by the stat() function 
@@ -22,6 +27,7 @@
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
+#include "common/clock.h"
 #include "video/image.h"
 
 
@@ -46,10 +52,31 @@ static int xioctl(int fh, int request, void *arg) {
     return r;
 }
 
+/**
+ * @brief The capture time of the given (just dequeued) buffer, converted to common::micros().
+ * @note Call right when dequeue_us is taken (before copying the buffer), so both clocks are read at the same moment.
+ * @note Falls back to the dequeue time, when the driver doesn't use the monotonic clock.
+ */
+static int64_t captureTime(struct v4l2_buffer const& buf, int64_t dequeue_us) {
+    if ((buf.flags & V4L2_BUF_FLAG_TIMESTAMP_MASK) != V4L2_BUF_FLAG_TIMESTAMP_MONOTONIC) {
+        return dequeue_us;
+    }
+
+    /* Age of the frame on the driver's clock, subtracted from our clock (no assumption on their relation). */
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    int64_t monotonic_us = static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000;
+    int64_t driver_us    = static_cast<int64_t>(buf.timestamp.tv_sec) * 1000000 + buf.timestamp.tv_usec;
+    return dequeue_us - std::max<int64_t>(monotonic_us - driver_us, 0);
+}
+
 
 /* =============================== Classes =============================== */
 
-VideoCam::VideoCam(CamType type, IO_Method io_method, std::string device_name): cam_type_(type), io_method_(io_method), device_name_(device_name) {
+VideoCam::VideoCam(CamType type, IO_Method io_method, std::string device_name): 
+    cam_type_(type), io_method_(io_method), device_name_(device_name), timings_("Camera " + device_name, {"interval", "latency"}) {
+    source_id_ = newSourceId();
+
     /* ------------ Open Camera Device ------------ */
     struct stat st;
 
@@ -175,6 +202,14 @@ VideoCam::VideoCam(CamType type, IO_Method io_method, std::string device_name):
             fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_YUYV;  // YUV 4:2:2
             fmt.fmt.pix.field       = V4L2_FIELD_INTERLACED; 
             break;
+
+        case CamType::MYNT_EYE_DEPTH:
+            /* NOTE: The depth node may still report YUYV, which then carries raw 16-bit depth values (same 2 bytes / pixel). */
+            fmt.fmt.pix.width       = 1280;
+            fmt.fmt.pix.height      = 720;
+            fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_Z16;  // 16-bit depth
+            fmt.fmt.pix.field       = V4L2_FIELD_NONE; 
+            break;
         
         default:
             LOGE("Unsupported Camera Type used (error %d: %s)", errno, strerror(errno));
@@ -190,10 +225,13 @@ VideoCam::VideoCam(CamType type, IO_Method io_method, std::string device_name):
 
     frame_bytes_per_line_ = fmt.fmt.pix.bytesperline;  /* Distance in bytes between the leftmost pixels in two adjacent lines. */
 
-    /* Create Userspace Frame Buffer. */
-    frame_data_ = {};
-    frame_data_.image = Image(fmt.fmt.pix.width, fmt.fmt.pix.height, PixelFormat::YUV422);
-    frame_data_.image.zero();
+    /* Create Userspace Frame Buffers (swapped between the capture thread & getFrame()). */
+    PixelFormat frame_format = (type == CamType::MYNT_EYE_DEPTH) ? PixelFormat::DEPTH16 : PixelFormat::YUV422;
+    for (Frame *frame: {&capture_frame_, &ready_frame_, &latest_frame_}) {
+        *frame = {};
+        frame->image = Image(fmt.fmt.pix.width, fmt.fmt.pix.height, frame_format);
+        frame->image.zero();
+    }
 
     /* Buggy driver paranoia. */
     min = fmt.fmt.pix.width * 2;
@@ -418,6 +456,15 @@ void VideoCam::startStream() {
             break;
     }
 
+    /* Start the capture thread. */
+    last_sequence_  = 0;
+    last_timestamp_ = 0;
+    mean_interval_us_ = 0.0;
+    captured_count_ = dropped_count_ = skipped_count_ = 0;
+    jitter_us_ = latency_us_ = 0.0;
+    failed_ = false;
+    last_capture_time_ = common::micros();
+    thread();
     return;
 }
 
@@ -495,6 +542,7 @@ void VideoCam::start_IO_USRP() {
 
 VideoCam::~VideoCam(){
     /* Stop Capturing Frames */
+    Looper::stop();
     if (capturing) {
         stopStream();
     }
@@ -526,6 +574,9 @@ VideoCam::~VideoCam(){
 /* ############################## STOP ############################# */
 
 void VideoCam::stopStream() {
+    /* Stop the capture thread first, it is the only one touching the device. */
+    Looper::stop();
+
     switch (io_method_) {
         case IO_Method::READ:
             stop_IO_READ();
@@ -587,77 +638,167 @@ void VideoCam::uinit_IO_USRP() {
 /* ############################## GetFrame ############################ */
 
 Frame VideoCam::getFrame(double curr_time, PixelFormat fmt){
-    frame_data_.image.to(fmt);
+    if (failed_) {
+        LOGE("Camera capture failed, no new frames available.");
+        throw std::runtime_error("Camera capture failed");
+    }
 
-    int poll_result = -1;
-    int poll_timeout_ms = 20000; // Max wait 20 seconds
-    struct pollfd poll_fds;
+    /* Take the newest frame (giving back the previous one, to capture into). */
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex_);
+        if (!frame_ready_) {
+            return Frame();  // Nothing new since the last call.
+        }
+        std::swap(latest_frame_, ready_frame_);
+        frame_ready_ = false;
+    }
+
+    /* A single copy, converted into the requested format on the fly. */
+    ImageView latest_view = latest_frame_.image.view();
+    Frame frame;
+    frame.image     = Image(latest_view, fmt);
+    frame.timestamp = latest_frame_.timestamp;
+    frame.sequence  = latest_frame_.sequence;
+    frame.source_id = latest_frame_.source_id;
+    return frame;
+}
 
-    /* Setup Poll FD Settings */
-    poll_fds.fd = fd_;
-    poll_fds.events = POLLIN;  // Wait for available data to read
+bool VideoCam::waitForFrame(int timeout_ms) {
+    std::unique_lock<std::mutex> lock(frame_mutex_);
+    return frame_cv_.wait_for(lock, std::chrono::milliseconds(timeout_ms), [this]{ return frame_ready_ || failed_; });
+}
 
-    while (true) {
-        /* Block for I/O operations. */
-        poll_result = poll(&poll_fds, 1, poll_timeout_ms);  // Blocked here ???
-
-        /* Poll() returned errors. */
-        if (poll_result == -1) {
-            if (errno == EINTR)
-                continue;
-            LOGE("Poll issue (error %d: %s)", errno, strerror(errno));
-            throw std::runtime_error("poll failed");
-        }
+VideoCam::Stats VideoCam::stats() const {
+    Stats stats;
+    stats.captured   = captured_count_;
+    stats.dropped    = dropped_count_;
+    stats.skipped    = skipped_count_;
+    stats.jitter_ms  = jitter_us_ * 1e-3;
+    stats.latency_ms = latency_us_ * 1e-3;
+    return stats;
+}
 
-        /* Poll() timed outed. */
-        if (poll_result == 0) {
-            LOGE("Poll timeout.");
-            throw std::runtime_error("Poll timeout");  // Currently Limits GUI to camera framerate
+/**
+ * @brief Update the drop counters & timings with capture_frame_ (Capture thread).
+ * @note Jitter and latency are smoothed like the RTP interarrival jitter (RFC 3550, gain 1/16).
+ */
+void VideoCam::trackCapture() {
+    Frame &frame = capture_frame_;
+    frame.source_id = source_id_;
+    captured_count_++;
+
+    /* Gaps in the sequence are frames dropped by the driver, or skipped by us. */
+    uint32_t frames = 1;
+    if (last_sequence_ != 0 && frame.sequence > last_sequence_) {
+        frames = frame.sequence - last_sequence_;
+        uint64_t missing = frames - 1;
+        dropped_count_ += (missing > skipped_since_) ? missing - skipped_since_ : 0;
+    }
+    skipped_count_ += skipped_since_;
+    skipped_since_ = 0;
+
+    /* Inter-frame interval (per frame, over gaps), and its deviation from the mean. */
+    if (last_timestamp_ != 0) {
+        double interval_us = static_cast<double>(frame.timestamp - last_timestamp_) / frames;
+        if (mean_interval_us_ == 0.0) {
+            mean_interval_us_ = interval_us;
         }
+        double deviation_us = std::abs(interval_us - mean_interval_us_);
+        mean_interval_us_ += (interval_us - mean_interval_us_) / 16.0;
+        jitter_us_ = jitter_us_ + (deviation_us - jitter_us_) / 16.0;
+        timings_.add(0, interval_us * 1e-6);
+    }
+    last_sequence_  = frame.sequence;
+    last_timestamp_ = frame.timestamp;
+
+    /* Time the frame waited in the driver's queue. */
+    double latency_us = static_cast<double>(dequeue_time_ - frame.timestamp);
+    latency_us_ = latency_us_ + (latency_us - latency_us_) / 16.0;
+    timings_.add(1, latency_us * 1e-6);
+    timings_.report(VIDEO_CAM_REPORT_INTERVAL);
+}
 
-        /* Check for ERROR. */
-        if (poll_fds.revents & POLLERR) { 
-            LOGE("Poll issue (error %d: %s). Make sure camera is started / running.", errno, strerror(errno));
-            throw std::runtime_error("poll failed");
+/**
+ * @brief Capture one new frame, and hand it over to getFrame() (Capture thread).
+ */
+void VideoCam::iteration() {
+    try {
+        if (!captureFrame()) {
+            if (common::micros() - last_capture_time_ > VIDEO_CAM_TIMEOUT_MS * 1000LL) {
+                LOGE("Poll timeout.");
+                throw std::runtime_error("Poll timeout");
+            }
+            return;
         }
-
-        /* Check for closed stream. */
-        if (poll_fds.revents & POLLHUP) { 
-            LOGE("Device stream has been closed!");
-            throw std::runtime_error("Device stream has been closed");
+    } catch (const std::runtime_error& error) {
+        /* E.g. the camera was disconnected, reported to the consumer by getFrame(). */
+        LOGE("Camera capture failed (%s), stopped capturing.", error.what());
+        {
+            std::lock_guard<std::mutex> lock(running_mutex_);
+            running_ = false;
         }
-        
-        /* Try to read frame. */
-        switch (io_method_) {
-            case IO_Method::READ:
-                if (getFrame_IO_READ()) {
-                    return frame_data_;
-                }
-                break;
+        failed_ = true;
+        frame_cv_.notify_all();
+        return;
+    }
+    last_capture_time_ = common::micros();
+    trackCapture();
 
-            case IO_Method::MMAP:
-                if (getFrame_IO_MMAP()) {
-                    return frame_data_;
-                }
-                break;
+    /* Publish the new frame (a swap, the lock is never held during a copy). */
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex_);
+        std::swap(capture_frame_, ready_frame_);
+        frame_ready_ = true;
+    }
+    frame_cv_.notify_all();
+}
 
-            case IO_Method::USERPTR:
-                if (getFrame_IO_USRP()) {
-                    return frame_data_;
-                }
-                break;
-            
-            default:
-                break;
-        }
+/**
+ * @brief Wait (at most VIDEO_CAM_POLL_TIMEOUT_MS) for the driver, and read the next frame into capture_frame_.
+ * @return True if a frame was captured.
+ */
+bool VideoCam::captureFrame() {
+    struct pollfd poll_fds;
+
+    /* Setup Poll FD Settings */
+    poll_fds.fd = fd_;
+    poll_fds.events = POLLIN;  // Wait for available data to read
+
+    /* Block for I/O operations. */
+    int poll_result = poll(&poll_fds, 1, VIDEO_CAM_POLL_TIMEOUT_MS);
 
-        /* NOTE: Working with Non-Blocking I/O, this point is only reached after recieving a EAGAIN error,
-        i.e. there is no data available right now, try again later. Thus, we try again to read a frame. */
-        break; // Uncomment if you need a new frame for every call.
+    /* Poll() returned errors. */
+    if (poll_result == -1) {
+        if (errno == EINTR)
+            return false;
+        LOGE("Poll issue (error %d: %s)", errno, strerror(errno));
+        throw std::runtime_error("poll failed");
     }
 
-    LOGE("Broke out of getFrame loop."); // Never reached.
-    return frame_data_;
+    /* Poll() timed out, nothing new yet. */
+    if (poll_result == 0) {
+        return false;
+    }
+
+    /* Check for ERROR. */
+    if (poll_fds.revents & POLLERR) { 
+        LOGE("Poll issue (error %d: %s). Make sure camera is started / running.", errno, strerror(errno));
+        throw std::runtime_error("poll failed");
+    }
+
+    /* Check for closed stream. */
+    if (poll_fds.revents & POLLHUP) { 
+        LOGE("Device stream has been closed!");
+        throw std::runtime_error("Device stream has been closed");
+    }
+    
+    /* Try to read frame (with Non-Blocking I/O, false means EAGAIN: no data available right now, try again later). */
+    switch (io_method_) {
+        case IO_Method::READ:    return getFrame_IO_READ();
+        case IO_Method::MMAP:    return getFrame_IO_MMAP();
+        case IO_Method::USERPTR: return getFrame_IO_USRP();
+        default:                 return false;
+    }
 }
 
 void VideoCam::readFrame(unsigned int buffer_index) {
@@ -668,10 +809,22 @@ void VideoCam::readFrame(unsigned int buffer_index) {
             /* Directly copy YUV422 to YUV422. */
             ImageView image_view = ImageView(
                 {buffers_[buffer_index].start}, {frame_bytes_per_line_},
-                frame_data_.image.getWidth(), frame_data_.image.getHeight(), PixelFormat::YUV422
+                capture_frame_.image.getWidth(), capture_frame_.image.getHeight(), PixelFormat::YUV422
+            );
+
+            ImageView buffer_view = capture_frame_.image.view();
+            buffer_view.copyFrom(image_view);
+            break;
+        }
+
+        case CamType::MYNT_EYE_DEPTH: {
+            /* Directly copy DEPTH16 to DEPTH16 (lossless). */
+            ImageView image_view = ImageView(
+                {buffers_[buffer_index].start}, {frame_bytes_per_line_},
+                capture_frame_.image.getWidth(), capture_frame_.image.getHeight(), PixelFormat::DEPTH16
             );
 
-            ImageView buffer_view = frame_data_.image.view();
+            ImageView buffer_view = capture_frame_.image.view();
             buffer_view.copyFrom(image_view);
             break;
         }
@@ -700,7 +853,10 @@ bool VideoCam::getFrame_IO_READ() {
         }
     }
 
+    dequeue_time_ = common::micros();
     readFrame(0);
+    capture_frame_.sequence  = ++read_count_;  // read() has no driver sequence (nor timestamp).
+    capture_frame_.timestamp = dequeue_time_;
 
     return true;
 }
@@ -730,9 +886,36 @@ bool VideoCam::getFrame_IO_MMAP() {
         }
     }
 
+    /* Skip stale frames: while newer buffers are already filled, hand the older ones straight back to the driver. */
+    while (true) {
+        struct v4l2_buffer newer_buf;
+        CLEAR(newer_buf);
+        newer_buf.type = V4L2_BUF_TYPE_VIDEO_CAPTURE;
+        newer_buf.memory = V4L2_MEMORY_MMAP;
+
+        if (xioctl(fd_, VIDIOC_DQBUF, &newer_buf) == -1) {
+            if (errno == EAGAIN) {
+                break;  // buf is the newest frame.
+            }
+            LOGE("VIDIOC_DQBUF issue (error %d: %s)", errno, strerror(errno));
+            throw std::runtime_error("VIDIOC_DQBUF failed");
+        }
+
+        if (xioctl(fd_, VIDIOC_QBUF, &buf) == -1) {
+            LOGE("VIDIOC_QBUF issue (error %d: %s)", errno, strerror(errno));
+            throw std::runtime_error("VIDIOC_QBUF failed");
+        }
+        buf = newer_buf;
+        skipped_since_++;
+    }
+    dequeue_time_ = common::micros();
+    int64_t capture_time = captureTime(buf, dequeue_time_);
+
     assert(buf.index < buffers_.size());
 
     readFrame(buf.index);
+    capture_frame_.sequence  = buf.sequence + 1;  // Gaps are frames dropped by the driver, or skipped above.
+    capture_frame_.timestamp = capture_time;
 
     /* Enqueue an empty buffer in the driver’s incoming queue. */
     if (xioctl(fd_, VIDIOC_QBUF, &buf) == -1) {
@@ -756,7 +939,7 @@ bool VideoCam::getFrame_IO_USRP() {
     if (xioctl(fd_, VIDIOC_DQBUF, &buf) == -1) {
         switch (errno) {
             case EAGAIN:
-                return true;
+                return false;
 
             case EIO:
                 /* Could ignore EIO, see spec. */
@@ -775,7 +958,12 @@ bool VideoCam::getFrame_IO_USRP() {
 
     assert(i < buffers_.size());
 
+    dequeue_time_ = common::micros();
+    int64_t capture_time = captureTime(buf, dequeue_time_);
+
     readFrame(buf.index);
+    capture_frame_.sequence  = buf.sequence + 1;
+    capture_frame_.timestamp = capture_time;
 
     /* Enqueue an empty buffer in the driver’s incoming queue. */
     if (xioctl(fd_, VIDIOC_QBUF, &buf) == -1) {
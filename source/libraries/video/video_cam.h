@@ -8,23 +8,45 @@
 #include "frame_provider.h"
 
 /* Standard C++ Libraries */
+#include <condition_variable>
 #include <vector>
+#include <string>
+#include <atomic>
+#include <mutex>
+
+/* Custom C++ Libraries */
+#include "common/stage_stats.h"
+#include "common/looper.h"
+
+
+/* ========================== Defines ========================== */
+#define VIDEO_CAM_POLL_TIMEOUT_MS 100    // Max time the capture thread waits on the driver (before checking if it must stop).
+#define VIDEO_CAM_TIMEOUT_MS      20000  // Max time without new frames, before the camera is considered failed.
+#define VIDEO_CAM_REPORT_INTERVAL 5.0    // Seconds between two logs of the capture timings.
 
 
 /* ========================== Classes ========================== */
 
 /**
  * @brief Class to obtain frames from a camera device (on linux).
- * 
+ *
+ * @details After startStream(), frames are captured on a dedicated thread (this Looper), which dequeues every frame
+ * as soon as the driver signals it, and hands it over by swapping buffers (under a short lock). getFrame() never
+ * waits on the camera: it returns (a copy of) the newest frame, or an empty frame if nothing new arrived since the
+ * last call. waitForFrame() blocks until there is a new frame.
+ *
+ * Every frame carries the driver's capture timestamp (converted to common::micros()), the driver's sequence number,
+ * and this camera's source id. Gaps in the sequence numbers are reported as dropped frames.
+ *
  * @example {@code
  *  VideoCam camera = VideoCam();
- *  camera.start();
- *  camera.getFrame(time);
- *  camera.getFrame(time);
- *  camera.stop();
+ *  camera.startStream();
+ *  camera.waitForFrame(1000);
+ *  camera.getFrame(time, PixelFormat::YUV422);
+ *  camera.stopStream();
  * }
  */
-class VideoCam final: public FrameProvider {
+class VideoCam final: public FrameProvider, public Looper {
     /* --------------- Classes / Structures --------------- */
     struct buffer {
         /* Because start can point to memory allocated with mmap, I chose to keep this a normal pointer. */
@@ -37,7 +59,8 @@ class VideoCam final: public FrameProvider {
     enum class CamType {
         ARKMICRO_WEBCAM,
         MYNT_EYE_SINGLE,
-        MYNT_EYE_STEREO
+        MYNT_EYE_STEREO,
+        MYNT_EYE_DEPTH    // 16-bit depth map, captured as PixelFormat::DEPTH16.
     };
 
     enum class IO_Method {
@@ -47,15 +70,48 @@ class VideoCam final: public FrameProvider {
     };
 
     /* --------------- Function Declarations -------------- */
+    struct Stats {
+        uint64_t captured  = 0;    // Frames handed to getFrame().
+        uint64_t dropped   = 0;    // Frames lost by the driver (gaps in its sequence numbers).
+        uint64_t skipped   = 0;    // Stale frames skipped, because a newer frame was already available.
+        double jitter_ms   = 0.0;  // Smoothed deviation of the inter-frame interval from its (smoothed) mean.
+        double latency_ms  = 0.0;  // Smoothed time from capture (driver timestamp) until dequeued.
+    };
+
    public:
     VideoCam(CamType type=CamType::MYNT_EYE_STEREO, IO_Method io_method=IO_Method::MMAP, std::string device_name="/dev/video0");
     ~VideoCam();
+
+    /**
+     * @brief Returns the newest captured frame in the requested format, or an empty frame if nothing new was captured
+     * since the last call (Non-blocking).
+     * @throws std::runtime_error if the capture thread failed (e.g. the camera was disconnected).
+     */
     Frame getFrame(double curr_time, PixelFormat fmt) override;
-    void startStream();
-    void stopStream();
+    void startStream() override;  // Starts the capture thread.
+    void stopStream() override;
+
+    /**
+     * @brief Block this thread until a frame, newer than the last one returned by getFrame(), is available.
+     * @return True if a new frame is available (or the capture failed, which getFrame() reports), false on timeout.
+     */
+    bool waitForFrame(int timeout_ms) override;
+
+    /**
+     * @brief Capture counters & timings since startStream().
+     * @note Thread-safe.
+     */
+    Stats stats() const;
+
+    uint32_t sourceId() const { return source_id_; };
+
+    /* Looper Interface (capture thread). */
+    void iteration() override;
 
    private:
     void setCamControl(unsigned int control_id, int value);
+    bool captureFrame();  // Capture thread.
+    void trackCapture();  // Capture thread.
 
     void init_IO_READ(unsigned int size);
     void init_IO_MMAP();
@@ -89,6 +145,32 @@ class VideoCam final: public FrameProvider {
     std::vector<buffer> buffers_;
     int frame_bytes_per_line_ = 0;
 
-    /* Frame Data */
-    Frame frame_data_ = {};
+    /* Capture Thread */
+    Frame capture_frame_ = {};  // Being filled (only touched by the capture thread).
+    int64_t last_capture_time_ = 0;
+    uint32_t read_count_ = 0;  // Sequence for IO_Method::READ (which has no driver sequence).
+    std::atomic<bool> failed_ = {false};
+    uint32_t source_id_ = 0;
+
+    /* Capture Tracking (only touched by the capture thread, unless atomic) */
+    int64_t dequeue_time_   = 0;  // common::micros() when capture_frame_ was dequeued.
+    uint64_t skipped_since_ = 0;  // Skipped frames, since the last tracked frame.
+    uint32_t last_sequence_ = 0;
+    int64_t last_timestamp_ = 0;
+    double mean_interval_us_ = 0.0;
+    std::atomic<uint64_t> captured_count_ = {0};
+    std::atomic<uint64_t> dropped_count_  = {0};
+    std::atomic<uint64_t> skipped_count_  = {0};
+    std::atomic<double> jitter_us_  = {0.0};
+    std::atomic<double> latency_us_ = {0.0};
+    StageStats timings_;
+
+    /* Frame Handoff */
+    std::mutex frame_mutex_;
+    std::condition_variable frame_cv_;
+    Frame ready_frame_ = {};    // Newest complete frame, guarded by frame_mutex_.
+    bool frame_ready_ = false;  // ready_frame_ was not yet taken by getFrame(), guarded by frame_mutex_.
+
+    /* Frame Data (only touched by the getFrame() caller) */
+    Frame latest_frame_ = {};  // Newest taken frame, in the camera's format.
 };
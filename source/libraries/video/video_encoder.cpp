@@ -0,0 +1,283 @@
+/**
+ * @file video_encoder.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Defines a (runtime reconfigurable) H.264 / FFV1 encoder.
+ */
+
+/* ============================ Includes ============================ */
+#include "video_encoder.h"
+
+/* Standard C Libraries */
+// None
+
+/* Standard C++ Libraries */
+#include <algorithm>  // std::max()
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+#include "common/clock.h"
+
+extern "C" { // ffmpeg
+#include <libavutil/opt.h>
+}
+
+
+/* ============================ Functions =========================== */
+static AVPixelFormat toAVPixelFormat(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::YUV422P: return AV_PIX_FMT_YUV422P;
+        case PixelFormat::YUV420P: return AV_PIX_FMT_YUV420P;
+        case PixelFormat::DEPTH16: return AV_PIX_FMT_GRAY16LE;
+        case PixelFormat::NV12:    return AV_PIX_FMT_NV12;
+        default:
+            LOGE("Pixel format %d can not be encoded.", static_cast<int>(format));
+            throw std::invalid_argument("Unsupported encoder pixel format");
+    }
+}
+
+
+/* ============================ Classes ============================ */
+VideoEncoder::VideoEncoder(EncoderConfig const& config, PacketCallback on_packet): 
+    config_(config), on_packet_(on_packet) {
+    /* Allocate Packet */
+    ptr_packet = av_packet_alloc();
+    if (!ptr_packet) {
+        LOGE("Failed to allocate memory for AVPacket.");
+        throw std::runtime_error("Failed to allocate memory for AVPacket");
+    }
+
+    /* The destructor doesn't run when the constructor throws, so clean up here. */
+    try {
+        open();
+    } catch (...) {
+        close();
+        av_packet_free(&ptr_packet);
+        throw;
+    }
+}
+
+VideoEncoder::~VideoEncoder() {
+    close();
+    av_packet_free(&ptr_packet);
+}
+
+/**
+ * @brief Allocate & open the codec context and frame for the current config.
+ */
+void VideoEncoder::open() {
+    /* Setup Encoder (the codec may change between configs). */
+    ptr_codec = avcodec_find_encoder(config_.codec);
+    if (!ptr_codec) {
+        LOGE("Could not find encoder.");
+        throw std::runtime_error("Failed to find encoder");
+    }
+
+    /* Allocate video CODEC Context. */
+    ptr_codec_context = avcodec_alloc_context3(ptr_codec);
+    if (!ptr_codec_context) {
+        LOGE("Failed to allocated memory for AVCodecContext.");
+        throw std::runtime_error("Failed to allocated memory for AVCodecContext");
+    }
+
+    /* Fill the CODEC context. */
+    ptr_codec_context->codec_id  = config_.codec;
+    ptr_codec_context->bit_rate  = config_.bitrate;
+    ptr_codec_context->width     = config_.width;
+    ptr_codec_context->height    = config_.height;
+    ptr_codec_context->time_base = timeBase();
+    ptr_codec_context->framerate = AVRational{config_.fps, 1};
+    ptr_codec_context->gop_size  = config_.gop;  // How many frames between full frames sent.
+    ptr_codec_context->pix_fmt   = toAVPixelFormat(config_.format);
+
+    /* Setup Options. */
+    AVDictionary *ptr_codec_opts = nullptr;
+    if (config_.codec == AV_CODEC_ID_FFV1) {
+        /* Lossless: every frame on its own (a lost packet only costs one frame), coded in parallel slices. */
+        ptr_codec_context->gop_size     = 1;
+        ptr_codec_context->thread_type  = FF_THREAD_SLICE;
+        ptr_codec_context->thread_count = FFV1_THREADS;
+        av_dict_set(&ptr_codec_opts, "level", "3", 0);         // Slices & per slice CRCs.
+        av_dict_set(&ptr_codec_opts, "coder", "range_def", 0);  // Range coder, smaller than golomb rice.
+        av_dict_set(&ptr_codec_opts, "context", "1", 0);        // Large context model.
+    } else {
+        av_dict_set(&ptr_codec_opts, "profile", config_.profile.c_str(), 0);
+        av_dict_set(&ptr_codec_opts, "preset", config_.preset.c_str(), 0);
+        av_dict_set(&ptr_codec_opts, "tune", "zerolatency", 0);
+
+        /* Low delay: spread the intra blocks over frames & packets, instead of sending them all at once. */
+        if (config_.intra_refresh) {
+            av_dict_set(&ptr_codec_opts, "intra-refresh", "1", 0);  // Recovery point SEI's mark where decoding can start.
+        }
+        if (config_.slice_max_size > 0) {
+            av_dict_set_int(&ptr_codec_opts, "slice-max-size", config_.slice_max_size, 0);
+        }
+        ptr_codec_context->slices = config_.slices;
+        setRateControl();
+    }
+
+    /* Initialize the AVCodecContext to use the given AVCodec. */
+    int res = avcodec_open2(ptr_codec_context, ptr_codec, &ptr_codec_opts);
+    av_dict_free(&ptr_codec_opts);
+    if (res < 0) {
+        LOGE("Failed to open CODEC through avcodec_open2.");
+        throw std::runtime_error("Failed to open CODEC through avcodec_open2");
+    }
+
+    /* ---------------- Allocate Frame ----------------- */
+    ptr_frame = av_frame_alloc();
+    if (!ptr_frame) {
+        LOGE("Failed to allocate memory for AVFrame.");
+        throw std::runtime_error("Failed to allocate memory for AVFrame.");
+    }
+
+    ptr_frame->format = ptr_codec_context->pix_fmt;
+    ptr_frame->width  = ptr_codec_context->width;
+    ptr_frame->height = ptr_codec_context->height;
+
+    /* Allocate frame data (data buffer). */
+    if (av_frame_get_buffer(ptr_frame, 0) < 0) {
+        LOGE("Failed to allocate memory for AVFrame data.");
+        throw std::runtime_error("Failed to allocate memory for AVFrame data");
+    }
+
+    LOGI("Encoder '%s' opened: %dx%d @ %d FPS, %ld kbps, GOP %d%s, preset '%s', profile '%s'.", ptr_codec->name,
+         config_.width, config_.height, config_.fps, config_.bitrate / 1000, ptr_codec_context->gop_size, 
+         config_.intra_refresh ? " (intra refresh)" : "", config_.preset.c_str(), config_.profile.c_str());
+}
+
+/**
+ * @brief Cap the bitrate over every vbv_frames frames (if set), which bounds the size of every single frame.
+ * @note libx264 picks up changes on the next frame.
+ */
+void VideoEncoder::setRateControl() {
+    ptr_codec_context->bit_rate = config_.bitrate;
+    if (config_.vbv_frames > 0.0) {
+        ptr_codec_context->rc_max_rate    = config_.bitrate;
+        ptr_codec_context->rc_buffer_size = static_cast<int>(config_.bitrate * config_.vbv_frames / config_.fps);
+    }
+}
+
+void VideoEncoder::close() {
+    av_frame_free(&ptr_frame);
+    avcodec_free_context(&ptr_codec_context);
+}
+
+/**
+ * @brief Output all packets the encoder still holds on to.
+ */
+void VideoEncoder::flush() {
+    if (avcodec_send_frame(ptr_codec_context, nullptr) < 0) {
+        LOGW("Issue while flushing the encoder.");
+        return;
+    }
+    drain();
+}
+
+/**
+ * @brief Hand all available packets to the packet callback.
+ */
+void VideoEncoder::drain() {
+    while (true) {
+        int ret = avcodec_receive_packet(ptr_codec_context, ptr_packet);
+        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
+            break;
+        } else if (ret < 0) {
+            LOGE("Issue during recieving encoded packet: %d", ret);
+            throw std::runtime_error("Failed to recieve encoded packet");
+        }
+
+        /* Match the packet with the frame it encodes. */
+        LatencyStamp stamp = {};
+        while (!stamps_.empty() && stamps_.front().first <= ptr_packet->pts) {
+            if (stamps_.front().first == ptr_packet->pts) {
+                stamp = stamps_.front().second;
+            }
+            stamps_.pop_front();
+        }
+        stamp.encode_end_us = common::micros();
+
+        on_packet_(ptr_packet, stamp);
+        av_packet_unref(ptr_packet);
+    }
+}
+
+void VideoEncoder::reconfigure(EncoderConfig const& config) {
+    if (config == config_) {
+        return;
+    }
+
+    if (!config_.requiresReopen(config)) {
+        /* libx264 picks up bitrate changes on the next frame, without a new keyframe. */
+        if (config.bitrate != config_.bitrate) {
+            LOGI("Encoder bitrate: %ld -> %ld kbps.", config_.bitrate / 1000, config.bitrate / 1000);
+        }
+        config_.bitrate = config.bitrate;
+        config_.filter  = config.filter;
+        config_.slice_packets = config.slice_packets;
+        setRateControl();
+        return;
+    }
+
+    /* Finish the current stream, and continue the timestamps in the new time base. */
+    flush();
+    close();
+    stamps_.clear();
+
+    AVRational old_time_base = timeBase();
+    config_ = config;
+    next_pts_ = av_rescale_q(next_pts_, old_time_base, timeBase());
+
+    open();
+}
+
+void VideoEncoder::encode(ImageView &image, uint32_t sequence, int64_t capture_us) {
+    LatencyStamp stamp = {};
+    stamp.sequence = sequence;
+    stamp.capture_us = capture_us;
+    stamp.encode_start_us = common::micros();
+
+    if (av_frame_make_writable(ptr_frame) < 0) {
+        LOGE("Failed to make the encoder frame writable.");
+        throw std::runtime_error("Failed to make the encoder frame writable");
+    }
+
+    int num_planes = Image::getLayout(config_.format, config_.width, config_.height).num_planes;
+    ImageView frame_view = ImageView( 
+        std::vector<uint8_t*>(ptr_frame->data, ptr_frame->data + num_planes),
+        std::vector<int>(ptr_frame->linesize, ptr_frame->linesize + num_planes),
+        config_.width, config_.height, config_.format
+    );
+
+    if (image.getWidth() == config_.width && image.getHeight() == config_.height) {
+        /* Convert straight into the encoder's frame. */
+        frame_view.copyFrom(image);
+
+    } else {
+        /* Convert & scale straight into the encoder's frame, in one pass. */
+        frame_view.scaleFrom(image, config_.filter);
+    }
+
+    /* Timestamp by capture time, so dropped frames leave a gap instead of speeding up playback. */
+    int64_t pts = next_pts_;
+    if (capture_us != 0) {
+        if (capture_epoch_us_ == 0) {
+            capture_epoch_us_ = capture_us - av_rescale_q(next_pts_, timeBase(), AVRational{1, 1000000});
+        }
+        pts = std::max(next_pts_, av_rescale_q(capture_us - capture_epoch_us_, AVRational{1, 1000000}, timeBase()));
+    }
+
+    /* Send a frame to the encoder. */
+    ptr_frame->pts = pts;
+    next_pts_ = pts + 1;
+    stamps_.push_back({ptr_frame->pts, stamp});
+    if (avcodec_send_frame(ptr_codec_context, ptr_frame) < 0) {
+        LOGE("Issue encoding frame.");
+        throw std::runtime_error("Failed to encode frame");
+    }
+
+    drain();
+}
@@ -0,0 +1,146 @@
+/**
+ * @file video_encoder.h
+ * @author Kevin Orbie
+ * 
+ * @brief Declares a (runtime reconfigurable) H.264 / FFV1 encoder.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <functional>
+#include <string>
+#include <deque>
+
+/* Third Party C++ Libraries */
+extern "C" { // ffmpeg
+#include <libavcodec/avcodec.h>
+}
+
+/* Custom C++ Libraries */
+#include "latency_sei.h"
+#include "image.h"
+
+
+/* ========================== Defines ========================== */
+#define FFV1_THREADS 4  // Slice threads of the (CPU heavy) lossless encoder.
+#define LOW_DELAY_SLICE_SIZE 1200  // Max. slice bytes, so a slice (with its TS & UDP headers) fits one 1500 byte MTU.
+#define LOW_DELAY_VBV_FRAMES 1.0   // VBV buffer (in frames), so every frame is about the same size.
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief All encoder settings that can be changed at runtime.
+ */
+struct EncoderConfig {
+    int width   = 1280;
+    int height  = 720;
+    int fps     = 30;
+    int64_t bitrate = 1000000;  // bits / second
+    int gop     = 30;           // Frames between two keyframes.
+    std::string preset  = "ultrafast";  // ultrafast, superfast, veryfast, faster, fast, medium (default), slow, veryslow
+    std::string profile = "high";       // high (YUV420P & NV12 only), high422 (YUV422P)
+    PixelFormat format  = PixelFormat::YUV420P;
+    AVCodecID   codec   = AV_CODEC_ID_H264;  // H264 (lossy, libx264), or FFV1 (lossless, e.g. for DEPTH16: ignores the bitrate, preset, profile & gop).
+    ScaleFilter filter  = ScaleFilter::BOX;  // Used when the source resolution differs (BOX for the 1/2, 1/4 pyramid).
+
+    /* H.264 only */
+    bool   intra_refresh  = false;  // Refresh a moving column of intra blocks over every gop frames, instead of sending keyframes.
+    int    slices         = 0;      // Min. slices per frame (0 = encoder default).
+    int    slice_max_size = 0;      // Max. bytes per slice (0 = unlimited).
+    double vbv_frames     = 0.0;    // VBV buffer size, in frames at the bitrate (0 = encoder default).
+    bool   slice_packets  = false;  // Send every slice as its own packet, so the reciever can decode it as it arrives.
+
+    /**
+     * @brief This config, with intra refresh, MTU sized slices & a one frame VBV buffer: every frame is about the same 
+     * size, which avoids the keyframe bursts that overflow the socket buffers (and the latency they add).
+     * Every slice is sent on its own, which requires a chunked VideoReciever.
+     */
+    EncoderConfig lowDelay() const {
+        EncoderConfig config = *this;
+        config.intra_refresh  = true;
+        config.slices         = 4;
+        config.slice_max_size = LOW_DELAY_SLICE_SIZE;
+        config.vbv_frames     = LOW_DELAY_VBV_FRAMES;
+        config.slice_packets  = true;
+        return config;
+    };
+
+    /**
+     * @brief Whether going from this config to other requires the encoder to be re-opened.
+     * @note The bitrate, scale filter & slice packets can be changed on the fly.
+     */
+    bool requiresReopen(EncoderConfig const& other) const {
+        return width != other.width || height != other.height || fps != other.fps || gop != other.gop || 
+               preset != other.preset || profile != other.profile || format != other.format || codec != other.codec ||
+               intra_refresh != other.intra_refresh || slices != other.slices || slice_max_size != other.slice_max_size || 
+               vbv_frames != other.vbv_frames;
+    };
+
+    bool operator==(EncoderConfig const& other) const {
+        return !requiresReopen(other) && bitrate == other.bitrate && filter == other.filter && slice_packets == other.slice_packets;
+    };
+
+    bool operator!=(EncoderConfig const& other) const {
+        return !(*this == other);
+    };
+};
+
+/**
+ * @brief Encodes images into H.264 (or FFV1) packets, scaling them to the configured resolution if needed.
+ */
+class VideoEncoder final {
+   public:
+    /**
+     * Called for every encoded packet (timestamps in timeBase()), the packet is unreferenced afterwards. 
+     * The stamp holds the timing of the frame in the packet (send_us still unset).
+     */
+    typedef std::function<void(AVPacket *packet, LatencyStamp &stamp)> PacketCallback;
+
+    VideoEncoder(EncoderConfig const& config, PacketCallback on_packet);
+    ~VideoEncoder();
+
+    VideoEncoder(const VideoEncoder& other)            = delete;
+    VideoEncoder& operator=(const VideoEncoder& other) = delete;
+
+    /**
+     * @brief Encode one image (of any resolution / supported format).
+     * @param sequence & capture_us: Frame info, handed back with its packet (capture_us also sets the pts).
+     */
+    void encode(ImageView &image, uint32_t sequence=0, int64_t capture_us=0);
+
+    /**
+     * @brief Apply a new configuration. Only re-opens the encoder when needed, and keeps timestamps continuous.
+     */
+    void reconfigure(EncoderConfig const& config);
+
+    EncoderConfig const& config() const { return config_; };
+    AVRational timeBase() const { return AVRational{1, config_.fps}; };
+    AVCodecContext const* context() const { return ptr_codec_context; };
+
+   private:
+    void open();
+    void close();
+    void setRateControl();
+    void flush();
+    void drain();
+
+   private:
+    EncoderConfig config_;
+    PacketCallback on_packet_;
+    int64_t next_pts_ = 0;  // In timeBase()
+    int64_t capture_epoch_us_ = 0;  // Capture time of pts 0.
+    std::deque<std::pair<int64_t, LatencyStamp>> stamps_;  // Frames in the encoder, by pts.
+
+    /* Codec Variables (for encoding) */
+    AVCodecContext *ptr_codec_context = nullptr;
+    AVCodec const  *ptr_codec         = nullptr;
+
+    /* Stream Slice Variables */
+    AVPacket *ptr_packet = nullptr;  // Encoded
+    AVFrame  *ptr_frame  = nullptr;  // Raw
+};
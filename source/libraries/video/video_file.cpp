@@ -11,16 +11,18 @@
 
 /* Standard C++ Libraries */
 #include <stdexcept>
+#include <algorithm>
+#include <chrono>
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
+#include "common/utils.h"  // gettid()
+#include "common/clock.h"
 #include "image.h"
 
 
 /* ============================ Classes ============================ */
-VideoFile::VideoFile(std::string const& filepath) {
-    filepath_ = filepath;
-
+VideoFile::VideoFile(std::string const& filepath, bool loop): filepath_(filepath), loop_(loop), ready_frames_(READY_FRAMES) {
     /* ---------------- Setup Container Context ----------------- */
     ptr_format_context = avformat_alloc_context();
     if (!ptr_format_context) {
@@ -28,6 +30,17 @@ VideoFile::VideoFile(std::string const& filepath) {
         throw std::runtime_error("Failed to allocate memory for Format Context.");
     }
     
+    timestamp_t open_start = common::now();
+
+    #ifdef VIDEO_FILE_MMAP
+    /* Read local files straight from a memory mapping. */
+    if (MappedFileIO::isLocalFile(filepath)) {
+        mapped_io_ = std::make_unique<MappedFileIO>(filepath);
+        ptr_format_context->pb = mapped_io_->context();
+        ptr_format_context->flags |= AVFMT_FLAG_CUSTOM_IO;
+    }
+    #endif
+
     /* Get Header Information */
     if (avformat_open_input(&ptr_format_context, filepath.c_str(), NULL, NULL) != 0) {
         LOGE("Could not open the video file.");
@@ -42,6 +55,8 @@ VideoFile::VideoFile(std::string const& filepath) {
         throw std::runtime_error("Could not get the stream info.");
     }
 
+    LOGI("Opened '%s' in %.1f ms (%s).", filepath.c_str(), common::seconds(open_start, common::now()) * 1e3, (mapped_io_) ? "memory mapped" : "file protocol");
+
     /* ---------------------- Setup CODEC ----------------------- */
     /* Loop over all streams */
     for (int i = 0; i < ptr_format_context->nb_streams; i++) {
@@ -132,6 +147,7 @@ VideoFile::VideoFile(std::string const& filepath) {
     /* Create Userspace Frame Buffer. */
     frame_data_ = {};
     frame_data_.image = Image(ptr_frame->width, ptr_frame->height, PixelFormat::YUV420P);
+    frame_data_.image.zero();  // Shown until the first frame is decoded.
 
     /* Allocate Packet. */
     ptr_packet = av_packet_alloc();
@@ -139,81 +155,123 @@ VideoFile::VideoFile(std::string const& filepath) {
         LOGE("Failed to allocate memory for AVPacket.");
         throw std::runtime_error("Failed to allocate memory for AVPacket");
     }
+
+    /* ------------------ Build Keyframe Index ------------------ */
+    timestamp_t index_start = common::now();
+    buildKeyframeIndex();
+    LOGI("Indexed '%s' in %.1f ms.", filepath.c_str(), common::seconds(index_start, common::now()) * 1e3);
 }
 
 VideoFile:: ~VideoFile() {
+    stopDecoding();
+
     avformat_close_input(&ptr_format_context);
     av_packet_free(&ptr_packet);
     av_frame_free(&ptr_frame);
     avcodec_free_context(&ptr_codec_context);
 }
 
-Frame VideoFile::getFrame(double curr_time, PixelFormat fmt) {
-    frame_data_.image.to(fmt);
+/**
+ * @brief Read through all packets once, to find every keyframe & the duration, then rewind.
+ */
+void VideoFile::buildKeyframeIndex() {
+    AVRational time_base = ptr_format_context->streams[video_stream_index]->time_base;
+    int64_t end_timestamp = AV_NOPTS_VALUE;
 
-    int response = 0;
-    bool found_packet = false;
-    bool decoded_frame = false;
-    
-    /* Set correct FPS. */
-    if (play_time_ >= curr_time) {
-        return frame_data_;
-    }
-
-    /* Try to decode frame. */
-    response = avcodec_receive_frame(ptr_codec_context, ptr_frame);
-    if (response == AVERROR(EAGAIN) || response == AVERROR_EOF) {
-        decoded_frame = false;
-    } else if (response < 0) {
-        LOGW("Issue while receiving a frame from the decoder: %d", (response));
-        return frame_data_;
-    } else {
-        decoded_frame = true;
+    while (av_read_frame(ptr_format_context, ptr_packet) >= 0) {
+        if (ptr_packet->stream_index == video_stream_index) {
+            int64_t timestamp = (ptr_packet->pts != AV_NOPTS_VALUE) ? ptr_packet->pts : ptr_packet->dts;
+
+            if (timestamp != AV_NOPTS_VALUE) {
+                if ((ptr_packet->flags & AV_PKT_FLAG_KEY)) {
+                    if (keyframes_.empty()) {
+                        start_timestamp_ = timestamp;
+                    }
+                    Keyframe keyframe;
+                    keyframe.timestamp = timestamp;
+                    keyframe.time      = (timestamp - start_timestamp_) * av_q2d(time_base);
+                    keyframe.position  = ptr_packet->pos;
+                    keyframes_.push_back(keyframe);
+                }
+
+                int64_t packet_end = timestamp + std::max<int64_t>(ptr_packet->duration, 0);
+                end_timestamp = (end_timestamp == AV_NOPTS_VALUE) ? packet_end : std::max(end_timestamp, packet_end);
+            }
+        }
+        av_packet_unref(ptr_packet);
     }
 
-    /* Retrieve Video Stream Packets until we can decode the next frame. */
-    while (!decoded_frame && av_read_frame(ptr_format_context, ptr_packet) >= 0) {
+    /* Keyframes are found in decode order, which may slightly differ from presentation order. */
+    std::sort(keyframes_.begin(), keyframes_.end(), [](Keyframe const& a, Keyframe const& b){ return a.time < b.time; });
 
-        /* Only process selected Video Stream Packets. */
-        if (ptr_packet->stream_index == video_stream_index) {
-            // LOGI("AVPacket->pts %" PRId64 "\t", ptr_packet->pts);
+    if (keyframes_.empty()) {
+        LOGW("No keyframes found in '%s', seeking is not supported.", filepath_.c_str());
+    } else {
+        duration_ = (end_timestamp - start_timestamp_) * av_q2d(time_base);
+        LOGI("Indexed %lu keyframes, duration %.2fs.", keyframes_.size(), duration_);
+    }
 
-            /* Send packet to decoder */
-            response = avcodec_send_packet(ptr_codec_context, ptr_packet);
-            if (response < 0) {
-                LOGW("Issue while sending a packet to the decoder: %d", (response));
-                return frame_data_;
-            }
+    /* Rewind. */
+    if (av_seek_frame(ptr_format_context, video_stream_index, keyframes_.empty() ? 0 : keyframes_[0].timestamp, AVSEEK_FLAG_BACKWARD) < 0) {
+        LOGE("Failed to rewind '%s' after indexing.", filepath_.c_str());
+        throw std::runtime_error("Failed to rewind video file");
+    }
+}
 
-            /* Decode new frame */
-            response = avcodec_receive_frame(ptr_codec_context, ptr_frame);
-            if (response != AVERROR(EAGAIN) && response != AVERROR_EOF && response < 0) {
-                LOGW("Issue while receiving a frame from the decoder: %d", (response));
-                return frame_data_;
-            } else if (response >= 0) {
-                decoded_frame = true;
-            }
+void VideoFile::startStream() {
+    if (decoding_) { return; }
+
+    decoding_ = true;
+    decode_thread_ = std::thread([this]() {
+        LOGI("Running VideoFile decoder (TID = %d)", gettid());
+        while (decoding_) {
+            decodeAhead();
         }
+    });
+}
 
-        av_packet_unref(ptr_packet);
+void VideoFile::stopStream() {
+    stopDecoding();
+}
+
+void VideoFile::stopDecoding() {
+    decoding_ = false;
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
+}
+
+void VideoFile::seek(double time) {
+    seek_target_ = std::max(time, 0.0);
+}
+
+/**
+ * @brief Decode one frame, and queue it for presentation (Blocking while enough frames are queued).
+ */
+void VideoFile::decodeAhead() {
+    double target = seek_target_.exchange(-1.0);
+    if (target >= 0.0) {
+        applySeek(target);
+        time_offset_ = caller_time_ - target;
     }
 
-    if (!decoded_frame) {
-        return frame_data_; 
+    if (!decodeFrame()) {
+        if (loop_ && !keyframes_.empty()) {
+            /* Continue from the start, right after the last frame (keeping the queued frames of this pass). */
+            rewind(0.0);
+            time_offset_ += duration_;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));  // Hold the last frame.
+        }
+        return;
     }
 
-    play_time_ = static_cast<double>(ptr_frame->pts) * static_cast<double>(ptr_format_context->streams[video_stream_index]->time_base.num) / static_cast<double>(ptr_format_context->streams[video_stream_index]->time_base.den);
-    // LOGI(
-    //     "Frame %d (type=%c, size=%d bytes, format=%d) pts %ld key_frame %d time %fs [DTS %d]",
-    //     ptr_codec_context->frame_number,
-    //     av_get_picture_type_char(ptr_frame->pict_type),
-    //     ptr_frame->pkt_size,
-    //     ptr_frame->format,
-    //     ptr_frame->pts,
-    //     ptr_frame->key_frame,
-    //     play_time_,
-    //     ptr_frame->coded_picture_number
-    // );
+    /* Frame time, relative to the first keyframe. */
+    int64_t pts = (ptr_frame->pts != AV_NOPTS_VALUE) ? ptr_frame->pts : ptr_frame->best_effort_timestamp;
+    double file_time = (pts - start_timestamp_) * av_q2d(ptr_format_context->streams[video_stream_index]->time_base);
+    if (file_time < skip_until_) {
+        return;  // Decoding from the keyframe up to the seek target.
+    }
 
     /* Process Frame. */
     if (ptr_frame->format != AV_PIX_FMT_YUV420P) {
@@ -226,8 +284,177 @@ Frame VideoFile::getFrame(double curr_time, PixelFormat fmt) {
         ptr_frame->width, ptr_frame->height, PixelFormat::YUV420P
     );
 
-    ImageView buffer_view = frame_data_.image.view();
-    buffer_view.copyFrom(image_view);
-    
+    /* Convert into a pooled buffer, in the format the caller last asked for. */
+    ReadyFrame ready;
+    {
+        std::lock_guard<std::mutex> lock(pool_mutex_);
+        if (!pool_.empty()) {
+            ready.image = std::move(pool_.back());
+            pool_.pop_back();
+        }
+    }
+
+    PixelFormat format = requested_format_;
+    if (ready.image.getWidth() != ptr_frame->width || ready.image.getHeight() != ptr_frame->height || ready.image.getFormat() != format) {
+        ready.image = Image(ptr_frame->width, ptr_frame->height, format);
+    }
+
+    ImageView ready_view = ready.image.view();
+    if (format == PixelFormat::YUV420P || format == PixelFormat::YUV) {
+        ready_view.copyFrom(image_view);
+    } else {
+        ready_view.scaleFrom(image_view);  // Same size, only resamples the chroma planes.
+    }
+    ready.time = file_time + time_offset_;
+    ready.generation = generation_;
+
+    /* Wait for space, unless a seek asks to move on. */
+    while (decoding_ && seek_target_ < 0.0) {
+        if (ready_frames_.push(ready, 50)) {
+            return;
+        }
+    }
+    recycle(ready.image);
+}
+
+/**
+ * @brief Read packets until the decoder outputs the next frame.
+ */
+bool VideoFile::decodeFrame() {
+    while (true) {
+        int response = avcodec_receive_frame(ptr_codec_context, ptr_frame);
+        if (response >= 0) {
+            return true;
+        } else if (response == AVERROR_EOF) {
+            return false;
+        } else if (response != AVERROR(EAGAIN)) {
+            LOGW("Issue while receiving a frame from the decoder: %d", (response));
+        }
+
+        /* The decoder needs more input. */
+        if (av_read_frame(ptr_format_context, ptr_packet) < 0) {
+            avcodec_send_packet(ptr_codec_context, nullptr);  // End of file: drain the decoder.
+            continue;
+        }
+
+        if (ptr_packet->stream_index == video_stream_index) {
+            response = avcodec_send_packet(ptr_codec_context, ptr_packet);
+            if (response < 0) {
+                LOGW("Issue while sending a packet to the decoder: %d", (response));
+            }
+        }
+        av_packet_unref(ptr_packet);
+    }
+}
+
+/**
+ * @brief Jump to the last keyframe at or before the given file time, and drop everything decoded before.
+ */
+void VideoFile::applySeek(double time) {
+    if (rewind(time)) {
+        generation_++;
+    }
+}
+
+/**
+ * @brief Move the demuxer & decoder to the last keyframe at or before the given file time.
+ * @return False if the file can't seek (there is no keyframe index), or the seek failed.
+ */
+bool VideoFile::rewind(double time) {
+    if (keyframes_.empty()) {
+        return false;
+    }
+
+    /* Last keyframe at or before time. */
+    auto next = std::upper_bound(keyframes_.begin(), keyframes_.end(), time, [](double t, Keyframe const& keyframe){ return t < keyframe.time; });
+    Keyframe const& keyframe = (next == keyframes_.begin()) ? *next : *(next - 1);
+
+    /* Jump straight to the byte position when the demuxer allows it, avoiding its own index search. */
+    int response = -1;
+    if (keyframe.position >= 0 && !(ptr_format_context->iformat->flags & AVFMT_NO_BYTE_SEEK)) {
+        response = av_seek_frame(ptr_format_context, video_stream_index, keyframe.position, AVSEEK_FLAG_BYTE);
+    }
+    if (response < 0) {
+        response = av_seek_frame(ptr_format_context, video_stream_index, keyframe.timestamp, AVSEEK_FLAG_BACKWARD);
+    }
+    if (response < 0) {
+        LOGW("Failed to seek to %.2fs in '%s'.", time, filepath_.c_str());
+        return false;
+    }
+
+    avcodec_flush_buffers(ptr_codec_context);
+    skip_until_ = time;
+    return true;
+}
+
+void VideoFile::recycle(Image &image) {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    if (pool_.size() < READY_FRAMES + 2) {
+        pool_.push_back(std::move(image));
+    }
+}
+
+Frame VideoFile::getFrame(double curr_time, PixelFormat fmt) {
+    requested_format_ = fmt;
+    caller_time_ = curr_time;
+    caller_clock_ = common::now();
+    has_caller_clock_ = true;
+
+    /* Present the newest due frame (older due frames are skipped), without waiting. */
+    bool presented = false;
+    uint64_t generation = generation_;
+    while (true) {
+        if (!has_pending_) {
+            if (!ready_frames_.tryPop(pending_)) { break; }
+            has_pending_ = true;
+        }
+
+        if (pending_.generation < generation) {
+            /* Decoded before a seek. */
+            recycle(pending_.image);
+            has_pending_ = false;
+            continue;
+        }
+
+        if (pending_.time > curr_time) {
+            break;  // Not yet due.
+        }
+
+        std::swap(frame_data_.image, pending_.image);
+        recycle(pending_.image);
+        has_pending_ = false;
+
+        frame_data_.sequence++;
+        frame_data_.timestamp = common::micros();
+        presented = true;
+    }
+
+    if (!presented) {
+        return Frame();  // Nothing new (yet).
+    }
+
+    frame_data_.image.to(fmt);  // Only converts after a format change.
     return frame_data_;
 }
+
+bool VideoFile::waitForFrame(int timeout_ms) {
+    /* The next decoded frame, waiting on the decoder if needed. */
+    if (!has_pending_) {
+        if (!ready_frames_.pop(pending_, timeout_ms)) {
+            return false;
+        }
+        has_pending_ = true;
+    }
+    if (pending_.generation < generation_ || !has_caller_clock_) {
+        return true;  // Up to getFrame() (to drop it, or to start the caller's clock).
+    }
+
+    /* Wait until it is due, on the caller's clock (which moved on since its last getFrame()). */
+    double caller_time = caller_time_ + common::seconds(caller_clock_, common::now());
+    double due_in = pending_.time - caller_time;
+    double timeout = timeout_ms * 1e-3;
+    if (due_in > 0.0) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(std::min(due_in, timeout)));
+    }
+    return due_in <= timeout;
+}
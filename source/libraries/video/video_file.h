@@ -16,6 +16,10 @@
 /* Standard C++ Libraries */
 #include <vector>
 #include <string>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
 
 /* Third Party C++ Libraries */
 extern "C" { // ffmpeg
@@ -23,24 +27,87 @@ extern "C" { // ffmpeg
 #include <libavformat/avformat.h>
 }
 
+/* Custom C++ Libraries */
+#include "common/bounded_queue.h"
+#include "common/clock.h"
+#include "mapped_file_io.h"
+
+
+/* ========================== Defines ========================== */
+#define READY_FRAMES 8  // Frames decoded ahead of their presentation time.
+#define VIDEO_FILE_MMAP  // Comment out to read local files through the default (buffered read()) file protocol.
+
 
 /* ========================== Classes ========================== */
 
 /**
  * @brief Class to obtain frames from a file.
+ *
+ * @details After startStream(), a background thread decodes ahead into a bounded queue of (pooled) frames,
+ * which getFrame() hands out once their presentation time is reached, so the caller never waits on the decoder.
+ * A keyframe index, built when opening the file, allows seeking and looping.
  */
 class VideoFile final: public FrameProvider {
+    /* A decoded frame, waiting for its presentation time. */
+    struct ReadyFrame {
+        Image image;
+        double time = 0.0;        // Presentation time (seconds, on the caller's clock).
+        uint64_t generation = 0;  // Frames decoded before the latest seek are dropped.
+    };
+
    public:
-    VideoFile(std::string const& filepath);
+    /* Position of a keyframe in the file. */
+    struct Keyframe {
+        double  time      = 0.0;  // Seconds since the first keyframe.
+        int64_t timestamp = 0;    // In the stream time base.
+        int64_t position  = -1;   // Byte position in the file (-1 if unknown).
+    };
+
+   public:
+    VideoFile(std::string const& filepath, bool loop=false);
     ~VideoFile();
+
+    /**
+     * @brief Returns the newest frame due at curr_time, or an empty frame if no new frame is due
+     * (never waits on the decoder).
+     */
     Frame getFrame(double curr_time, PixelFormat fmt) override;
-    void startStream() override {return;};
-    void stopStream() override {return;};
+
+    /**
+     * @brief Block until the next decoded frame is due (on the clock of the getFrame() caller), or at most timeout_ms.
+     */
+    bool waitForFrame(int timeout_ms) override;
+    void startStream() override;  // Start decoding ahead.
+    void stopStream() override;
+
+    /**
+     * @brief Continue playback at the given time (seconds since the start), from the caller's current time on.
+     * @note Thread-safe, applied by the decode thread.
+     */
+    void seek(double time);
+
+    /**
+     * @brief Restart from the beginning at the end of the file (instead of holding the last frame).
+     */
+    void setLoop(bool loop) { loop_ = loop; };
+
+    double duration() const { return duration_; };
+    std::vector<Keyframe> const& keyframes() const { return keyframes_; };
+
+   private:
+    void buildKeyframeIndex();
+    void decodeAhead();  // Decode stage.
+    bool decodeFrame();  // False at the end of the file.
+    void applySeek(double time);  // Also drops the queued frames.
+    bool rewind(double time);
+    void stopDecoding();
+    void recycle(Image &image);
 
    private:
     std::string filepath_;
 
     /* Container Variables */
+    std::unique_ptr<MappedFileIO> mapped_io_;       // Local files only (outlives the format context).
     AVFormatContext *ptr_format_context = nullptr;  // Header information
 
     /* Codec Variables */
@@ -53,7 +120,31 @@ class VideoFile final: public FrameProvider {
     AVPacket *ptr_packet = nullptr;  // Encoded
     AVFrame *ptr_frame   = nullptr;  // Decoded
 
-    /* Frame Data */
+    /* Keyframe Index */
+    std::vector<Keyframe> keyframes_;
+    int64_t start_timestamp_ = 0;  // Timestamp of the first keyframe.
+    double duration_ = 0.0;
+
+    /* Decode Stage */
+    std::thread decode_thread_;
+    std::atomic<bool> decoding_ = {false};
+    std::atomic<bool> loop_;
+    std::atomic<double> seek_target_ = {-1.0};  // Pending seek (seconds), or negative.
+    std::atomic<uint64_t> generation_ = {0};
+    std::atomic<double> caller_time_ = {0.0};   // Latest curr_time given to getFrame().
+    std::atomic<PixelFormat> requested_format_ = {PixelFormat::YUV420P};
+    double time_offset_ = 0.0;  // Caller time of the file's time 0 (only touched by the decode stage).
+    double skip_until_  = 0.0;  // Decode, but drop frames before this file time (after a seek).
+
+    /* Ready Frames & Buffer Pool */
+    BoundedQueue<ReadyFrame> ready_frames_;
+    std::mutex pool_mutex_;
+    std::vector<Image> pool_;
+
+    /* Frame Data (only touched by the getFrame() caller) */
+    timestamp_t caller_clock_;  // When getFrame() was last called (at caller_time_).
+    bool has_caller_clock_ = false;
     Frame frame_data_ = {};
-    double play_time_ = -1.0;
+    ReadyFrame pending_ = {};  // Popped, but not yet due.
+    bool has_pending_ = false;
 };
@@ -14,8 +14,8 @@
 
 /* Standard C++ Libraries */
 #include <stdexcept>
+#include <algorithm>
 #include <string>
-#include <mutex>
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
@@ -23,8 +23,22 @@
 #include "video/image.h"
 
 
+/* ============================ Defines ============================= */
+#define PACKET_QUEUE_SIZE 8   // Max. number of packets buffered between the demux and decode stage.
+#define CHUNK_QUEUE_SIZE  128 // Same, for chunked streams (a few frames worth of MTU sized slices).
+#define DECODER_THREADS   4   // Max. number of slice decoding threads.
+#define FEEDBACK_INTERVAL 1.0 // Seconds between video feedback reports.
+#define LATENCY_INTERVAL  5.0 // Seconds between latency reports.
+
+enum Stage {DEMUX, QUEUE, DECODE, COPY};
+
+static const char* LATENCY_STAGE_NAMES[] = {"capture->encode", "encode", "send", "network", "decode", "display", "total"};
+
+
 /* ============================ Classes ============================ */
-VideoReciever::VideoReciever(std::string const& address): address_(address){
+VideoReciever::VideoReciever(std::string const& address, bool chunked): 
+    address_(address), chunked_(chunked), packet_queue_(chunked ? CHUNK_QUEUE_SIZE : PACKET_QUEUE_SIZE), 
+    stats_("VideoReciever", {"demux", "queue", "decode", "copy"}) {
     LOGI("Using libav-format version %d.%d.%d", LIBAVFORMAT_VERSION_MAJOR, LIBAVFORMAT_VERSION_MINOR, LIBAVFORMAT_VERSION_MICRO);
     LOGI("Using libav-codec version %d.%d.%d", LIBAVCODEC_VERSION_MAJOR, LIBAVCODEC_VERSION_MINOR, LIBAVCODEC_VERSION_MICRO);
     #if LIBAVCODEC_VERSION_MAJOR < 60
@@ -35,6 +49,10 @@ VideoReciever::VideoReciever(std::string const& address): address_(address){
     // av_log_set_level(AV_LOG_DEBUG);
     av_log_set_level(AV_LOG_QUIET);
 
+    /* The stream is identified (e.g. in feedback) by its port. */
+    port_ = streamPort(address);
+    catch_up_ = CatchUpController(port_);
+
     /* ---------------- Read Container Context ----------------- */
     /* This context is used during the muxing operation. */
     LOGI("Waiting for video data from: '%s'", address.c_str());
@@ -45,6 +63,11 @@ VideoReciever::VideoReciever(std::string const& address): address_(address){
         throw std::runtime_error("Failed to allocate memory for a Format Context");
     }
 
+    /* Hand every PES packet (slice) to the decoder as is, the parser would hold on to it until the next frame starts. */
+    if (chunked_) {
+        ptr_format_context->flags |= AVFMT_FLAG_NOPARSE | AVFMT_FLAG_NOFILLIN;
+    }
+
     /* Get Header Information */
     // udp: mpegts (av_find_input_format("mpegts"))
     // tcp: mpegts
@@ -131,6 +154,17 @@ VideoReciever::VideoReciever(std::string const& address): address_(address){
         throw std::runtime_error("Failed to copy CODEC params to codec context");
     }
 
+    /* Decode each frame as soon as its packet arrives, and spread its slices over multiple threads. */
+    // NOTE: Frame threading would add one frame of delay per thread, slice threading does not.
+    ptr_codec_context->thread_type  = FF_THREAD_SLICE;
+    ptr_codec_context->thread_count = std::max(1, std::min<int>(DECODER_THREADS, std::thread::hardware_concurrency()));
+    ptr_codec_context->flags  |= AV_CODEC_FLAG_LOW_DELAY;
+    ptr_codec_context->flags2 |= AV_CODEC_FLAG2_FAST;
+    if (chunked_) {
+        ptr_codec_context->flags2 |= AV_CODEC_FLAG2_CHUNKS;  // Packets may hold part of a frame.
+    }
+    LOGI("Decoding with %d slice threads%s.", ptr_codec_context->thread_count, chunked_ ? ", slice by slice" : "");
+
     /* Initialize the AVCodecContext to use the given AVCodec. */
     if (avcodec_open2(ptr_codec_context, ptr_codec, NULL) < 0) {
         LOGE("Failed to open CODEC through avcodec_open2.");
@@ -158,9 +192,12 @@ VideoReciever::VideoReciever(std::string const& address): address_(address){
     }
     av_frame_make_writable(ptr_frame);
 
-    /* Create Userspace Frame Buffer. */
-    frame_data_ = {};
-    frame_data_.image = Image(ptr_frame->width, ptr_frame->height, PixelFormat::YUV422P);
+    /* Publish a black frame until the first frame is decoded (other buffers are allocated on first use). */
+    Frame &initial_frame = frame_buffer_.back().frame;
+    PixelFormat initial_format = (ptr_codec_context->pix_fmt == AV_PIX_FMT_GRAY16LE) ? PixelFormat::DEPTH16 : PixelFormat::YUV420P;
+    initial_frame.image = Image(ptr_frame->width, ptr_frame->height, initial_format);
+    initial_frame.image.zero();
+    frame_buffer_.publish();
 
     /* Allocate Packet */
     ptr_packet = av_packet_alloc();
@@ -171,6 +208,14 @@ VideoReciever::VideoReciever(std::string const& address): address_(address){
 }
 
 VideoReciever::~VideoReciever() {
+    stopDecoding();
+
+    /* Free packets that were never decoded. */
+    QueuedPacket queued;
+    while (packet_queue_.tryPop(queued)) {
+        av_packet_free(&queued.packet);
+    }
+
     av_packet_free(&ptr_packet);
     av_frame_free(&ptr_frame);
     avformat_close_input(&ptr_format_context);
@@ -186,93 +231,325 @@ void VideoReciever::iteration() {
 
 void VideoReciever::setup() {
     LOGI("Running VideoReciever (TID = %d)", gettid());
+
+    /* A previous stopDecoding() closed the queue: drop its stale packets, and accept new ones again. */
+    QueuedPacket queued;
+    while (packet_queue_.tryPop(queued)) {
+        av_packet_free(&queued.packet);
+    }
+    packet_queue_.reopen();
+
+    decoding_ = true;
+    decode_thread_ = std::thread([this]() {
+        LOGI("Running VideoReciever decoder (TID = %d)", gettid());
+        while (decoding_) {
+            decode(100);
+        }
+    });
+};
+
+void VideoReciever::cleanup() {
+    stopDecoding();
+};
+
+void VideoReciever::stopDecoding() {
+    decoding_ = false;
+    packet_queue_.close();
+    if (decode_thread_.joinable()) {
+        decode_thread_.join();
+    }
 };
 
 /**
- * @brief Recieve a frame over the network.
+ * @brief Read the next video packet from the network, and queue it for decoding (Blocking).
  */
 void VideoReciever::recieve() {
-    int response = 0;
-    bool found_packet = false;
-    bool decoded_frame = false;
-
-    /* Try to decode frame. */
-    response = avcodec_receive_frame(ptr_codec_context, ptr_frame);
-    if (response == AVERROR(EAGAIN) || response == AVERROR_EOF) {
-        decoded_frame = false;
-    } else if (response < 0) {
-        LOGW("Issue while receiving a frame from the decoder: %d", (response));
+    timestamp_t start_time = common::now();
+    int response = av_read_frame(ptr_format_context, ptr_packet);
+    if (response < 0) {
+        char error_str[256];
+        av_strerror(response, error_str, 256);
+        LOGW("Issue while reading a packet from the stream: %s", error_str);
         return;
-    } else {
-        decoded_frame = true;
     }
 
-    /* Retrieve Video Stream Packets until we can decode the next frame (BLOCKING). */
-    while (!decoded_frame && av_read_frame(ptr_format_context, ptr_packet) >= 0) {
+    /* Only process selected Video Stream Packets. */
+    if (ptr_packet->stream_index != video_stream_index) {
+        av_packet_unref(ptr_packet);
+        return;
+    }
 
-        /* Only process selected Video Stream Packets. */
-        if (ptr_packet->stream_index == video_stream_index) {
-            // LOGI("AVPacket->pts %" PRId64 "\t", ptr_packet->pts);
+    /* Hand over the packet data (without copying) to the decode stage. */
+    QueuedPacket queued = {av_packet_alloc(), common::now(), common::micros()};
+    if (!queued.packet) {
+        LOGW("Failed to allocate memory for AVPacket, dropping packet.");
+        av_packet_unref(ptr_packet);
+        return;
+    }
+    av_packet_move_ref(queued.packet, ptr_packet);
+    if (ptr_codec_context->codec_id == AV_CODEC_ID_H264) {  // Only H.264 streams carry the latency SEI.
+        queued.stamped = extractLatencySEI(queued.packet->data, queued.packet->size, queued.stamp);
+    }
+    stats_.add(DEMUX, common::seconds(start_time, queued.enqueued));
 
-            /* Send packet to decoder */
-            response = avcodec_send_packet(ptr_codec_context, ptr_packet);
-            if (response < 0) {
-                LOGW("Issue while sending a packet to the decoder: %d", (response));
-                return;
-            }
+    /* Blocks while the decoder lags behind (back-pressure). */
+    if (!packet_queue_.push(queued)) {
+        av_packet_free(&queued.packet);  // Queue closed, shutting down.
+    }
+}
+
+/**
+ * @brief Decode one queued packet, and publish all frames it completes.
+ */
+void VideoReciever::decode(int timeout_ms) {
+    QueuedPacket queued;
+    if (!packet_queue_.pop(queued, timeout_ms)) {
+        return;
+    }
+
+    timestamp_t dequeue_time = common::now();
+    stats_.add(QUEUE, common::seconds(queued.enqueued, dequeue_time));
+
+    if (queued.packet->flags & AV_PKT_FLAG_CORRUPT) {
+        feedback_.corrupted++;  // E.g. missing transport stream packets.
+    }
+
+    /* Drop the packet when catching up with live video (the slices of a frame all go the same way). */
+    bool h264 = (ptr_codec_context->codec_id == AV_CODEC_ID_H264);
+    bool continuation = chunked_ && h264 && isSliceContinuation(queued.packet->data, queued.packet->size);
+    bool skip = continuation ? skipping_frame_ : catchUp(queued.packet, common::micros());
+    if (!continuation) {
+        skipping_frame_ = skip;
+        frame_start_ = queued;  // Its timing & stamp belong to the frame the decoder outputs.
+        frame_start_.packet = nullptr;
+    }
+    if (skip) {
+        av_packet_free(&queued.packet);
+        if (!continuation) {
+            feedback_.skipped++;
+            skipped_count_++;
+        }
+        reportFeedback();
+        return;
+    }
 
-            /* Decode new frame */
-            response = avcodec_receive_frame(ptr_codec_context, ptr_frame);
-            if (response != AVERROR(EAGAIN) && response != AVERROR_EOF && response < 0) {
-                LOGW("Issue while receiving a frame from the decoder: %d", (response));
-                return;
-            } else if (response >= 0) {
-                decoded_frame = true;
+    /* Send packet to decoder */
+    int response = avcodec_send_packet(ptr_codec_context, queued.packet);
+    av_packet_free(&queued.packet);
+    if (response < 0) {
+        LOGW("Issue while sending a packet to the decoder: %d", (response));
+        return;
+    }
+
+    /* Decode new frames (the first one includes the time spent in send_packet) */
+    timestamp_t decode_start = dequeue_time;
+    while (true) {
+        response = avcodec_receive_frame(ptr_codec_context, ptr_frame);
+        if (response == AVERROR(EAGAIN) || response == AVERROR_EOF) {
+            break;
+        } else if (response < 0) {
+            LOGW("Issue while receiving a frame from the decoder: %d", (response));
+            break;
+        }
+
+        timestamp_t copy_start = common::now();
+        stats_.add(DECODE, common::seconds(decode_start, copy_start));
+
+        /* Process New Frame (kept in the stream's own pixel format). */
+        PixelFormat format = PixelFormat::YUV420P;
+        if (ptr_frame->format == AV_PIX_FMT_YUV422P) {
+            format = PixelFormat::YUV422P;
+        } else if (ptr_frame->format == AV_PIX_FMT_NV12) {
+            format = PixelFormat::NV12;  // E.g. hardware decoders.
+        } else if (ptr_frame->format == AV_PIX_FMT_GRAY16LE) {
+            format = PixelFormat::DEPTH16;  // Lossless depth (FFV1).
+        } else if (ptr_frame->format != AV_PIX_FMT_YUV420P) {
+            LOGW("Currnelty only YUV420P, YUV422P, NV12 & GRAY16LE are supported.");
+        }
+
+        int num_planes = Image::getLayout(format, ptr_frame->width, ptr_frame->height).num_planes;
+        ImageView image_view = ImageView(
+            std::vector<uint8_t*>(ptr_frame->data, ptr_frame->data + num_planes),
+            std::vector<int>(ptr_frame->linesize, ptr_frame->linesize + num_planes),
+            ptr_frame->width, ptr_frame->height, format
+        );
+
+        /* Copy into the (decoder owned) back buffer, and hand it to the reader without locking. */
+        DecodedFrame &back = frame_buffer_.back();
+        Frame &back_frame = back.frame;
+        if (back_frame.image.getWidth() != ptr_frame->width || back_frame.image.getHeight() != ptr_frame->height || back_frame.image.getFormat() != format) {
+            back_frame.image = Image(ptr_frame->width, ptr_frame->height, format);
+        }
+
+        ImageView buffer_view = back_frame.image.view();
+        buffer_view.copyFrom(image_view);
+
+        /* Low delay decoding: the frame belongs to the packet (or slices) just sent. */
+        QueuedPacket const& start = frame_start_;
+        back.decoded_us  = common::micros();
+        back.stamped     = start.stamped;
+        back.stamp       = start.stamp;
+        frame_buffer_.publish();
+
+        if (start.stamped) {
+            latency_[CAPTURE_TO_ENCODE].add((start.stamp.encode_start_us - start.stamp.capture_us) * 1e-6);
+            latency_[ENCODE].add((start.stamp.encode_end_us - start.stamp.encode_start_us) * 1e-6);
+            latency_[SEND].add((start.stamp.send_us - start.stamp.encode_end_us) * 1e-6);
+            latency_[DECODE].add((back.decoded_us - start.recieved_us) * 1e-6);
+            if (clock_offset_ && clock_offset_->valid()) {
+                latency_[NETWORK].add((start.recieved_us + clock_offset_->offset() - start.stamp.send_us) * 1e-6);
+            }
+        }
+        decode_start = common::now();
+        stats_.add(COPY, common::seconds(copy_start, decode_start));
+
+        /* Track reception quality. */
+        int64_t pts = ptr_frame->best_effort_timestamp;
+        if (pts != AV_NOPTS_VALUE) {
+            if (feedback_.last_pts != AV_NOPTS_VALUE && pts > feedback_.last_pts) {
+                int64_t delta = pts - feedback_.last_pts;
+                feedback_.min_delta = (feedback_.min_delta > 0) ? std::min(feedback_.min_delta, delta) : delta;
             }
+            if (feedback_.first_pts == AV_NOPTS_VALUE) {
+                feedback_.first_pts = pts;
+            }
+            feedback_.last_pts = pts;
+        }
+        if (ptr_frame->decode_error_flags || (ptr_frame->flags & AV_FRAME_FLAG_CORRUPT)) {
+            feedback_.corrupted++;
         }
+        feedback_.frames++;
+        feedback_.lag_total += common::seconds(frame_start_.enqueued, decode_start);
+    }
 
-        av_packet_unref(ptr_packet);
+    stats_.report(1.0);
+    reportFeedback();
+    reportLatency();
+}
+
+/**
+ * @brief Decide whether to skip the given packet, to catch up with live video (see CatchUpController).
+ * @return True if the packet should be dropped without decoding.
+ */
+bool VideoReciever::catchUp(AVPacket *packet, int64_t dequeue_us) {
+    CatchUpController::Packet info;
+    int64_t dts = (packet->dts != AV_NOPTS_VALUE) ? packet->dts : packet->pts;
+    if (dts != AV_NOPTS_VALUE) {
+        info.has_dts = true;
+        info.dts_us  = av_rescale_q(dts, ptr_format_context->streams[video_stream_index]->time_base, AVRational{1, 1000000});
+    }
+
+    /* H.264 is inspected directly, the flags depend on the demuxer (& parser). */
+    bool h264 = (ptr_codec_context->codec_id == AV_CODEC_ID_H264);
+    info.random_access = (packet->flags & AV_PKT_FLAG_KEY) || (h264 && isRandomAccessPoint(packet->data, packet->size));
+    info.disposable = (packet->flags & AV_PKT_FLAG_DISPOSABLE) || (h264 && isDisposableAccessUnit(packet->data, packet->size));
+    bool backlog = (packet_queue_.size() + 1 >= packet_queue_.capacity());  // The demux stage blocks.
+
+    bool skip = catch_up_.skip(info, backlog, dequeue_us);
+    lag_ms_         = catch_up_.lagMs();
+    catching_up_    = catch_up_.active();
+    catch_up_count_ = catch_up_.catchUps();
+    return skip;
+}
+
+/**
+ * @brief Log the latency histograms of every stage, and reset them.
+ */
+void VideoReciever::reportLatency() {
+    timestamp_t curr_time = common::now();
+    if (common::seconds(last_latency_report_, curr_time) < LATENCY_INTERVAL || latency_[DECODE].count() == 0) {
+        return;
     }
 
-    if (!decoded_frame) {
-        return; 
+    LOGI("VideoReciever (port %d) latency [mean/p50/p95/max]:", port_);
+    for (int stage = 0; stage < LATENCY_STAGE_COUNT; stage++) {
+        LOGI("  > %-16s: %s", LATENCY_STAGE_NAMES[stage], latency_[stage].summary().c_str());
+        latency_[stage].reset();
+    }
+    if (!clock_offset_ || !clock_offset_->valid()) {
+        LOGI("  (network & total latency need a clock offset estimate)");
     }
+    Stats current = stats();
+    LOGI("  > behind live     : %.0f ms (%lu catch-ups, %lu packets skipped)", current.lag_ms, current.catch_ups, current.skipped);
 
-    // double play_time_ = static_cast<double>(ptr_frame->pts) * static_cast<double>(ptr_format_context->streams[video_stream_index]->time_base.num) / static_cast<double>(ptr_format_context->streams[video_stream_index]->time_base.den);
-    // LOGI(
-    //     "Frame %d (type=%c, size=%d bytes, format=%d) pts %ld key_frame %d time %fs [DTS %d]",
-    //     ptr_codec_context->frame_number,
-    //     av_get_picture_type_char(ptr_frame->pict_type),
-    //     ptr_frame->pkt_size,
-    //     ptr_frame->format,
-    //     ptr_frame->pts,
-    //     ptr_frame->key_frame,
-    //     play_time_,
-    //     ptr_frame->coded_picture_number
-    // );
+    last_latency_report_ = curr_time;
+}
 
-    /* Process New Frame. */
-    if (ptr_frame->format != AV_PIX_FMT_YUV422P) {
-        LOGW("Currnelty only YUV422P is supported.");
+/**
+ * @brief Send the reception quality since the previous report to the feedback sink.
+ */
+void VideoReciever::reportFeedback() {
+    timestamp_t curr_time = common::now();
+    if (!feedback_sink_ || common::seconds(last_feedback_, curr_time) < FEEDBACK_INTERVAL) {
+        return;
     }
 
-    ImageView image_view = ImageView(
-        {ptr_frame->data[0], ptr_frame->data[1], ptr_frame->data[2]},
-        {ptr_frame->linesize[0], ptr_frame->linesize[1], ptr_frame->linesize[2]},
-        frame_data_.image.getWidth(), frame_data_.image.getHeight(), PixelFormat::YUV422P
-    );
-    std::lock_guard lock(frame_data_mutex_);
-    ImageView buffer_view = frame_data_.image.view();
-    buffer_view.copyFrom(image_view);
+    /* Frames missing from the pts sequence were lost in transit. */
+    int64_t expected = feedback_.frames;
+    if (feedback_.min_delta > 0 && feedback_.first_pts != AV_NOPTS_VALUE && feedback_.last_pts >= feedback_.first_pts) {
+        expected = std::max(expected, (feedback_.last_pts - feedback_.first_pts) / feedback_.min_delta + 1);
+    }
+    int64_t lost = std::max<int64_t>(expected - feedback_.frames - feedback_.skipped, 0) + feedback_.corrupted;
+
+    VideoFeedback feedback = {};
+    feedback.port       = port_;
+    feedback.frames     = feedback_.frames;
+    feedback.loss       = (expected > 0) ? std::min(1.0f, static_cast<float>(lost) / expected) : 0.0f;
+    feedback.decode_lag = (feedback_.frames > 0) ? static_cast<float>(feedback_.lag_total / feedback_.frames) : 0.0f;
+    feedback_sink_->sink(feedback);
+
+    /* Start a new period, which expects the frame after the last one (the frame interval rarely changes). */
+    FeedbackCounters previous = feedback_;
+    feedback_ = {};
+    feedback_.min_delta = previous.min_delta;
+    feedback_.last_pts  = previous.last_pts;
+    if (previous.last_pts != AV_NOPTS_VALUE && previous.min_delta > 0) {
+        feedback_.first_pts = previous.last_pts + previous.min_delta;
+    }
+    last_feedback_ = curr_time;
+}
 
-    return;
+VideoReciever::Stats VideoReciever::stats() const {
+    Stats stats;
+    stats.lag_ms      = lag_ms_;
+    stats.catching_up = catching_up_;
+    stats.catch_ups   = catch_up_count_;
+    stats.skipped     = skipped_count_;
+    return stats;
 }
 
 /**
  * @brief Get the last frame.
  */
 Frame VideoReciever::getFrame(double curr_time, PixelFormat fmt) {
-    std::lock_guard lock(frame_data_mutex_);
-    frame_data_.image.to(fmt);
-    return frame_data_;
+    bool new_frame = frame_buffer_.update();
+
+    /* Only convert when a new frame arrived, or another format is requested. */
+    if (new_frame || output_frame_.image.getFormat() != fmt) {
+        DecodedFrame &front = frame_buffer_.front();
+        Image &latest = front.frame.image;
+
+        if (output_frame_.image.getFormat() != fmt || output_frame_.image.getWidth() != latest.getWidth() || output_frame_.image.getHeight() != latest.getHeight()) {
+            output_frame_.image = Image(latest.getWidth(), latest.getHeight(), fmt);
+        }
+
+        ImageView latest_view = latest.view();
+        ImageView output_view = output_frame_.image.view();
+        output_view.copyFrom(latest_view);
+
+        /* Frames are displayed right after they are fetched. */
+        bool synced = clock_offset_ && clock_offset_->valid();
+        output_frame_.sequence  = front.stamped ? front.stamp.sequence : 0;
+        output_frame_.timestamp = (front.stamped && synced) ? front.stamp.capture_us - clock_offset_->offset() : 0;
+
+        if (new_frame && front.stamped) {
+            int64_t display_us = common::micros();
+            latency_[DISPLAY].add((display_us - front.decoded_us) * 1e-6);
+            if (synced) {
+                latency_[TOTAL].add((display_us + clock_offset_->offset() - front.stamp.capture_us) * 1e-6);
+            }
+        }
+    }
+
+    return output_frame_;
 }
\ No newline at end of file
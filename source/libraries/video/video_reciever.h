@@ -14,7 +14,8 @@
 /* Standard C++ Libraries */
 #include <vector>
 #include <string>
-#include <mutex>
+#include <thread>
+#include <atomic>
 
 /* Third Party C++ Libraries */
 extern "C" { // ffmpeg
@@ -24,31 +25,109 @@ extern "C" { // ffmpeg
 }
 
 /* Custom C++ Libraries */
+#include "common/video_feedback.h"
+#include "common/bounded_queue.h"
+#include "common/clock_sync.h"
+#include "common/histogram.h"
+#include "common/triple_buffer.h"
+#include "common/stage_stats.h"
 #include "common/looper.h"
+#include "common/clock.h"
 #include "frame_provider.h"
+#include "catch_up_controller.h"
+#include "latency_sei.h"
 
 
 /* ========================== Classes ========================== */
 
 /**
- * @brief Class to obtain frames from a file.
+ * @brief Class to obtain frames from a network stream.
+ *
+ * @details Runs as a two stage pipeline: the Looper thread demuxes packets from the stream into a
+ * bounded queue, while a second thread decodes (slice threaded) and publishes the frames.
+ * This way waiting for the network and decoding overlap instead of adding up.
+ *
+ * A chunked reciever decodes the slices of a frame as they arrive (see EncoderConfig::slice_packets), instead of
+ * waiting for the whole frame.
+ *
+ * When the decoded video falls behind live (e.g. after the process stalled, leaving a backlog in the socket), it
+ * catches up: non-reference frames are dropped, and packets are skipped up to the next keyframe or intra refresh
+ * recovery point, instead of decoding the whole backlog in order.
  */
 class VideoReciever final: public Looper, public FrameProvider {
+    struct QueuedPacket {
+        AVPacket    *packet = nullptr;
+        timestamp_t  enqueued;
+        int64_t      recieved_us = 0;  // common::micros()
+        bool         stamped = false;  // Whether the stamp was found in the packet.
+        LatencyStamp stamp;
+    };
+
+    struct DecodedFrame {
+        Frame   frame;
+        int64_t decoded_us = 0;
+        bool    stamped = false;
+        LatencyStamp stamp;
+    };
+
+    /* Glass-to-glass latency stages. */
+    enum LatencyStage {CAPTURE_TO_ENCODE, ENCODE, SEND, NETWORK, DECODE, DISPLAY, TOTAL, LATENCY_STAGE_COUNT};
+
    public:
-    VideoReciever(std::string const& address=std::string("udp://127.0.0.1:8999"));
+    struct Stats {
+        double   lag_ms      = 0.0;    // How far the decoded video is behind live (packet timestamps vs. wall clock).
+        bool     catching_up = false;
+        uint64_t catch_ups   = 0;      // Times the reciever fell behind, and started catching up.
+        uint64_t skipped     = 0;      // Packets dropped without decoding, while catching up.
+    };
+
+   public:
+    /**
+     * @param chunked: Whether the stream sends every slice as its own packet.
+     */
+    VideoReciever(std::string const& address=std::string("udp://127.0.0.1:8999"), bool chunked=false);
     ~VideoReciever();
 
     void iteration() override;
     void setup() override;
+    void cleanup() override;
     
-    void recieve(); // Blocking
+    void recieve(); // Blocking, demux stage.
 
+    /**
+     * @note Never blocks on the decoder, but may only be called from a single (e.g. the GUI) thread.
+     */
     Frame getFrame(double curr_time, PixelFormat fmt) override;
     void startStream() override {};
     void stopStream() override {};
 
+    /**
+     * @brief Periodically report the reception quality to the given sink (e.g. the robot, for adaptive bitrate).
+     * @note Set before starting the reciever thread.
+     */
+    void setFeedbackSink(VideoFeedbackSink *sink) { feedback_sink_ = sink; };
+
+    /**
+     * @brief Estimate of the transmitter's clock, needed for the network & total latency.
+     * @note Set before starting the reciever thread.
+     */
+    void setClockOffset(ClockOffset const *clock_offset) { clock_offset_ = clock_offset; };
+
+    /**
+     * @note Thread-safe.
+     */
+    Stats stats() const;
+
+   private:
+    void decode(int timeout_ms);  // Decode stage.
+    bool catchUp(AVPacket *packet, int64_t dequeue_us);
+    void stopDecoding();
+    void reportFeedback();
+    void reportLatency();
+
    private:
     std::string address_;
+    bool chunked_;
     FrameProvider *frame_provider_ = nullptr;
 
     /* Container Variables (for muxing) */
@@ -62,11 +141,46 @@ class VideoReciever final: public Looper, public FrameProvider {
     AVCodec const     *ptr_codec            = nullptr;
 
     /* Stream Slice Variables */
-    AVPacket *ptr_packet = nullptr;  // Encoded
-    AVFrame  *ptr_frame  = nullptr;  // Decoded
+    AVPacket *ptr_packet = nullptr;  // Encoded (demux stage)
+    AVFrame  *ptr_frame  = nullptr;  // Decoded (decode stage)
+
+    /* Pipeline */
+    BoundedQueue<QueuedPacket> packet_queue_;
+    QueuedPacket frame_start_ = {};  // First packet of the frame being decoded (without its data).
+    std::thread decode_thread_;
+    std::atomic<bool> decoding_ = {false};
+    StageStats stats_;
+
+    /* Feedback (only touched by the decode stage) */
+    struct FeedbackCounters {
+        uint32_t frames    = 0;
+        uint32_t corrupted = 0;
+        uint32_t skipped   = 0;  // Recieved, but not decoded (catching up).
+        double   lag_total = 0.0;
+        int64_t  first_pts = AV_NOPTS_VALUE;
+        int64_t  last_pts  = AV_NOPTS_VALUE;
+        int64_t  min_delta = 0;  // Smallest pts increment, i.e. one frame interval.
+    };
+    VideoFeedbackSink *feedback_sink_ = nullptr;
+    FeedbackCounters feedback_ = {};
+    timestamp_t last_feedback_ = common::now();
+    uint16_t port_ = 0;
+
+    /* Catch-up */
+    CatchUpController catch_up_;  // Only touched by the decode stage.
+    bool skipping_frame_ = false;  // Whether the rest of the current frame's slices are skipped too (chunked only).
+    std::atomic<double>   lag_ms_          = {0.0};
+    std::atomic<bool>     catching_up_     = {false};
+    std::atomic<uint64_t> catch_up_count_  = {0};
+    std::atomic<uint64_t> skipped_count_   = {0};
 
     /* Frame Data */
-    Frame  frame_data_ = {};
-    int    frame_pts   = 0;
-    std::mutex frame_data_mutex_;
+    TripleBuffer<DecodedFrame> frame_buffer_;  // Decoder thread writes, getFrame() reads.
+    Frame  output_frame_ = {};                 // Latest frame, converted to the last requested format.
+
+    /* Latency */
+    ClockOffset const *clock_offset_ = nullptr;
+    Histogram latency_[LATENCY_STAGE_COUNT];
+    timestamp_t last_latency_report_ = common::now();
+    int    frame_pts     = 0;
 };
@@ -0,0 +1,280 @@
+/**
+ * @file video_recorder.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Implements a recorder that remuxes already encoded packets into rolling segment files.
+ * @link based on: https://www.ffmpeg.org/doxygen/trunk/remux_8c-example.html
+ */
+
+/* ============================ Includes ============================ */
+#include "video_recorder.h"
+
+/* Standard C Libraries */
+#include <string.h>  // memcpy()
+#include <time.h>    // time(), localtime_r(), strftime()
+#include <unistd.h>  // access()
+
+/* Standard C++ Libraries */
+#include <stdexcept>
+
+/* Custom C++ Libraries */
+#include "common/logger.h"
+#include "latency_sei.h"
+
+
+/* ============================ Classes ============================ */
+VideoRecorder::VideoRecorder(std::string const& directory, double segment_seconds, std::string const& extension):
+    directory_(directory), extension_(extension), segment_seconds_(segment_seconds), queue_(RECORDER_QUEUE_SIZE) {
+    /* Fail early, instead of on the first segment. */
+    const AVOutputFormat *format = av_guess_format(NULL, ("segment." + extension_).c_str(), NULL);
+    if (!format) {
+        LOGE("No container format found for '.%s' recordings.", extension_.c_str());
+        throw std::runtime_error("Unknown recording container format");
+    }
+}
+
+VideoRecorder::~VideoRecorder() {
+    stop();
+    closeSegment();
+
+    /* Packets left in the queue (when never started). */
+    QueuedPacket queued;
+    while (queue_.tryPop(queued)) {
+        av_packet_free(&queued.packet);
+    }
+
+    for (Stream &stream: streams_) {
+        avcodec_parameters_free(&stream.parameters);
+    }
+}
+
+void VideoRecorder::setStream(int stream, AVCodecContext const *context) {
+    AVCodecParameters *parameters = avcodec_parameters_alloc();
+    if (!parameters || avcodec_parameters_from_context(parameters, context) < 0) {
+        avcodec_parameters_free(&parameters);
+        LOGE("Could not copy the codec parameters of recorded stream %d.", stream);
+        throw std::runtime_error("Failed to copy codec parameters");
+    }
+
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    if (static_cast<int>(streams_.size()) <= stream) {
+        streams_.resize(stream + 1);
+    }
+    Stream &entry = streams_[stream];
+
+    /* Bitrate changes don't show up in the container, only restart the segment for a different stream layout. */
+    bool changed = !entry.parameters ||
+        entry.parameters->codec_id != parameters->codec_id || entry.parameters->format != parameters->format ||
+        entry.parameters->width    != parameters->width    || entry.parameters->height != parameters->height ||
+        entry.parameters->profile  != parameters->profile;
+    if (!changed) {
+        avcodec_parameters_free(&parameters);
+        return;
+    }
+
+    /* Changed parameters only apply from the next keyframe on. */
+    avcodec_parameters_free(&entry.parameters);
+    entry.parameters = parameters;
+    entry.waiting_for_keyframe = true;
+    parameters_version_++;
+}
+
+void VideoRecorder::write(int stream, AVPacket const *packet, AVRational time_base) {
+    bool keyframe = packet->flags & AV_PKT_FLAG_KEY;
+
+    std::lock_guard<std::mutex> lock(streams_mutex_);
+    if (stream >= static_cast<int>(streams_.size()) || !streams_[stream].parameters) {
+        return;
+    }
+    Stream &entry = streams_[stream];
+
+    /* A GOP is recorded completely, or not at all. */
+    if (entry.waiting_for_keyframe && !keyframe) {
+        dropped_++;
+        return;
+    }
+
+    /**
+     * @note: Streams meant for live streaming repeat the parameter sets (SPS / PPS) in-band, instead of in the
+     * codec extradata, which containers like MKV / MP4 need in their header.
+     */
+    if (keyframe && entry.parameters->extradata_size == 0 && entry.parameters->codec_id == AV_CODEC_ID_H264) {
+        size_t size = findLatencySEIPosition(packet->data, packet->size);  // Everything in front of the first slice.
+        entry.parameters->extradata = static_cast<uint8_t*>(av_mallocz(size + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (entry.parameters->extradata) {
+            memcpy(entry.parameters->extradata, packet->data, size);
+            entry.parameters->extradata_size = static_cast<int>(size);
+        }
+    }
+
+    /* The packet data is reference counted, so this does not copy it. */
+    QueuedPacket queued = {av_packet_clone(packet), stream, time_base, parameters_version_};
+    if (!queued.packet) {
+        LOGW("Failed to reference a packet for recording.");
+        entry.waiting_for_keyframe = true;
+        dropped_++;
+        return;
+    }
+
+    /* Never hold up the caller, drop the rest of this GOP instead. */
+    if (!queue_.push(queued, 0)) {
+        if (!entry.waiting_for_keyframe) {
+            LOGW("Recording can't keep up, skipping stream %d up to its next keyframe.", stream);
+        }
+        av_packet_free(&queued.packet);
+        entry.waiting_for_keyframe = true;
+        dropped_++;
+        return;
+    }
+    entry.waiting_for_keyframe = false;
+}
+
+/**
+ * @brief Write the next queued packet to the current segment (waits for one, if none is available).
+ */
+void VideoRecorder::iteration() {
+    QueuedPacket queued;
+    if (!queue_.pop(queued, 100)) {
+        return;
+    }
+
+    writePacket(queued);
+    av_packet_free(&queued.packet);
+}
+
+/**
+ * @brief Write the packets that are still queued, and finalize the last segment.
+ */
+void VideoRecorder::cleanup() {
+    QueuedPacket queued;
+    while (queue_.tryPop(queued)) {
+        writePacket(queued);
+        av_packet_free(&queued.packet);
+    }
+
+    closeSegment();
+}
+
+void VideoRecorder::writePacket(QueuedPacket &queued) {
+    AVPacket *packet = queued.packet;
+    bool keyframe = packet->flags & AV_PKT_FLAG_KEY;
+    int64_t timestamp = (packet->dts != AV_NOPTS_VALUE) ? packet->dts : packet->pts;
+    int64_t timestamp_us = av_rescale_q(timestamp, queued.time_base, AV_TIME_BASE_Q);
+
+    /* Segments start (& rotate) at a keyframe of the first stream. */
+    if (queued.stream == 0 && keyframe) {
+        bool rotate = ptr_format_context && (
+            queued.parameters_version != segment_parameters_version_ ||
+            timestamp_us - segment_start_us_ >= static_cast<int64_t>(segment_seconds_ * AV_TIME_BASE)
+        );
+        if (rotate) {
+            closeSegment();
+        }
+        if (!ptr_format_context && !openSegment(queued)) {
+            return;
+        }
+    }
+
+    /* Every stream starts at a keyframe in each segment. */
+    if (!ptr_format_context || queued.stream >= static_cast<int>(segment_started_.size())) {
+        return;
+    }
+    if (!segment_started_[queued.stream]) {
+        if (!keyframe) {
+            return;
+        }
+        segment_started_[queued.stream] = true;
+    }
+
+    /* Each segment starts at zero. */
+    AVStream *stream = ptr_format_context->streams[queued.stream];
+    int64_t offset = av_rescale_q(segment_start_us_, AV_TIME_BASE_Q, queued.time_base);
+    if (packet->pts != AV_NOPTS_VALUE) { packet->pts -= offset; }
+    if (packet->dts != AV_NOPTS_VALUE) { packet->dts -= offset; }
+    av_packet_rescale_ts(packet, queued.time_base, stream->time_base);
+    packet->stream_index = queued.stream;
+    packet->pos = -1;
+
+    if (av_interleaved_write_frame(ptr_format_context, packet) < 0) {
+        /* Recording is best effort, it should never take down the live stream. */
+        LOGE("Issue writing packet to recording, closing the segment.");
+        closeSegment();
+    }
+}
+
+/**
+ * @brief Start a new segment file, named after the current local time.
+ * @note Segments started within the same second (e.g. on a resolution change) get a numbered suffix.
+ * @return False if the segment could not be opened (the next keyframe retries).
+ */
+bool VideoRecorder::openSegment(QueuedPacket const& first) {
+    char name[32];
+    time_t now = time(nullptr);
+    struct tm local_time;
+    localtime_r(&now, &local_time);
+    strftime(name, sizeof(name), "%Y%m%d_%H%M%S", &local_time);
+    std::string filepath = directory_ + "/" + name + "." + extension_;
+    for (int suffix = 1; access(filepath.c_str(), F_OK) == 0; suffix++) {
+        filepath = directory_ + "/" + name + "_" + std::to_string(suffix) + "." + extension_;
+    }
+
+    if (avformat_alloc_output_context2(&ptr_format_context, NULL, NULL, filepath.c_str()) < 0 || !ptr_format_context) {
+        LOGE("Could not allocate the output context for '%s'.", filepath.c_str());
+        ptr_format_context = nullptr;
+        return false;
+    }
+
+    { /* Streams, with the newest parameters. */
+        std::lock_guard<std::mutex> lock(streams_mutex_);
+        for (Stream const& entry: streams_) {
+            AVStream *stream = avformat_new_stream(ptr_format_context, NULL);
+            if (!stream || !entry.parameters || avcodec_parameters_copy(stream->codecpar, entry.parameters) < 0) {
+                LOGE("Could not add a stream to '%s'.", filepath.c_str());
+                avformat_free_context(ptr_format_context);
+                ptr_format_context = nullptr;
+                return false;
+            }
+            stream->codecpar->codec_tag = 0;  // Let the container pick its own tag.
+            stream->time_base = first.time_base;
+        }
+        segment_parameters_version_ = first.parameters_version;
+    }
+
+    if (avio_open(&ptr_format_context->pb, filepath.c_str(), AVIO_FLAG_WRITE) < 0) {
+        LOGE("Could not open recording '%s'.", filepath.c_str());
+        avformat_free_context(ptr_format_context);
+        ptr_format_context = nullptr;
+        return false;
+    }
+
+    if (avformat_write_header(ptr_format_context, NULL) < 0) {
+        LOGE("Could not write the header of recording '%s'.", filepath.c_str());
+        avio_closep(&ptr_format_context->pb);
+        avformat_free_context(ptr_format_context);
+        ptr_format_context = nullptr;
+        return false;
+    }
+
+    int64_t timestamp = (first.packet->dts != AV_NOPTS_VALUE) ? first.packet->dts : first.packet->pts;
+    segment_start_us_ = av_rescale_q(timestamp, first.time_base, AV_TIME_BASE_Q);
+    segment_started_.assign(ptr_format_context->nb_streams, false);
+    segments_++;
+
+    LOGI("Recording to '%s'.", filepath.c_str());
+    return true;
+}
+
+/**
+ * @brief Finalize the current segment (if any).
+ */
+void VideoRecorder::closeSegment() {
+    if (!ptr_format_context) {
+        return;
+    }
+
+    av_write_trailer(ptr_format_context);
+    avio_closep(&ptr_format_context->pb);
+    avformat_free_context(ptr_format_context);
+    ptr_format_context = nullptr;
+    segment_started_.clear();
+}
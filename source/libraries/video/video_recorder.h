@@ -0,0 +1,121 @@
+/**
+ * @file video_recorder.h
+ * @author Kevin Orbie
+ *
+ * @brief Declares a recorder that remuxes already encoded packets into rolling segment files.
+ */
+
+#pragma once
+
+/* ========================== Include ========================== */
+/* Standard C Libraries */
+#include <stdint.h>
+
+/* Standard C++ Libraries */
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+
+/* Third Party C++ Libraries */
+extern "C" { // ffmpeg
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+/* Custom C++ Libraries */
+#include "common/bounded_queue.h"
+#include "common/looper.h"
+
+
+/* ========================== Defines ========================== */
+#define RECORDER_QUEUE_SIZE 256  // Packets buffered between the stream and the disk (~8s of a 30 FPS stream).
+
+
+/* ========================== Classes ========================== */
+/**
+ * @brief Writes encoded packets (e.g. teed off a VideoTransmitter) to disk, without encoding them again.
+ *
+ * @details Packets are queued without ever blocking the caller. The writer (Looper) thread remuxes them into
+ * segment files (named by their start time), starting a new segment on the first keyframe after
+ * segment_seconds. When the disk can't keep up and the queue is full, packets of that stream are dropped up to
+ * its next keyframe, so the recording only skips whole GOPs instead of showing corrupt frames.
+ */
+class VideoRecorder final: public Looper {
+    /* A packet waiting to be written. */
+    struct QueuedPacket {
+        AVPacket *packet = nullptr;  // Owned.
+        int stream = 0;
+        AVRational time_base = {1, 1};
+        uint64_t parameters_version = 0;  // Stream parameters the packet was encoded with.
+    };
+
+    /* Per stream state. */
+    struct Stream {
+        AVCodecParameters *parameters = nullptr;
+        bool waiting_for_keyframe = true;  // Dropping packets, up to the next keyframe.
+    };
+
+   public:
+    /**
+     * @param directory: Where the segments are written (must exist).
+     * @param extension: Container of the segments, e.g. "mkv" (robust against power loss) or "mp4".
+     */
+    VideoRecorder(std::string const& directory, double segment_seconds=60.0, std::string const& extension="mkv");
+    ~VideoRecorder();
+
+    VideoRecorder(const VideoRecorder& other)            = delete;
+    VideoRecorder& operator=(const VideoRecorder& other) = delete;
+
+    /**
+     * @brief Add a stream (before writing packets), or update its codec parameters (e.g. after a resolution change).
+     * @note Thread-safe. Changed parameters start a new segment on the next keyframe.
+     */
+    void setStream(int stream, AVCodecContext const *context);
+
+    /**
+     * @brief Queue a (referenced) copy of the given packet, never blocks.
+     * @param time_base: Time base of the packet's timestamps.
+     * @note Thread-safe.
+     */
+    void write(int stream, AVPacket const *packet, AVRational time_base);
+
+    void iteration() override;
+    void cleanup() override;
+
+    /**
+     * @brief Number of packets that were not recorded, because the writer fell behind.
+     */
+    uint64_t dropped() const { return dropped_; };
+
+    /**
+     * @brief Number of segment files that were started.
+     */
+    uint64_t segments() const { return segments_; };
+
+   private:
+    bool openSegment(QueuedPacket const& first);
+    void closeSegment();
+    void writePacket(QueuedPacket &queued);
+
+   private:
+    std::string directory_;
+    std::string extension_;
+    double segment_seconds_;
+
+    /* Streams (guarded by streams_mutex_) */
+    std::mutex streams_mutex_;
+    std::vector<Stream> streams_;
+    uint64_t parameters_version_ = 0;
+
+    /* Queue */
+    BoundedQueue<QueuedPacket> queue_;
+    std::atomic<uint64_t> dropped_ = {0};
+    std::atomic<uint64_t> segments_ = {0};
+
+    /* Current Segment (writer thread) */
+    AVFormatContext *ptr_format_context = nullptr;
+    std::vector<bool> segment_started_;  // Per stream, whether its first keyframe was written.
+    uint64_t segment_parameters_version_ = 0;
+    int64_t segment_start_us_ = 0;       // Timestamp of the first packet, subtracted from all packets.
+};
@@ -10,21 +10,23 @@
 #include "video_transmitter.h"
 
 /* Standard C Libraries */
-// None
+#include <string.h>  // memcpy(), memmove()
 
 /* Standard C++ Libraries */
 #include <stdexcept>
+#include <algorithm>
 #include <string>
 
 /* Custom C++ Libraries */
 #include "common/logger.h"
 #include "common/utils.h"  // gettid()
+#include "common/clock.h"
 #include "video/image.h"
 
 
 /* ============================ Classes ============================ */
-VideoTransmitter::VideoTransmitter(std::string const& address, FrameProvider *frame_provider): 
-    address_(address), frame_provider_(frame_provider) {
+VideoTransmitter::VideoTransmitter(std::string const& address, FrameProvider *frame_provider, EncoderConfig const& config, bool adaptive, bool stereo): 
+    address_(address), frame_provider_(frame_provider), bitrate_controller_(config), pending_config_(config), adaptive_(adaptive), stereo_(stereo) {
     LOGI("Using libav-format version %d.%d.%d", LIBAVFORMAT_VERSION_MAJOR, LIBAVFORMAT_VERSION_MINOR, LIBAVFORMAT_VERSION_MICRO);
     LOGI("Using libav-codec version %d.%d.%d", LIBAVCODEC_VERSION_MAJOR, LIBAVCODEC_VERSION_MINOR, LIBAVCODEC_VERSION_MICRO);
     #if LIBAVCODEC_VERSION_MAJOR < 60
@@ -34,6 +36,9 @@ VideoTransmitter::VideoTransmitter(std::string const& address, FrameProvider *fr
     // av_log_set_level(AV_LOG_DEBUG);
     av_log_set_level(AV_LOG_QUIET);
 
+    /* The stream is identified (e.g. in feedback) by its port. */
+    port_ = streamPort(address);
+
     /* ---------------- Setup Container Context ----------------- */
     /* This context is used during the muxing operation. */
 
@@ -42,8 +47,10 @@ VideoTransmitter::VideoTransmitter(std::string const& address, FrameProvider *fr
     // rtp: rtp
     // rtmp: flv
     // rtsp: rtsp
+    // FFV1: nut (mpegts has no FFV1 mapping, nut streams over udp as well)
     LOGI("Trying to connect to a video stream at '%s'...", address.c_str());
-    int res = avformat_alloc_output_context2(&ptr_format_context, NULL, "mpegts", address.c_str());
+    bool lossless = (config.codec == AV_CODEC_ID_FFV1);
+    int res = avformat_alloc_output_context2(&ptr_format_context, NULL, lossless ? "nut" : "mpegts", address.c_str());
     if (res < 0) {
         LOGE("Issue while allocating memory for output Format Context: %d", res);
         throw std::runtime_error("Failed to allocate memory for output Format Context");
@@ -52,52 +59,43 @@ VideoTransmitter::VideoTransmitter(std::string const& address, FrameProvider *fr
         throw std::runtime_error("Failed to allocate memory for output Format Context");
     }
 
-    /* ---------------------- Setup CODEC ----------------------- */
-    /* Setup Encoder. */
-    ptr_codec = avcodec_find_encoder(AV_CODEC_ID_H264);
-    if (!ptr_codec) {
-        LOGE("Could not find encoder.");
-        throw std::runtime_error("Failed to find encoder");
-    }
+    /* ------------------- Setup CODEC & Stream ------------------- */
+    /* One stream per eye (the left eye first, which is the one plain recievers pick). */
+    eyes_.resize(stereo_ ? 2 : 1);
+    for (Eye &eye: eyes_) {
+        /* Packets are written as soon as they are encoded. */
+        Eye *eye_ptr = &eye;
+        eye.encoder = std::make_unique<VideoEncoder>(config, [this, eye_ptr](AVPacket *packet, LatencyStamp &stamp){ writePacket(*eye_ptr, packet, stamp); });
+
+        /* Create Stream. */
+        eye.stream = avformat_new_stream(ptr_format_context, NULL);
+        if (!eye.stream) {
+            LOGE("Could not allocate output stream.");
+            throw std::runtime_error("Failed to allocate output stream");
+        }
 
-    /* Allocate video CODEC Context. */
-    ptr_codec_context = avcodec_alloc_context3(ptr_codec);
-    if (!ptr_codec_context) {
-        LOGE("Failed to allocated memory for AVCodecContext.");
-        throw std::runtime_error("Failed to allocated memory for AVCodecContext");
-    }
+        /* Fill in stream parameters. */
+        // NOTE: The resolution may change at runtime, which the H.264 stream signals in-band (new SPS on the next keyframe).
+        eye.stream->id = ptr_format_context->nb_streams - 1;
+        eye.stream->time_base = eye.encoder->timeBase();
 
-    /* Fill the CODEC context. */
-    ptr_codec_context->codec_id = AV_CODEC_ID_H264;
-    ptr_codec_context->bit_rate = 1000000;  // 1 Mbps
-    ptr_codec_context->width = 1280;
-    ptr_codec_context->height = 720;
-    ptr_codec_context->time_base = AVRational{1, 30};
-    ptr_codec_context->framerate = AVRational{30, 1};
-    ptr_codec_context->gop_size = 12;                   // How many frames between full frames sent.
-    ptr_codec_context->pix_fmt = AV_PIX_FMT_YUV422P; // AV_PIX_FMT_YUV420P;
-
-    /* Setup Options. */
-    if (ptr_format_context->flags & AVFMT_GLOBALHEADER) {
-        ptr_codec_context->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+        /* Setup the stream context based on codec paramters. */
+        if (avcodec_parameters_from_context(eye.stream->codecpar, eye.encoder->context()) < 0) {
+            LOGE("Could not copy codec parameters.");
+            throw std::runtime_error("Failed to copy codec parameters");
+        }
     }
 
-    /* ---------------------- Setup Stream ---------------------- */
-    /* Create Stream. */
-    ptr_stream = avformat_new_stream(ptr_format_context, ptr_codec);
-    if (!ptr_stream) {
-        LOGE("Could not allocate output stream.");
-        throw std::runtime_error("Failed to allocate output stream");
-    }
-
-    /* Fill in stream parameters. */
-    ptr_stream->id = ptr_format_context->nb_streams - 1;
-    ptr_stream->time_base = ptr_codec_context->time_base;
-
-    /* Setup the stream context based on codec paramters. */
-    if (avcodec_parameters_from_context(ptr_stream->codecpar, ptr_codec_context) < 0) {
-        LOGE("Could not copy codec parameters.");
-        throw std::runtime_error("Failed to copy codec parameters");
+    /* The test pattern matches the (side-by-side) source it stands in for. */
+    source_format_ = (config.format == PixelFormat::DEPTH16) ? PixelFormat::DEPTH16 : PixelFormat::YUV422;
+    if (!frame_provider_) {
+        SyntheticConfig pattern;
+        pattern.width  = config.width * static_cast<int>(eyes_.size());
+        pattern.height = config.height;
+        pattern.fps    = TEST_PATTERN_FPS;
+        pattern.format = source_format_;
+        test_pattern_  = std::make_unique<SyntheticFrameProvider>(pattern);
+        frame_provider_ = test_pattern_.get();
     }
 
     /* Print information about Stream Format. */
@@ -117,66 +115,34 @@ VideoTransmitter::VideoTransmitter(std::string const& address, FrameProvider *fr
         }
     }
 
+    /* Write the length of every video PES packet, so the reciever can decode it as soon as it is complete. */
+    AVDictionary *ptr_mux_opts = nullptr;
+    if (!lossless) {
+        av_dict_set(&ptr_mux_opts, "omit_video_pes_length", "0", 0);
+    }
+
     /* Allocate Stream data & write the stream header to an output media file. */
-    if (avformat_write_header(ptr_format_context, NULL) != 0) {
+    res = avformat_write_header(ptr_format_context, &ptr_mux_opts);
+    av_dict_free(&ptr_mux_opts);
+    if (res != 0) {
         LOGE("Failed to connect to '%s'.", address.c_str());
         throw std::runtime_error("Failed to connect to network.");
     }
 
-    /* ----------------------- Open CODEC ----------------------- */
-    if (ptr_codec_context->codec_id == AV_CODEC_ID_H264) {
-        // av_dict_set(&ptr_codec_opts, "profile", "high", 0);  // Only supported with YUV420P
-        av_dict_set(&ptr_codec_opts, "profile", "high422", 0);
-        av_dict_set(&ptr_codec_opts, "preset", "ultrafast", 0);  // ultrafast, superfast, veryfast, faster, fast, medium (default), slow, veryslow
-        av_dict_set(&ptr_codec_opts, "tune", "zerolatency", 0);
-        // av_dict_set(&ptr_codec_opts, "crf", "1", 0);  // Constant Rate Factor: [0, 51]
-        av_dict_set(&ptr_codec_opts, "x264-params", "keyint=30", 0);
-    }
-
-    /* Initialize the AVCodecContext to use the given AVCodec. */
-    if (avcodec_open2(ptr_codec_context, ptr_codec, &ptr_codec_opts) < 0) {
-        LOGE("Failed to open CODEC through avcodec_open2.");
-        throw std::runtime_error("Failed to open CODEC through avcodec_open2");
-    }
-
-    /* ---------------- Allocate Packet / Frame ----------------- */
-    ptr_frame = av_frame_alloc();
-    if (!ptr_frame) {
-        LOGE("Failed to allocate memory for AVFrame.");
-        throw std::runtime_error("Failed to allocate memory for AVFrame.");
-    }
-
-    ptr_frame->format = ptr_codec_context->pix_fmt;
-    ptr_frame->width = ptr_codec_context->width;
-    ptr_frame->height = ptr_codec_context->height;
-
-    /* Allocate frame data (data buffer). */
-    if (av_frame_get_buffer(ptr_frame, 0) < 0) {
-        LOGE("Failed to allocate memory for AVFrame data.");
-        throw std::runtime_error("Failed to allocate memory for AVFrame data");
-    }
-    av_frame_make_writable(ptr_frame);
-
-    /* Allocate Packet */
-    ptr_packet = av_packet_alloc();
-    if (!ptr_packet) {
-        LOGE("Failed to allocate memory for AVPacket.");
-        throw std::runtime_error("Failed to allocate memory for AVPacket");
-    }
-
-    auto start_time_ = std::chrono::steady_clock::now();
+    start_time_ = std::chrono::steady_clock::now();
 }
 
 VideoTransmitter::~VideoTransmitter() {
+    /* Join the encode (Looper) thread first, it still uses the encoders & the muxer. */
+    Looper::stop();
+    stopCapturing();
+    stopRightEye();
+
+    eyes_.clear();  // Stop writing packets, before closing the stream.
     av_write_trailer(ptr_format_context);
 
-    av_packet_free(&ptr_packet);
-    av_frame_free(&ptr_frame);
-    avformat_close_input(&ptr_format_context);
     avio_close(ptr_format_context->pb);
     avformat_free_context(ptr_format_context);
-    avcodec_free_context(&ptr_codec_context);
-    av_dict_free(&ptr_codec_opts);
     av_dict_free(&ptr_open_container_opts);
 }
 
@@ -185,43 +151,195 @@ void VideoTransmitter::start() {
     Looper::start();
 }
 
+/**
+ * @brief Encode the newest captured frame (waits for one, if none is available).
+ */
 void VideoTransmitter::iteration() {
-    if (frame_provider_) {
-        /* Video from frame provider (YUV422). */
-        Frame frame = frame_provider_->getFrame(INFINITY, PixelFormat::YUV422); // Always get the latest frame.
-        send(frame);
-
-    } else {
-        /* Testing video. */
-        // NOTE: YUV (0,0,0) is roughly RGB (0, 136, 0)
-        Frame frame = {};
-        frame.image = Image(2560, 720, PixelFormat::YUV422);
-        frame.image.zero();
-
-        static int counter = 0;
-        /* Fill in a box. */
-        for (int yidx = 0; yidx < frame.image.getHeight(); yidx++) {
-            for (int xidx = (counter % frame.image.getWidth()); xidx < (counter + 100) % frame.image.getWidth(); xidx++) {
-                int idx = (yidx * frame.image.getWidth() * 2 + xidx * 2);
-
-                /* Only fill the y plane. */
-                *(frame.image.getData() + idx) = 255;
-            }
+    { /* Wait for the capture stage. */
+        std::unique_lock<std::mutex> lock(frame_mutex_);
+        frame_cv_.wait_for(lock, std::chrono::milliseconds(100), [this](){ return frame_ready_; });
+        frame_ready_ = false;
+    }
+
+    if (captured_.update()) {
+        CapturedFrame &captured = captured_.front();
+        if (captured.index > last_index_ + 1) {
+            stale_dropped_count_ += captured.index - last_index_ - 1;
         }
-        counter += 20;
+        last_index_ = captured.index;
 
-        send(frame);
+        send(*captured.frame);
+        encoded_count_++;
+    }
 
-        /* Fix to 30 FPS. */
-        std::this_thread::sleep_until(start_time_ + std::chrono::milliseconds(33));
-        start_time_ = std::chrono::steady_clock::now();
+    if (common::seconds(last_report_, common::now()) > 5.0) {
+        reportStats();
     }
 }
 
 void VideoTransmitter::setup() {
     LOGI("Running VideoTransmitter (TID = %d)", gettid());
+    last_report_ = common::now();
+
+    if (stereo_) {
+        { 
+            std::lock_guard<std::mutex> lock(eye_mutex_);
+            eye_running_ = true;
+        }
+        right_eye_thread_ = std::thread([this]() {
+            LOGI("Running VideoTransmitter right eye encoder (TID = %d)", gettid());
+            while (true) {
+                std::unique_lock<std::mutex> lock(eye_mutex_);
+                eye_cv_.wait(lock, [this](){ return eye_pending_ || !eye_running_; });
+                if (!eye_running_) { break; }
+
+                EyeJob job = eye_job_;
+                lock.unlock();
+                eyes_[1].encoder->encode(*job.image, job.sequence, job.capture_us);
+                lock.lock();
+
+                eye_pending_ = false;
+                eye_cv_.notify_all();
+            }
+        });
+    }
+
+    capturing_ = true;
+    capture_thread_ = std::thread([this]() {
+        LOGI("Running VideoTransmitter capture (TID = %d)", gettid());
+        while (capturing_) {
+            try {
+                capture();
+            } catch (const std::exception& error) {
+                /* E.g. the camera was disconnected, an exception must not escape the thread (std::terminate). */
+                LOGE("Video capture for '%s' failed (%s), stopped capturing.", address_.c_str(), error.what());
+                capturing_ = false;
+            }
+        }
+    });
+};
+
+void VideoTransmitter::cleanup() {
+    stopCapturing();
+    stopRightEye();
 };
 
+void VideoTransmitter::stopRightEye() {
+    {
+        std::lock_guard<std::mutex> lock(eye_mutex_);
+        eye_running_ = false;
+    }
+    eye_cv_.notify_all();
+    if (right_eye_thread_.joinable()) {
+        right_eye_thread_.join();
+    }
+};
+
+void VideoTransmitter::stopCapturing() {
+    capturing_ = false;
+    if (capture_thread_.joinable()) {
+        capture_thread_.join();
+    }
+};
+
+/**
+ * @brief Wait for one new frame, and publish it to the encode stage (Blocking).
+ */
+void VideoTransmitter::capture() {
+    /* Video from the frame provider (YUV422, or DEPTH16), waited on (or polled, if it can't wait) for a new frame. */
+    if (!frame_provider_->waitForFrame(CAPTURE_WAIT_MS)) {
+        return;  // Nothing new (yet).
+    }
+    double curr_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+    std::shared_ptr<const Frame> frame = frame_provider_->getSharedFrame(curr_time, source_format_);
+
+    uint32_t sequence = (frame) ? frame->sequence : 0;
+    if (!frame || (sequence != 0 && sequence == last_sequence_)) {
+        /* Nothing new yet (from a provider that can't wait). */
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        return;
+    }
+    if (sequence != 0 && last_sequence_ != 0 && sequence > last_sequence_ + 1) {
+        capture_dropped_count_ += sequence - last_sequence_ - 1;
+    }
+    last_sequence_ = sequence;
+
+    /* Frame rate cap: take one frame per interval (with some slack for capture jitter), skip the rest. */
+    double max_fps = max_fps_;
+    if (max_fps > 0.0) {
+        int64_t capture_us  = (frame->timestamp != 0) ? frame->timestamp : common::micros();
+        int64_t interval_us = static_cast<int64_t>(1e6 / max_fps);
+        if (capture_us < next_due_us_ - interval_us / 4) {
+            rate_dropped_count_++;
+            return;
+        }
+        next_due_us_ = std::max(next_due_us_, capture_us) + interval_us;
+    }
+
+    /* Only new frames are handed over (shared, not copied). */
+    CapturedFrame &captured = captured_.back();
+    captured.frame = std::move(frame);
+    captured.index = ++captured_count_;
+    captured_.publish();
+
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex_);
+        frame_ready_ = true;
+    }
+    frame_cv_.notify_one();
+}
+
+VideoTransmitter::Stats VideoTransmitter::stats() const {
+    Stats stats;
+    stats.captured        = captured_count_;
+    stats.capture_dropped = capture_dropped_count_;
+    stats.stale_dropped   = stale_dropped_count_;
+    stats.rate_dropped    = rate_dropped_count_;
+    stats.encoded         = encoded_count_;
+    stats.bytes           = bytes_count_;
+    return stats;
+}
+
+void VideoTransmitter::reportStats() {
+    Stats current = stats();
+    double elapsed = common::seconds(last_report_, common::now());
+    double kbps = (elapsed > 0.0) ? (current.bytes - last_report_bytes_) * 8e-3 / elapsed : 0.0;
+    LOGI("Video '%s': %lu captured, %lu encoded (%.0f kbps), %lu dropped before capture, %lu dropped as stale, %lu over the max. frame rate.", 
+         address_.c_str(), current.captured, current.encoded, kbps, current.capture_dropped, current.stale_dropped, current.rate_dropped);
+    last_report_ = common::now();
+    last_report_bytes_ = current.bytes;
+}
+
+void VideoTransmitter::configure(EncoderConfig const& config) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    bitrate_controller_ = BitrateController(config);
+    pending_config_ = config;
+    config_changed_ = true;
+}
+
+void VideoTransmitter::record(VideoRecorder *recorder) {
+    if (recorder) {
+        for (Eye &eye: eyes_) {
+            recorder->setStream(eye.stream->index, eye.encoder->context());
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mux_mutex_);
+    recorder_ = recorder;
+}
+
+void VideoTransmitter::sink(VideoFeedback feedback) {
+    if (!adaptive_ || feedback.port != port_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (bitrate_controller_.update(feedback)) {
+        pending_config_ = bitrate_controller_.config();
+        config_changed_ = true;
+    }
+}
+
 /**
  * @brief Send the given frame over the network.
  * 
@@ -229,46 +347,134 @@ void VideoTransmitter::setup() {
  * function will directly send the output.
  * @link https://www.ffmpeg.org/doxygen/trunk/remux_8c-example.html#a48
  */
-void VideoTransmitter::send(Frame &frame) {
-    /* Add data to frame. */
-    ptr_frame->pts = frame_pts;
+void VideoTransmitter::send(Frame const& frame) {
+    { /* Apply configuration changes between frames. */
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        if (config_changed_) {
+            for (Eye &eye: eyes_) {
+                eye.encoder->reconfigure(pending_config_);  // Flushes packets, through writePacket().
+            }
+            config_changed_ = false;
+
+            /* A reopened encoder (e.g. new resolution) starts a new recording segment. */
+            std::lock_guard<std::mutex> mux_lock(mux_mutex_);
+            for (Eye &eye: eyes_) {
+                if (recorder_) {
+                    recorder_->setStream(eye.stream->index, eye.encoder->context());
+                }
+            }
+        }
+    }
+
+    /* Frames are identified & timestamped in the stream, for latency measurements on the reciever. */
+    sequence_++;
+    uint32_t sequence = (frame.sequence != 0) ? frame.sequence : sequence_;
+    int64_t capture_us = (frame.timestamp != 0) ? frame.timestamp : common::micros();
 
-    /* Copy YUV422 to YUV422P. */
     ImageView image_view = frame.image.view();
+    if (!stereo_) {
+        eyes_[0].encoder->encode(image_view, sequence, capture_us);
+        return;
+    }
 
-    ImageView buffer_view = ImageView( 
-        {ptr_frame->data[0], ptr_frame->data[1], ptr_frame->data[2]},
-        {ptr_frame->linesize[0], ptr_frame->linesize[1], ptr_frame->linesize[2]},
-        frame.image.getWidth(), frame.image.getHeight(), PixelFormat::YUV422P
-    );
+    /* Address both halves of the side-by-side frame in place. */
+    int eye_width = (image_view.getWidth() / 2) & ~1;
+    ImageView left_view  = image_view.subView(0, 0, eye_width, image_view.getHeight());
+    ImageView right_view = image_view.subView(eye_width, 0, eye_width, image_view.getHeight());
+
+    std::unique_lock<std::mutex> lock(eye_mutex_);
+    if (!eye_running_) {
+        /* Not running threaded (e.g. send() called directly). */
+        lock.unlock();
+        eyes_[0].encoder->encode(left_view, sequence, capture_us);
+        eyes_[1].encoder->encode(right_view, sequence, capture_us);
+        return;
+    }
 
-    buffer_view.copyFrom(image_view);
+    /* Encode the right eye on its own thread, while encoding the left eye here. */
+    eye_job_ = {&right_view, sequence, capture_us};
+    eye_pending_ = true;
+    lock.unlock();
+    eye_cv_.notify_all();
 
-    /* Send a frame to the encoder. */
-    if (avcodec_send_frame(ptr_codec_context, ptr_frame) < 0) {
-        LOGE("Issue encoding frame.");
-        throw std::runtime_error("Failed to encode frame");
-    }
+    eyes_[0].encoder->encode(left_view, sequence, capture_us);
+
+    lock.lock();
+    eye_cv_.wait(lock, [this](){ return !eye_pending_ || !eye_running_; });
+}
 
-    int ret = 0;
-    do { /* Send all available packets. */
-        av_packet_unref(ptr_packet);
-
-        /* Recieve a packet from the encoder. */
-        ret = avcodec_receive_packet(ptr_codec_context, ptr_packet);
-        if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
-            break;
-        } else if (ret < 0) {
-            LOGE("Issue during recieving encoded packet: %d", ret);
-            throw std::runtime_error("Failed to recieve encoded packet");
+/**
+ * @brief Write an encoded packet to the stream, with its timing embedded as SEI (H.264 only).
+ */
+void VideoTransmitter::writePacket(Eye &eye, AVPacket *packet, LatencyStamp &stamp) {
+    stamp.send_us = common::micros();
+    if (eye.encoder->config().codec == AV_CODEC_ID_H264) {
+        std::vector<uint8_t> sei = buildLatencySEI(stamp);
+        size_t position = findLatencySEIPosition(packet->data, packet->size);
+
+        int old_size = packet->size;
+        if (av_grow_packet(packet, sei.size()) < 0) {
+            LOGW("Failed to add the latency SEI to the packet.");
+        } else {
+            memmove(packet->data + position + sei.size(), packet->data + position, old_size - position);
+            memcpy(packet->data + position, sei.data(), sei.size());
         }
+    }
 
-        ret = av_interleaved_write_frame(ptr_format_context, ptr_packet);
-        if (ret < 0) {
-            LOGE("Issue writing packet to stream");
-            throw std::runtime_error("Failed to write a packet to stream");
+    av_packet_rescale_ts(packet, eye.encoder->timeBase(), eye.stream->time_base);
+    packet->stream_index = eye.stream->index;
+    bytes_count_ += packet->size;
+
+    std::lock_guard<std::mutex> lock(mux_mutex_);
+    if (recorder_) {
+        /* Before muxing, which takes over (& resets) the packet. */
+        recorder_->write(eye.stream->index, packet, eye.stream->time_base);
+    }
+    if (eye.encoder->config().slice_packets && eye.encoder->config().codec == AV_CODEC_ID_H264) {
+        writeSlices(packet);
+    } else if (av_interleaved_write_frame(ptr_format_context, packet) < 0) {
+        LOGE("Issue writing packet to stream");
+        throw std::runtime_error("Failed to write a packet to stream");
+    }
+}
+
+/**
+ * @brief Mux every slice of the (access unit) packet as its own PES packet, and send each one right away.
+ * @note The muxer requires increasing timestamps, so every next slice is one tick (of the stream time base) later.
+ */
+void VideoTransmitter::writeSlices(AVPacket *packet) {
+    std::vector<size_t> chunks = splitSlices(packet->data, packet->size);
+    AVPacket *ptr_chunk = av_packet_alloc();
+    if (!ptr_chunk) {
+        LOGE("Failed to allocate memory for AVPacket.");
+        throw std::runtime_error("Failed to allocate memory for AVPacket");
+    }
+
+    for (size_t idx = 0; idx < chunks.size(); idx++) {
+        /* A new reference to the same data, without copying. */
+        if (av_packet_ref(ptr_chunk, packet) < 0) {
+            av_packet_free(&ptr_chunk);
+            LOGE("Failed to reference a slice of the packet.");
+            throw std::runtime_error("Failed to reference a slice of the packet");
+        }
+        size_t end = (idx + 1 < chunks.size()) ? chunks[idx + 1] : static_cast<size_t>(packet->size);
+        ptr_chunk->data += chunks[idx];
+        ptr_chunk->size  = static_cast<int>(end - chunks[idx]);
+        if (ptr_chunk->pts != AV_NOPTS_VALUE) { ptr_chunk->pts += idx; }
+        if (ptr_chunk->dts != AV_NOPTS_VALUE) { ptr_chunk->dts += idx; }
+        if (idx > 0) {
+            ptr_chunk->flags &= ~AV_PKT_FLAG_KEY;
         }
-    } while (ret >= 0);
 
-    frame_pts++;
-}
\ No newline at end of file
+        /* Not interleaved, which would hold on to the slice. */
+        int res = av_write_frame(ptr_format_context, ptr_chunk);
+        av_packet_unref(ptr_chunk);
+        if (res < 0) {
+            av_packet_free(&ptr_chunk);
+            LOGE("Issue writing a slice to stream");
+            throw std::runtime_error("Failed to write a slice to stream");
+        }
+        avio_flush(ptr_format_context->pb);
+    }
+    av_packet_free(&ptr_chunk);
+}
@@ -14,6 +14,11 @@
 /* Standard C++ Libraries */
 #include <vector>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
 
 /* Third Party C++ Libraries */
 extern "C" { // ffmpeg
@@ -22,51 +27,176 @@ extern "C" { // ffmpeg
 }
 
 /* Custom C++ Libraries */
+#include "common/video_feedback.h"
 #include "common/looper.h"
+#include "common/triple_buffer.h"
+#include "bitrate_controller.h"
+#include "common/clock.h"
 #include "frame_provider.h"
+#include "synthetic_frame_provider.h"
+#include "video_encoder.h"
+#include "video_recorder.h"
+
+
+/* ========================== Defines ========================== */
+#define TEST_PATTERN_FPS 30  // Of the synthetic video, streamed without a frame provider.
+#define CAPTURE_WAIT_MS  100 // Max time the capture thread waits on the frame provider (bounds stopCapturing()).
 
 
 /* ========================== Classes ========================== */
 
 /**
- * @brief Class to obtain frames from a file.
+ * @brief Class to stream frames over the network.
+ *
+ * @details Capturing runs in its own thread, which hands the newest frame to the encoder (Looper) thread. 
+ * When the encoder falls behind, it skips straight to the newest frame, instead of working through a backlog.
+ *
+ * @note Accepts video feedback from the reciever, to adapt the bitrate / resolution to the link (when enabled).
+ * @note Lossless FFV1 streams (e.g. DEPTH16) are sent in a NUT container (MPEG-TS can't carry FFV1), without 
+ * latency SEI, and can't change resolution at runtime (so should not be adaptive).
  */
-class VideoTransmitter final: public Looper {
+class VideoTransmitter final: public Looper, public VideoFeedbackSink {
+    /* A captured frame, numbered in publish order. */
+    struct CapturedFrame {
+        std::shared_ptr<const Frame> frame;  // Shared with the frame provider (e.g. a FrameHub), read-only.
+        uint64_t index = 0;
+    };
+
+    /* One encoded video stream (one per eye in stereo mode). */
+    struct Eye {
+        std::unique_ptr<VideoEncoder> encoder;
+        AVStream *stream = nullptr;
+    };
+
+    /* A right eye frame, handed to the right eye encoder thread. */
+    struct EyeJob {
+        ImageView *image = nullptr;
+        uint32_t sequence = 0;
+        int64_t capture_us = 0;
+    };
+
+   public:
+    struct Stats {
+        uint64_t captured        = 0;  // Frames handed to the encoder thread.
+        uint64_t capture_dropped = 0;  // Frames lost before capture (gaps in the provider's sequence numbers).
+        uint64_t stale_dropped   = 0;  // Captured frames replaced by a newer one, before they were encoded.
+        uint64_t rate_dropped    = 0;  // Frames skipped to stay below the max. frame rate.
+        uint64_t encoded         = 0;
+        uint64_t bytes           = 0;  // Encoded bytes written to the stream.
+    };
+
    public:
-    VideoTransmitter(std::string const& address=std::string("udp://127.0.0.1:8999"), FrameProvider *frame_provider=nullptr);
+    /**
+     * @param stereo: Split side-by-side frames, and encode both eyes in parallel as two streams in the same container.
+     * The config then describes a single eye.
+     */
+    VideoTransmitter(std::string const& address=std::string("udp://127.0.0.1:8999"), FrameProvider *frame_provider=nullptr, 
+                     EncoderConfig const& config=EncoderConfig(), bool adaptive=true, bool stereo=false);
     ~VideoTransmitter();
 
     void start() override;
     void iteration() override;
     void setup() override;
+    void cleanup() override;
+
+    void send(Frame const& frame);
+
+    /**
+     * @brief Change the encoder settings (applied before the next frame), these also become the adaptive bitrate maximum.
+     * @note Thread-safe.
+     */
+    void configure(EncoderConfig const& config);
+
+    /**
+     * @brief Feedback of the reciever of this stream (feedback of other streams is ignored).
+     * @note Thread-safe.
+     */
+    void sink(VideoFeedback feedback) override;
+
+    /**
+     * @brief Also hand every encoded packet to the given recorder (nullptr to stop), which must outlive this transmitter.
+     * @note Thread-safe.
+     */
+    void record(VideoRecorder *recorder);
+
+    /**
+     * @brief Skip frames that arrive faster than max_fps (0 = encode every frame), e.g. to fit a lossless stream on the link.
+     * @note Thread-safe. Set the config's fps to match, it's the rate the encoder expects.
+     */
+    void setMaxFrameRate(double max_fps) { max_fps_ = max_fps; };
+
+    /**
+     * @brief Frame counters since construction.
+     * @note Thread-safe.
+     */
+    Stats stats() const;
 
-    void send(Frame &frame);
+   private:
+    void capture();  // Capture stage.
+    void stopCapturing();
+    void stopRightEye();
+    void reportStats();
+    void writePacket(Eye &eye, AVPacket *packet, LatencyStamp &stamp);
+    void writeSlices(AVPacket *packet);
 
    private:
     std::string address_;
+    uint16_t port_ = 0;
     FrameProvider *frame_provider_ = nullptr;
+    std::unique_ptr<SyntheticFrameProvider> test_pattern_;  // Stands in for a missing frame provider.
 
     /* Container Variables (for muxing) */
     AVFormatContext *ptr_format_context = nullptr;  // Header information
     AVDictionary    *ptr_open_container_opts = nullptr;
 
-    /* Codec Variables (for encoding) */
-    AVCodecContext *ptr_codec_context   = nullptr;
-    AVDictionary   *ptr_codec_opts      = nullptr;
-    AVCodec const  *ptr_codec           = nullptr;
-
-    /* Stream */
-    AVStream *ptr_stream;
-
-    /* Stream Slice Variables */
-    AVPacket *ptr_packet = nullptr;  // Encoded
-    AVFrame  *ptr_frame  = nullptr;  // Decoded
-
-    /* Frame Data */
-    Frame  frame_data_ = {};
-    double play_time_  = -1.0;
-    int    frame_pts   = 0;
+    std::mutex mux_mutex_;  // Both eyes write packets.
+    VideoRecorder *recorder_ = nullptr;  // Guarded by mux_mutex_.
+
+    /* Streams & Encoding */
+    std::vector<Eye> eyes_;
+    bool stereo_;
+    PixelFormat source_format_ = PixelFormat::YUV422;  // Requested from the frame provider.
+
+    /* Right Eye Encoder (stereo mode only) */
+    std::thread right_eye_thread_;
+    std::mutex eye_mutex_;
+    std::condition_variable eye_cv_;
+    EyeJob eye_job_;            // Guarded by eye_mutex_.
+    bool eye_pending_ = false;  // Guarded by eye_mutex_.
+    bool eye_running_ = false;  // Guarded by eye_mutex_.
+
+    /* Configuration (shared with the feedback / configure() caller thread) */
+    std::mutex config_mutex_;
+    BitrateController bitrate_controller_;
+    EncoderConfig pending_config_;
+    bool config_changed_ = false;
+    bool adaptive_;
+
+    /* Capture Stage */
+    std::thread capture_thread_;
+    std::atomic<bool> capturing_ = {false};
+    TripleBuffer<CapturedFrame> captured_;
+    std::mutex frame_mutex_;
+    std::condition_variable frame_cv_;
+    bool frame_ready_ = false;  // Guarded by frame_mutex_.
+    uint32_t last_sequence_ = 0;  // Only touched by the capture stage.
+    std::atomic<double> max_fps_ = {0.0};
+    int64_t next_due_us_ = 0;  // Capture time from which the next frame is taken (only touched by the capture stage).
+
+    /* Encode Stage */
+    uint32_t sequence_ = 0;  // Fallback, for frames without a sequence number.
+    uint64_t last_index_ = 0;
+    timestamp_t last_report_;
+    uint64_t last_report_bytes_ = 0;
+
+    /* Counters */
+    std::atomic<uint64_t> captured_count_        = {0};
+    std::atomic<uint64_t> capture_dropped_count_ = {0};
+    std::atomic<uint64_t> stale_dropped_count_   = {0};
+    std::atomic<uint64_t> rate_dropped_count_    = {0};
+    std::atomic<uint64_t> encoded_count_         = {0};
+    std::atomic<uint64_t> bytes_count_           = {0};
 
     /* Timing */
-    std::chrono::_V2::steady_clock::time_point start_time_;
+    std::chrono::steady_clock::time_point start_time_;
 };
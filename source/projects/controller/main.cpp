@@ -43,6 +43,7 @@ static void help() {
     msg += "  -d              enable the depth estimation (experimental)\n";
     msg += "  -c              stream from the camera\n";
     msg += "  -t              standalone test configuration\n";
+    msg += "  -l              low delay: decode the video slice by slice (the engine must also run with -l)\n";
     msg += "  -v <path>       stream from the video file\n";
     msg += "  -i <address>    ip address of the robot to connect to\n";
     
@@ -90,10 +91,11 @@ int main(int argc, char *argv[]) {
     bool enable_depth   = false;
     bool use_video_file = false;
     bool enable_arduino = false;
+    bool low_delay      = false;
 
     /* ----------------- Parse User Input ----------------- */
     int option;
-    while ((option = getopt(argc, argv, "actv:mdi:h")) != -1) {
+    while ((option = getopt(argc, argv, "actlv:mdi:h")) != -1) {
         switch (option) {
             case 'a': {
                 use_camera = true;
@@ -107,6 +109,9 @@ int main(int argc, char *argv[]) {
             case 'c':
                 use_camera = true;
                 break;
+            case 'l':
+                low_delay = true;
+                break;
             case 'm':
                 enable_arduino = true;
                 break;
@@ -200,9 +205,9 @@ int main(int argc, char *argv[]) {
                  * - "/dev/video2" when four video devices are found.
                  */
                 if (stat("/dev/video2", &buffer) == 0) { // the "/dev/video2" file exists
-                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_SINGLE, VideoCam::IO_Method::MMAP, "/dev/video2");
+                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_DEPTH, VideoCam::IO_Method::MMAP, "/dev/video2");
                 } else {
-                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_SINGLE, VideoCam::IO_Method::MMAP, "/dev/video1");
+                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_DEPTH, VideoCam::IO_Method::MMAP, "/dev/video1");
                 }
                 
                 depth_frame_provider->startStream();
@@ -223,10 +228,14 @@ int main(int argc, char *argv[]) {
         if (enable_depth) {
             depth_frame_provider = std::make_unique<VideoReciever>("udp://" + robot_ip + ":8998");
             depth_frame_provider->startStream();
+            dynamic_cast<VideoReciever*>(depth_frame_provider.get())->setFeedbackSink(robot.get());
+            dynamic_cast<VideoReciever*>(depth_frame_provider.get())->setClockOffset(robot ? robot->clockOffset() : nullptr);
             dynamic_cast<VideoReciever*>(depth_frame_provider.get())->thread();
         }
-        color_frame_provider = std::make_unique<VideoReciever>("udp://" + robot_ip + ":8999");
+        color_frame_provider = std::make_unique<VideoReciever>("udp://" + robot_ip + ":8999", low_delay);
         color_frame_provider->startStream();
+        dynamic_cast<VideoReciever*>(color_frame_provider.get())->setFeedbackSink(robot.get());  // Adaptive bitrate.
+        dynamic_cast<VideoReciever*>(color_frame_provider.get())->setClockOffset(robot ? robot->clockOffset() : nullptr);  // Latency.
         dynamic_cast<VideoReciever*>(color_frame_provider.get())->thread();
     }
 
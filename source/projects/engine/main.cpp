@@ -8,19 +8,23 @@
 /* ========================== Include ========================== */
 /* Standard C Libraries */
 #include <unistd.h>  // getopt
+#include <stdlib.h>  // atoi
 #include <sys/stat.h>  // stat
 
 /* Standard C++ Libraries */
 #include <iostream>
 #include <thread>
 #include <memory>
+#include <algorithm>
 
 /* Third Party Libraries */
 // None
 
 /* Custom C++ Includes */
 #include "video/video_transmitter.h"
+#include "video/video_recorder.h"
 #include "video/video_file.h"
+#include "video/frame_hub.h"
 #include "video/video_cam.h"
 #include "robot/arduino_driver.h"
 #include "robot/remote.h"
@@ -39,9 +43,13 @@ static void help() {
     msg += "  -a              enable camera and arduino driver\n";
     msg += "  -m              enable the arduino driver (don't require remote connection)\n";
     msg += "  -d              enable the depth estimation (experimental)\n";
+    msg += "  -f <fps>        max. frame rate of the (lossless) depth stream (default 10, 0 for the camera's rate)\n";
     msg += "  -c              stream from the camera\n";
+    msg += "  -s              stream both camera eyes (stereo, encoded in parallel)\n";
+    msg += "  -l              low delay streaming (intra refresh & MTU sized slices, instead of keyframes), the controller must also run with -l\n";
     msg += "  -v <path>       stream from the video file\n";
     msg += "  -i <address>    ip address of the remote to connect to\n";
+    msg += "  -r <directory>  also record the streamed video, in one minute segments\n";
     
     msg += "\n";
 
@@ -77,15 +85,19 @@ int main(int argc, char *argv[]) {
     /* ------------------ Default Values ------------------ */
     std::string remote_ip = "192.168.0.234";
     std::string video_file;
+    std::string record_directory;
 
     bool use_camera     = false;
     bool enable_depth   = false;
     bool use_video_file = false;
     bool enable_arduino = false;
+    bool enable_stereo  = false;
+    bool low_delay      = false;
+    int  depth_fps      = 10;
 
     /* ----------------- Parse User Input ----------------- */
     int option;
-    while ((option = getopt(argc, argv, "acv:mdi:h")) != -1) {
+    while ((option = getopt(argc, argv, "acslv:mdf:i:r:h")) != -1) {
         switch (option) {
             case 'a': {
                 use_camera = true;
@@ -95,15 +107,27 @@ int main(int argc, char *argv[]) {
             case 'c':
                 use_camera = true;
                 break;
+            case 's':
+                enable_stereo = true;
+                break;
+            case 'l':
+                low_delay = true;
+                break;
             case 'm':
                 enable_arduino = true;
                 break;
             case 'd':
                 enable_depth = true;
                 break;
+            case 'f':
+                depth_fps = std::max(atoi(optarg), 0);
+                break;
             case 'i':
                 remote_ip = std::string(optarg);
                 break;
+            case 'r':
+                record_directory = std::string(optarg);
+                break;
             case 'v': {
                 use_video_file = true;
                 video_file = std::string(optarg);
@@ -140,6 +164,9 @@ int main(int argc, char *argv[]) {
     std::unique_ptr<ArduinoDriver> arduino_driver = nullptr;
     std::unique_ptr<FrameProvider> color_frame_provider = nullptr;
     std::unique_ptr<FrameProvider> depth_frame_provider = nullptr;
+    std::unique_ptr<FrameHub> color_frame_hub = nullptr;  // Stops capturing before its provider is destroyed.
+    std::shared_ptr<FrameHub::Subscription> color_stream_frames = nullptr;
+    std::unique_ptr<VideoRecorder> color_frame_recorder = nullptr;  // Outlives its transmitter.
     std::unique_ptr<VideoTransmitter> depth_frame_transmitter   = nullptr;
     std::unique_ptr<VideoTransmitter> color_frame_transmitter   = nullptr;
 
@@ -160,16 +187,17 @@ int main(int argc, char *argv[]) {
                  * - "/dev/video2" when four video devices are found.
                  */
                 if (stat("/dev/video2", &buffer) == 0) { // the "/dev/video2" file exists
-                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_SINGLE, VideoCam::IO_Method::MMAP, "/dev/video2");
+                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_DEPTH, VideoCam::IO_Method::MMAP, "/dev/video2");
                     LOGI("Using the '/dev/video2' video device for depth stream.");
                 } else {
                     LOGI("Using the '/dev/video1' video device for depth stream.");
-                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_SINGLE, VideoCam::IO_Method::MMAP, "/dev/video1");
+                    depth_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_DEPTH, VideoCam::IO_Method::MMAP, "/dev/video1");
                 }
                 
                 depth_frame_provider->startStream();
             }
-            color_frame_provider = std::make_unique<VideoCam>(VideoCam::CamType::MYNT_EYE_SINGLE, VideoCam::IO_Method::MMAP, "/dev/video0");
+            VideoCam::CamType color_cam_type = (enable_stereo) ? VideoCam::CamType::MYNT_EYE_STEREO : VideoCam::CamType::MYNT_EYE_SINGLE;
+            color_frame_provider = std::make_unique<VideoCam>(color_cam_type, VideoCam::IO_Method::MMAP, "/dev/video0");
             color_frame_provider->startStream();
         } catch (const std::runtime_error& error) {
             LOGW("No camera device found, running without framegrabbers!");
@@ -181,17 +209,51 @@ int main(int argc, char *argv[]) {
         color_frame_provider->startStream();
     }
 
+    /* Capture the color frames once, for every consumer (only the transmitter for now). */
+    if (color_frame_provider) {
+        color_frame_hub = std::make_unique<FrameHub>(color_frame_provider.get());
+        color_stream_frames = color_frame_hub->subscribe();
+        color_frame_hub->startStream();
+    }
+
     /* Setup Video Transmitters. */
     if (enable_depth) {
-        depth_frame_transmitter = std::make_unique<VideoTransmitter>("udp://" + remote_ip + ":8998", depth_frame_provider.get());
+        /* Lossless at half resolution (nearest neighbour), which keeps full precision at a sustainable bitrate. */
+        EncoderConfig depth_config;
+        depth_config.width  = 640;
+        depth_config.height = 360;
+        depth_config.format = PixelFormat::DEPTH16;
+        depth_config.codec  = AV_CODEC_ID_FFV1;
+
+        /* Raw 640x360 depth is 37 Mbit/s at 10 FPS (110 at the camera's 30), which FFV1 typically compresses 2-3x:
+         * cap the frame rate to fit the link (the transmitter logs the actual bitrate). */
+        if (depth_fps > 0) {
+            depth_config.fps = depth_fps;
+        }
+        depth_frame_transmitter = std::make_unique<VideoTransmitter>("udp://" + remote_ip + ":8998", depth_frame_provider.get(), depth_config, false);
+        depth_frame_transmitter->setMaxFrameRate(depth_fps);
         depth_frame_transmitter->thread();
     }
 
-    color_frame_transmitter = std::make_unique<VideoTransmitter>("udp://" + remote_ip + ":8999", color_frame_provider.get());
+    EncoderConfig color_config = low_delay ? EncoderConfig().lowDelay() : EncoderConfig();
+    color_frame_transmitter = std::make_unique<VideoTransmitter>("udp://" + remote_ip + ":8999", color_stream_frames.get(), color_config, true, enable_stereo);
+
+    /* Record the same packets as streamed (no extra encoding). */
+    if (!record_directory.empty()) {
+        color_frame_recorder = std::make_unique<VideoRecorder>(record_directory);
+        color_frame_recorder->thread();
+        color_frame_transmitter->record(color_frame_recorder.get());
+    }
     color_frame_transmitter->thread();
 
+    /* Route the remote's video feedback to the transmitters (each only listens to its own stream). */
+    VideoFeedbackSplitter video_feedback_sink = {{color_frame_transmitter.get()}};
+    if (depth_frame_transmitter) {
+        video_feedback_sink.add(depth_frame_transmitter.get());
+    }
+
     /* Setup LAN connection. */
-    robot::Remote remote = {2556, arduino_driver.get()};
+    robot::Remote remote = {2556, arduino_driver.get(), &video_feedback_sink};
     remote.connect();
     remote.start();
 
@@ -0,0 +1,133 @@
+/**
+ * @file bench_image.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Benchmarks every supported image conversion, at the resolutions used by the application.
+ *
+ * @details Registers 'copyFrom/<src>/<dst>/<width>x<height>' and 'to/<src>/<dst>/<width>x<height>' for every pair
+ * ImageView::canConvert() accepts, and reports their throughput as:
+ *  - MPix:    Megapixels converted per second.
+ *  - B/cycle: Bytes read & written per (nominal) CPU cycle.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Benchmark Inferastructure */
+#include <benchmark/benchmark.h>
+
+/* Standard C++ Libraries */
+#include <cstdlib>  // rand()
+#include <string>
+#include <chrono>
+
+/* Custom C++ Libraries */
+#include "video/image.h"
+
+
+/* ================== Helpers ================== */
+static const PixelFormat FORMATS[] = {
+    PixelFormat::YUV, PixelFormat::YUV420P, PixelFormat::YUV422, PixelFormat::YUV422P, PixelFormat::GREY,
+    PixelFormat::DEPTH16, PixelFormat::RGB24, PixelFormat::RGBA, PixelFormat::NV12
+};
+
+static const int RESOLUTIONS[][2] = {
+    {640, 480},   // Depth stream.
+    {1280, 720},  // Single camera.
+    {2560, 720},  // Side by side stereo camera.
+};
+
+static std::string formatName(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::YUV:     return "YUV";
+        case PixelFormat::YUV420P: return "YUV420P";
+        case PixelFormat::YUV422:  return "YUV422";
+        case PixelFormat::YUV422P: return "YUV422P";
+        case PixelFormat::GREY:    return "GREY";
+        case PixelFormat::DEPTH16: return "DEPTH16";
+        case PixelFormat::RGB24:   return "RGB24";
+        case PixelFormat::RGBA:    return "RGBA";
+        case PixelFormat::NV12:    return "NV12";
+        default:                   return "EMPTY";
+    }
+}
+
+static Image makeImage(int width, int height, PixelFormat format) {
+    /* Noise, so no kernel can take a shortcut. */
+    Image image = {width, height, format};
+    for (size_t idx = 0; idx < image.getSize(); idx++) { image.getData(0)[idx] = static_cast<uint8_t>(rand()); }
+    return image;
+}
+
+/**
+ * @param seconds: Time spent in the measured code, over all iterations.
+ */
+static void setCounters(benchmark::State& state, Image& src, Image& dst, double seconds) {
+    double pixels = static_cast<double>(src.getWidth()) * src.getHeight() * state.iterations();
+    double bytes  = static_cast<double>(src.getSize() + dst.getSize()) * state.iterations();
+    double cycles = benchmark::CPUInfo::Get().cycles_per_second * seconds;
+
+    state.counters["MPix"]    = benchmark::Counter(pixels / 1e6, benchmark::Counter::kIsRate);  // Divided by the run time.
+    state.counters["B/cycle"] = benchmark::Counter(bytes / cycles);
+}
+
+
+/* ================ Benchmarks ================= */
+static void benchCopyFrom(benchmark::State& state, PixelFormat src_format, PixelFormat dst_format, int width, int height) {
+    Image src = makeImage(width, height, src_format);
+    Image dst = makeImage(width, height, dst_format);
+    ImageView src_view = src.view();
+    ImageView dst_view = dst.view();
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto _ : state) {
+        dst_view.copyFrom(src_view);
+        benchmark::DoNotOptimize(dst.getData(0));
+        benchmark::ClobberMemory();
+    }
+    setCounters(state, src, dst, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+static void benchTo(benchmark::State& state, PixelFormat src_format, PixelFormat dst_format, int width, int height) {
+    /* Includes allocating the new image, as the application does. */
+    Image src = makeImage(width, height, src_format);
+    Image dst = makeImage(width, height, dst_format);
+
+    double seconds = 0.0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        Image image = src;
+        state.ResumeTiming();
+
+        auto start = std::chrono::steady_clock::now();
+        image.to(dst_format);
+        benchmark::DoNotOptimize(image.getData(0));
+        seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    setCounters(state, src, dst, seconds);
+}
+
+
+/* =================== Main ==================== */
+int main(int argc, char** argv) {
+    for (auto const& resolution: RESOLUTIONS) {
+        int width = resolution[0], height = resolution[1];
+        std::string size = std::to_string(width) + "x" + std::to_string(height);
+
+        for (PixelFormat src: FORMATS) {
+            for (PixelFormat dst: FORMATS) {
+                if (!ImageView::canConvert(src, dst)) { continue; }
+
+                std::string pair = formatName(src) + "/" + formatName(dst) + "/" + size;
+                benchmark::RegisterBenchmark(("copyFrom/" + pair).c_str(), benchCopyFrom, src, dst, width, height)->Unit(benchmark::kMicrosecond);
+                if (src != dst) {  // Image::to() is a no-op for the same format.
+                    benchmark::RegisterBenchmark(("to/" + pair).c_str(), benchTo, src, dst, width, height)->Unit(benchmark::kMicrosecond);
+                }
+            }
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
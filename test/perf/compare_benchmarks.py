@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Runs a Google Benchmark executable, and compares its results against a recorded JSON baseline.
+
+Fails (exit code 1) when any benchmark got slower than the baseline by more than the tolerance.
+Skips (exit code 77, before running anything) when the baseline does not exist, record it with --update.
+
+Usage:
+    compare_benchmarks.py <benchmark_exe> <baseline.json> [--tolerance 10] [--update] [-- <benchmark args>]
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+
+SKIP_RETURN_CODE = 77  # See the perf test's SKIP_RETURN_CODE.
+
+
+def run_benchmark(executable, extra_args):
+    """Run the benchmark, and return its JSON report."""
+    with tempfile.TemporaryDirectory() as tmp_dir:
+        out_path = os.path.join(tmp_dir, "results.json")
+        command = [
+            executable,
+            f"--benchmark_out={out_path}",
+            "--benchmark_out_format=json",
+            "--benchmark_repetitions=3",
+            "--benchmark_report_aggregates_only=true",
+        ] + extra_args
+        subprocess.run(command, check=True)
+        with open(out_path) as file:
+            return json.load(file)
+
+
+def medians(report):
+    """Map every benchmark name to the median of its (cpu) time per iteration."""
+    times = {}
+    for entry in report["benchmarks"]:
+        if entry.get("aggregate_name") == "median":
+            times[entry["run_name"]] = entry["cpu_time"]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Compare a benchmark run against a JSON baseline.")
+    parser.add_argument("executable", help="Google Benchmark executable to run.")
+    parser.add_argument("baseline", help="Baseline JSON report.")
+    parser.add_argument("--tolerance", type=float, default=10.0, help="Allowed slow down, in percent.")
+    parser.add_argument("--update", action="store_true", help="Record a new baseline, instead of comparing.")
+
+    # Everything after '--' is passed on to the benchmark.
+    argv = sys.argv[1:]
+    split = argv.index("--") if "--" in argv else len(argv)
+    args = parser.parse_args(argv[:split])
+    benchmark_args = argv[split + 1:]
+
+    if not args.update and not os.path.exists(args.baseline):
+        print(f"No baseline at {args.baseline}, skipped (record one with --update).")
+        return SKIP_RETURN_CODE
+
+    report = run_benchmark(args.executable, benchmark_args)
+
+    if args.update:
+        os.makedirs(os.path.dirname(os.path.abspath(args.baseline)), exist_ok=True)
+        with open(args.baseline, "w") as file:
+            json.dump(report, file, indent=2)
+        print(f"Recorded baseline: {args.baseline}")
+        return 0
+
+    with open(args.baseline) as file:
+        baseline = medians(json.load(file))
+    current = medians(report)
+
+    regressions = []
+    print(f"{'Benchmark':<48} {'Baseline':>12} {'Current':>12} {'Change':>8}")
+    for name, time in sorted(current.items()):
+        if name not in baseline:
+            print(f"{name:<48} {'-':>12} {time:>12.1f} {'new':>8}")
+            continue
+
+        change = 100.0 * (time - baseline[name]) / baseline[name]
+        print(f"{name:<48} {baseline[name]:>12.1f} {time:>12.1f} {change:>+7.1f}%")
+        if change > args.tolerance:
+            regressions.append((name, change))
+
+    if regressions:
+        print(f"\n{len(regressions)} benchmark(s) regressed by more than {args.tolerance}%:")
+        for name, change in regressions:
+            print(f"  {name}: {change:+.1f}%")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
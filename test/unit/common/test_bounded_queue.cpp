@@ -0,0 +1,127 @@
+/**
+ * @file test_bounded_queue.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Unit tests for the bounded queue functionality.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  // 
+
+/* Standard C++ Libraries */
+#include <thread>
+#include <string>
+
+/* Custom C++ Libraries */
+#include "common/bounded_queue.h"
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestBoundedQueue, FirstInFirstOut) {
+    /* Setup */
+    BoundedQueue<int> queue = {4};
+    int value = 0;
+
+    /* Execute */
+    queue.push(1);
+    queue.push(2);
+    queue.push(3);
+
+    /* Validate */
+    EXPECT_EQ(queue.size(), 3);
+    EXPECT_TRUE(queue.pop(value, 0));
+    EXPECT_EQ(value, 1);
+    EXPECT_TRUE(queue.pop(value, 0));
+    EXPECT_EQ(value, 2);
+    EXPECT_TRUE(queue.tryPop(value));
+    EXPECT_EQ(value, 3);
+    EXPECT_FALSE(queue.tryPop(value));
+}
+
+TEST(TestBoundedQueue, PopTimesOutWhenEmpty) {
+    /* Setup */
+    BoundedQueue<int> queue = {1};
+    int value = 7;
+
+    /* Execute */
+    bool popped = queue.pop(value, 10);
+
+    /* Validate */
+    EXPECT_FALSE(popped);
+    EXPECT_EQ(value, 7);
+}
+
+TEST(TestBoundedQueue, PushBlocksWhileFull) {
+    /* Setup */
+    BoundedQueue<int> queue = {1};
+    queue.push(1);
+
+    /* Execute */
+    std::thread producer = std::thread([&queue]{ queue.push(2); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    size_t size_while_blocked = queue.size();
+
+    int first = 0, second = 0;
+    queue.pop(first, 100);
+    queue.pop(second, 100);
+    producer.join();
+
+    /* Validate */
+    EXPECT_EQ(size_while_blocked, 1);
+    EXPECT_EQ(first, 1);
+    EXPECT_EQ(second, 2);
+}
+
+TEST(TestBoundedQueue, CloseWakesBlockedThreads) {
+    /* Setup */
+    BoundedQueue<int> queue = {1};
+    queue.push(1);
+    bool pushed = true;
+
+    /* Execute */
+    std::thread producer = std::thread([&queue, &pushed]{ pushed = queue.push(2); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    producer.join();
+
+    /* Validate: remaining items are still drained after closing. */
+    int value = 0;
+    EXPECT_FALSE(pushed);
+    EXPECT_TRUE(queue.pop(value, 1000));
+    EXPECT_EQ(value, 1);
+    EXPECT_FALSE(queue.pop(value, 1000));
+}
+
+TEST(TestBoundedQueue, ReopenAcceptsItemsAgain) {
+    /* Setup */
+    BoundedQueue<int> queue = {2};
+    queue.close();
+    EXPECT_FALSE(queue.push(1));
+
+    /* Execute */
+    queue.reopen();
+    bool pushed = queue.push(2);
+
+    /* Validate */
+    int value = 0;
+    EXPECT_TRUE(pushed);
+    EXPECT_TRUE(queue.pop(value, 1000));
+    EXPECT_EQ(value, 2);
+}
+
+TEST(TestBoundedQueue, TimedPushKeepsItemOnTimeout) {
+    /* Setup */
+    BoundedQueue<std::string> queue = {1};
+    queue.push(std::string("first"));
+    std::string item = "second";
+
+    /* Execute */
+    bool pushed = queue.push(item, 10);
+
+    /* Validate */
+    EXPECT_FALSE(pushed);
+    EXPECT_EQ(item, "second");
+    EXPECT_EQ(queue.size(), 1);
+}
@@ -0,0 +1,64 @@
+/**
+ * @file test_clock_sync.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Unit tests for the clock offset estimation.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  // 
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+#include "common/clock_sync.h"
+
+
+/* ============= Tests Declaration ============= */
+/**
+ * @brief Simulate an exchange with a remote clock that is `offset` ahead, and the given one way delays.
+ */
+static void exchange(ClockOffset &clock_offset, int64_t local_time, int64_t offset, int64_t request_delay, int64_t reply_delay) {
+    ClockSync sync = {};
+    sync.t0 = local_time;
+    sync.t1 = local_time + request_delay + offset;
+    sync.t2 = sync.t1 + 50;  // Processing time on the remote.
+    int64_t t3 = sync.t2 - offset + reply_delay;
+    clock_offset.update(sync, t3);
+}
+
+TEST(TestClockSync, InvalidInitially) {
+    /* Setup */
+    ClockOffset clock_offset = {};
+
+    /* Validate */
+    EXPECT_FALSE(clock_offset.valid());
+    EXPECT_EQ(clock_offset.offset(), 0);
+}
+
+TEST(TestClockSync, SymmetricDelayIsExact) {
+    /* Setup */
+    ClockOffset clock_offset = {};
+
+    /* Execute */
+    exchange(clock_offset, 1000000, -123456789, 2000, 2000);
+
+    /* Validate */
+    EXPECT_TRUE(clock_offset.valid());
+    EXPECT_EQ(clock_offset.offset(), -123456789);
+}
+
+TEST(TestClockSync, PrefersShortestRoundTrip) {
+    /* Setup */
+    ClockOffset clock_offset = {};
+
+    /* Execute: one clean exchange, surrounded by exchanges with a queued (slow) reply. */
+    exchange(clock_offset, 1000000, 5000000, 1000, 30000);
+    exchange(clock_offset, 2000000, 5000000, 1000, 1000);
+    exchange(clock_offset, 3000000, 5000000, 1000, 40000);
+
+    /* Validate */
+    EXPECT_EQ(clock_offset.offset(), 5000000);
+}
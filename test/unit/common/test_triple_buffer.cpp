@@ -0,0 +1,87 @@
+/**
+ * @file test_triple_buffer.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Unit tests for the triple buffer functionality.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  // 
+
+/* Standard C++ Libraries */
+#include <thread>
+
+/* Custom C++ Libraries */
+#include "common/triple_buffer.h"
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestTripleBuffer, NoUpdateBeforePublish) {
+    /* Setup */
+    TripleBuffer<int> buffer = {0};
+
+    /* Execute */
+    bool updated = buffer.update();
+
+    /* Validate */
+    EXPECT_FALSE(updated);
+    EXPECT_EQ(buffer.front(), 0);
+}
+
+TEST(TestTripleBuffer, ReaderGetsPublishedValue) {
+    /* Setup */
+    TripleBuffer<int> buffer = {0};
+
+    /* Execute */
+    buffer.back() = 42;
+    buffer.publish();
+
+    /* Validate */
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 42);
+    EXPECT_FALSE(buffer.update());  // Nothing new published.
+    EXPECT_EQ(buffer.front(), 42);
+}
+
+TEST(TestTripleBuffer, ReaderGetsNewestValue) {
+    /* Setup */
+    TripleBuffer<int> buffer = {0};
+
+    /* Execute: publish multiple values without reading them */
+    for (int value = 1; value <= 5; value++) {
+        buffer.back() = value;
+        buffer.publish();
+    }
+
+    /* Validate */
+    EXPECT_TRUE(buffer.update());
+    EXPECT_EQ(buffer.front(), 5);
+}
+
+TEST(TestTripleBuffer, ConcurrentValuesNeverGoBackInTime) {
+    /* Setup */
+    TripleBuffer<int> buffer = {0};
+    const int num_values = 100000;
+
+    /* Execute */
+    std::thread writer([&buffer]() {
+        for (int value = 1; value <= num_values; value++) {
+            buffer.back() = value;
+            buffer.publish();
+        }
+    });
+
+    /* Validate: the reader only ever sees increasing values, and eventually the last one */
+    int last_seen = 0;
+    while (last_seen < num_values) {
+        if (buffer.update()) {
+            EXPECT_GT(buffer.front(), last_seen);
+            last_seen = buffer.front();
+        }
+    }
+
+    writer.join();
+    EXPECT_EQ(last_seen, num_values);
+}
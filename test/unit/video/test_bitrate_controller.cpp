@@ -0,0 +1,138 @@
+/**
+ * @file test_bitrate_controller.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Unit tests for the adaptive bitrate controller.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  // 
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+#include "video/bitrate_controller.h"
+
+
+/* ============= Tests Declaration ============= */
+static VideoFeedback feedback(float loss, float decode_lag=0.005f, float rtt=0.010f) {
+    VideoFeedback report = {};
+    report.frames = 30;
+    report.loss = loss;
+    report.decode_lag = decode_lag;
+    report.rtt = rtt;
+    return report;
+}
+
+TEST(TestBitrateController, StartsAtMaxConfig) {
+    /* Setup */
+    EncoderConfig max_config = {};
+
+    /* Execute */
+    BitrateController controller = {max_config};
+
+    /* Validate */
+    EXPECT_EQ(controller.config(), max_config);
+}
+
+TEST(TestBitrateController, BacksOffOnLoss) {
+    /* Setup */
+    EncoderConfig max_config = {};
+    BitrateController controller = {max_config};
+
+    /* Execute */
+    bool changed = controller.update(feedback(0.1f));
+
+    /* Validate */
+    EXPECT_TRUE(changed);
+    EXPECT_LT(controller.config().bitrate, max_config.bitrate);
+    EXPECT_EQ(controller.config().width, max_config.width);
+}
+
+TEST(TestBitrateController, BacksOffOnQueueing) {
+    /* Setup */
+    EncoderConfig max_config = {};
+    BitrateController controller = {max_config};
+    controller.update(feedback(0.0f, 0.005f, 0.010f));
+
+    /* Execute: RTT grows far above its base value. */
+    bool changed = controller.update(feedback(0.0f, 0.005f, 0.200f));
+
+    /* Validate */
+    EXPECT_TRUE(changed);
+    EXPECT_LT(controller.config().bitrate, max_config.bitrate);
+}
+
+TEST(TestBitrateController, StepsDownAndUpInResolution) {
+    /* Setup */
+    EncoderConfig max_config = {};
+    BitrateController controller = {max_config, 100000};
+
+    /* Execute: sustained loss. */
+    for (int i = 0; i < 10; i++) {
+        controller.update(feedback(0.2f));
+    }
+    EncoderConfig congested = controller.config();
+
+    /* Execute: recovered link. */
+    for (int i = 0; i < 100; i++) {
+        controller.update(feedback(0.0f));
+    }
+
+    /* Validate */
+    EXPECT_GE(congested.bitrate, 100000);
+    EXPECT_LT(congested.width, max_config.width);
+    EXPECT_LT(congested.height, max_config.height);
+    EXPECT_EQ(congested.width % 2, 0);
+    EXPECT_EQ(congested.height % 2, 0);
+    EXPECT_EQ(controller.config(), max_config);
+}
+
+TEST(TestBitrateController, SlowDecoderLowersResolution) {
+    /* Setup */
+    EncoderConfig max_config = {};
+    BitrateController controller = {max_config};
+
+    /* Execute */
+    bool changed = controller.update(feedback(0.0f, 0.100f));
+
+    /* Validate */
+    EXPECT_TRUE(changed);
+    EXPECT_EQ(controller.config().bitrate, max_config.bitrate);
+    EXPECT_LT(controller.config().width, max_config.width);
+}
+
+TEST(TestBitrateController, IgnoresEmptyReports) {
+    /* Setup */
+    EncoderConfig max_config = {};
+    BitrateController controller = {max_config};
+    VideoFeedback report = feedback(1.0f);
+    report.frames = 0;
+
+    /* Execute */
+    bool changed = controller.update(report);
+
+    /* Validate */
+    EXPECT_FALSE(changed);
+    EXPECT_EQ(controller.config(), max_config);
+}
+
+TEST(TestBitrateController, KeepsLowDelaySettings) {
+    /* Setup */
+    EncoderConfig max_config = EncoderConfig().lowDelay();
+    BitrateController controller = {max_config};
+
+    /* Execute: back off in bitrate, and resolution. */
+    controller.update(feedback(0.1f));
+    controller.update(feedback(0.0f, 0.100f));
+
+    /* Validate */
+    EncoderConfig config = controller.config();
+    EXPECT_TRUE(config.intra_refresh);
+    EXPECT_EQ(config.slice_max_size, LOW_DELAY_SLICE_SIZE);
+    EXPECT_EQ(config.vbv_frames, LOW_DELAY_VBV_FRAMES);
+    EXPECT_LT(config.bitrate, max_config.bitrate);
+    EXPECT_TRUE(EncoderConfig().requiresReopen(max_config));  // Switching needs a new encoder.
+}
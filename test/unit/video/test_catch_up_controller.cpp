@@ -0,0 +1,185 @@
+/**
+ * @file test_catch_up_controller.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Unit tests for skipping packets to catch up with live video.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  //
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+#include "video/catch_up_controller.h"
+
+
+/* ================== Helpers ================== */
+#define FRAME_MS   33  // Frame interval of the synthetic stream.
+#define NETWORK_MS 5   // Constant delay of a stream that is live.
+
+static CatchUpController::Packet packet(int64_t dts_ms, bool random_access=false, bool disposable=false) {
+    CatchUpController::Packet info;
+    info.has_dts = true;
+    info.dts_us  = dts_ms * 1000;
+    info.random_access = random_access;
+    info.disposable    = disposable;
+    return info;
+}
+
+/* Feed one second of live stream (ending at dts_ms), so the controller knows where live is. */
+static void feedLive(CatchUpController &controller, int64_t &dts_ms) {
+    for (int idx = 0; idx < 30; idx++, dts_ms += FRAME_MS) {
+        ASSERT_FALSE(controller.skip(packet(dts_ms, idx == 0), false, (dts_ms + NETWORK_MS) * 1000));
+    }
+}
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestCatchUpController, DecodesEverythingWhileLive) {
+    /* Setup */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+
+    /* Execute */
+    feedLive(controller, dts_ms);
+
+    /* Validate */
+    EXPECT_FALSE(controller.active());
+    EXPECT_EQ(controller.catchUps(), 0u);
+    EXPECT_NEAR(controller.lagMs(), 0.0, 1.0);
+}
+
+TEST(TestCatchUpController, StartsWhenFallingBehind) {
+    /* Setup */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+
+    /* Execute: a stall delays the next packet by 300 ms. */
+    bool skipped = controller.skip(packet(dts_ms), false, (dts_ms + NETWORK_MS + 300) * 1000);
+
+    /* Validate */
+    EXPECT_TRUE(skipped);
+    EXPECT_TRUE(controller.active());
+    EXPECT_EQ(controller.catchUps(), 1u);
+    EXPECT_NEAR(controller.lagMs(), 300.0, 1.0);
+}
+
+TEST(TestCatchUpController, StartsOnBacklog) {
+    /* Setup */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+
+    /* Execute: live, but the packet queue is full. */
+    bool skipped = controller.skip(packet(dts_ms), true, (dts_ms + NETWORK_MS) * 1000);
+
+    /* Validate */
+    EXPECT_TRUE(skipped);
+    EXPECT_TRUE(controller.active());
+}
+
+TEST(TestCatchUpController, ResumesAtRandomAccessPoint) {
+    /* Setup: a 300 ms stall, after which the queued packets arrive in a burst. */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+    int64_t dequeue_ms = dts_ms + NETWORK_MS + 300;
+
+    /* Execute & Validate: everything up to the random access point is skipped. */
+    for (int idx = 0; idx < 8; idx++, dts_ms += FRAME_MS, dequeue_ms++) {
+        EXPECT_TRUE(controller.skip(packet(dts_ms), false, dequeue_ms * 1000));
+    }
+    EXPECT_TRUE(controller.active());
+
+    EXPECT_FALSE(controller.skip(packet(dts_ms, true), false, dequeue_ms * 1000));  // ~45 ms behind.
+    dts_ms += FRAME_MS, dequeue_ms++;
+    EXPECT_TRUE(controller.active());
+
+    EXPECT_FALSE(controller.skip(packet(dts_ms), false, dequeue_ms * 1000));  // Within CATCHUP_EXIT_LAG.
+    EXPECT_FALSE(controller.active());
+    EXPECT_EQ(controller.catchUps(), 1u);
+}
+
+TEST(TestCatchUpController, KeepsSkippingAfterRandomAccessPointWhileFarBehind) {
+    /* Setup */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+    int64_t lag_ms = 500;
+
+    /* Execute & Validate: the random access point itself is decoded, the packets after it are not. */
+    EXPECT_TRUE(controller.skip(packet(dts_ms), false, (dts_ms + NETWORK_MS + lag_ms) * 1000));
+    dts_ms += FRAME_MS;
+    EXPECT_FALSE(controller.skip(packet(dts_ms, true), false, (dts_ms + NETWORK_MS + lag_ms) * 1000));
+    dts_ms += FRAME_MS;
+    EXPECT_TRUE(controller.skip(packet(dts_ms), false, (dts_ms + NETWORK_MS + lag_ms) * 1000));
+    EXPECT_TRUE(controller.active());
+}
+
+TEST(TestCatchUpController, DropsDisposableFramesUntilCaughtUp) {
+    /* Setup: resume at a random access point that is still 100 ms behind live. */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+    EXPECT_TRUE(controller.skip(packet(dts_ms), false, (dts_ms + NETWORK_MS + 300) * 1000));
+    dts_ms += FRAME_MS;
+    EXPECT_FALSE(controller.skip(packet(dts_ms, true), false, (dts_ms + NETWORK_MS + 100) * 1000));
+    dts_ms += FRAME_MS;
+
+    /* Execute & Validate: only the frames nothing references are dropped. */
+    EXPECT_TRUE(controller.skip(packet(dts_ms, false, true), false, (dts_ms + NETWORK_MS + 90) * 1000));
+    dts_ms += FRAME_MS;
+    EXPECT_FALSE(controller.skip(packet(dts_ms), false, (dts_ms + NETWORK_MS + 80) * 1000));
+    dts_ms += FRAME_MS;
+    EXPECT_TRUE(controller.active());
+
+    EXPECT_FALSE(controller.skip(packet(dts_ms, false, true), false, (dts_ms + NETWORK_MS + 10) * 1000));
+    EXPECT_FALSE(controller.active());
+}
+
+TEST(TestCatchUpController, GivesUpWithoutRandomAccessPoints) {
+    /* Setup */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+    int64_t lag_ms = 500;
+    int64_t skip_start_ms = dts_ms + NETWORK_MS + lag_ms;
+
+    /* Execute & Validate: skipped for CATCHUP_MAX_SKIP seconds, then decoded in order at the current lag. */
+    int64_t dequeue_ms = skip_start_ms;
+    while (dequeue_ms - skip_start_ms <= static_cast<int64_t>(CATCHUP_MAX_SKIP * 1e3)) {
+        ASSERT_TRUE(controller.skip(packet(dts_ms), false, dequeue_ms * 1000));
+        dts_ms += FRAME_MS;
+        dequeue_ms = dts_ms + NETWORK_MS + lag_ms;
+    }
+
+    EXPECT_FALSE(controller.skip(packet(dts_ms), false, dequeue_ms * 1000));
+    EXPECT_FALSE(controller.active());
+    EXPECT_NEAR(controller.lagMs(), 0.0, 1.0);
+    dts_ms += FRAME_MS;
+
+    EXPECT_FALSE(controller.skip(packet(dts_ms), false, (dts_ms + NETWORK_MS + lag_ms) * 1000));  // The new live.
+    EXPECT_FALSE(controller.active());
+    EXPECT_EQ(controller.catchUps(), 1u);
+}
+
+TEST(TestCatchUpController, ResyncsOnTimestampJump) {
+    /* Setup */
+    CatchUpController controller;
+    int64_t dts_ms = 0;
+    feedLive(controller, dts_ms);
+
+    /* Execute: the transmitter restarted, its timestamps are a minute behind. */
+    int64_t dequeue_ms = dts_ms + NETWORK_MS;
+    bool skipped = controller.skip(packet(dts_ms - 60000, true), false, dequeue_ms * 1000);
+
+    /* Validate */
+    EXPECT_FALSE(skipped);
+    EXPECT_FALSE(controller.active());
+    EXPECT_EQ(controller.lagMs(), 0.0);
+}
@@ -0,0 +1,136 @@
+/**
+ * @file test_frame_hub.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Unit tests for fanning out frames to multiple subscriptions.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  //
+
+/* Standard C++ Libraries */
+#include <memory>
+
+/* Custom C++ Libraries */
+#include "video/frame_hub.h"
+
+
+/* ================== Helpers ================== */
+static Frame makeFrame(uint32_t sequence) {
+    Frame frame;
+    frame.image = Image(16, 8, PixelFormat::YUV422);
+    frame.image.zero();
+    frame.sequence = sequence;
+    return frame;
+}
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestFrameHub, SubscriptionsShareTheSameFrame) {
+    /* Setup */
+    FrameHub hub = FrameHub(nullptr);
+    std::shared_ptr<FrameHub::Subscription> first  = hub.subscribe();
+    std::shared_ptr<FrameHub::Subscription> second = hub.subscribe(4, FrameHub::DropPolicy::DROP_NEWEST);
+
+    /* Execute */
+    hub.publish(makeFrame(1));
+    std::shared_ptr<const Frame> first_frame  = first->next(0);
+    std::shared_ptr<const Frame> second_frame = second->next(0);
+
+    /* Validate */
+    ASSERT_NE(first_frame, nullptr);
+    EXPECT_EQ(first_frame, second_frame);  // One buffer, no copies.
+    EXPECT_EQ(first_frame->sequence, 1u);
+}
+
+TEST(TestFrameHub, LatestSlotKeepsNewestFrame) {
+    /* Setup */
+    FrameHub hub = FrameHub(nullptr);
+    std::shared_ptr<FrameHub::Subscription> latest = hub.subscribe(1, FrameHub::DropPolicy::DROP_OLDEST);
+
+    /* Execute */
+    for (uint32_t sequence = 1; sequence <= 3; sequence++) {
+        hub.publish(makeFrame(sequence));
+    }
+
+    /* Validate */
+    std::shared_ptr<const Frame> frame = latest->next(0);
+    ASSERT_NE(frame, nullptr);
+    EXPECT_EQ(frame->sequence, 3u);
+    EXPECT_EQ(latest->next(0), nullptr);
+    EXPECT_EQ(latest->dropped(), 2u);
+}
+
+TEST(TestFrameHub, QueueDropNewestKeepsOldestFrames) {
+    /* Setup */
+    FrameHub hub = FrameHub(nullptr);
+    std::shared_ptr<FrameHub::Subscription> queue = hub.subscribe(2, FrameHub::DropPolicy::DROP_NEWEST);
+
+    /* Execute */
+    for (uint32_t sequence = 1; sequence <= 4; sequence++) {
+        hub.publish(makeFrame(sequence));
+    }
+
+    /* Validate */
+    EXPECT_EQ(queue->next(0)->sequence, 1u);
+    EXPECT_EQ(queue->next(0)->sequence, 2u);
+    EXPECT_EQ(queue->next(0), nullptr);
+    EXPECT_EQ(queue->dropped(), 2u);
+}
+
+TEST(TestFrameHub, GetFrameConvertsCopy) {
+    /* Setup */
+    FrameHub hub = FrameHub(nullptr);
+    std::shared_ptr<FrameHub::Subscription> subscription = hub.subscribe();
+    hub.publish(makeFrame(7));
+
+    /* Execute */
+    Frame frame = subscription->getFrame(0.0, PixelFormat::YUV);
+
+    /* Validate */
+    EXPECT_EQ(frame.sequence, 7u);
+    EXPECT_EQ(frame.image.getFormat(), PixelFormat::YUV);
+    EXPECT_EQ(frame.image.getWidth(), 16);
+}
+
+TEST(TestFrameHub, GetSharedFrameDoesNotCopy) {
+    /* Setup */
+    FrameHub hub = FrameHub(nullptr);
+    std::shared_ptr<FrameHub::Subscription> first  = hub.subscribe();
+    std::shared_ptr<FrameHub::Subscription> second = hub.subscribe();
+    std::shared_ptr<FrameHub::Subscription> third  = hub.subscribe();
+    hub.publish(makeFrame(3));
+
+    /* Execute */
+    std::shared_ptr<const Frame> shared    = first->getSharedFrame(0.0, PixelFormat::YUV422);
+    std::shared_ptr<const Frame> converted = second->getSharedFrame(0.0, PixelFormat::YUV);
+
+    /* Validate */
+    ASSERT_NE(shared, nullptr);
+    ASSERT_NE(converted, nullptr);
+    EXPECT_EQ(shared, third->next(0));  // The published frame itself.
+    EXPECT_NE(shared, converted);
+    EXPECT_EQ(converted->image.getFormat(), PixelFormat::YUV);
+    EXPECT_EQ(converted->sequence, 3u);
+    EXPECT_EQ(first->getSharedFrame(0.0, PixelFormat::YUV422), nullptr);  // Nothing new.
+}
+
+TEST(TestFrameHub, GetFrameOnlyReturnsNewFrames) {
+    /* Setup */
+    FrameHub hub = FrameHub(nullptr);
+    std::shared_ptr<FrameHub::Subscription> subscription = hub.subscribe();
+    hub.publish(makeFrame(7));
+
+    /* Execute & Validate */
+    EXPECT_TRUE(subscription->waitForFrame(0));
+    EXPECT_EQ(subscription->getFrame(0.0, PixelFormat::YUV422).sequence, 7u);
+
+    EXPECT_FALSE(subscription->waitForFrame(0));
+    EXPECT_EQ(subscription->getFrame(0.0, PixelFormat::YUV422).image.getFormat(), PixelFormat::EMPTY);  // Nothing new.
+
+    hub.publish(makeFrame(8));
+    EXPECT_TRUE(subscription->waitForFrame(0));
+    EXPECT_EQ(subscription->getFrame(0.0, PixelFormat::YUV422).sequence, 8u);
+}
@@ -10,7 +10,8 @@
 #include <gtest/gtest.h>  // 
 
 /* Standard C++ Libraries */
-// None
+#include <cstdlib>  // std::abs()
+#include <vector>
 
 /* Custom C++ Libraries */
 #include "video/image.h"
@@ -58,7 +59,9 @@ TEST(TestImage, CopyImageViewSameFormat) {
 
     // Fill Source Y-Pane with incrementing value
     uint8_t *src_data = image_src.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { src_data[i] = i; };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { src_data[y * image_src.getLinesize() + x] = y * 8 + x; };
+    };
 
     // Fill Destination Y-Pane with 0s
     image_dst.zero();
@@ -68,7 +71,9 @@ TEST(TestImage, CopyImageViewSameFormat) {
 
     /* Validate: Destination Y-Plane equals source Y-Plane */
     uint8_t *dst_data = image_dst.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { EXPECT_EQ(dst_data[i], src_data[i]); };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { EXPECT_EQ(dst_data[y * image_dst.getLinesize() + x], y * 8 + x); };
+    };
 }
 
 TEST(TestImage, CopyImageViewConvertFormat) {
@@ -80,7 +85,9 @@ TEST(TestImage, CopyImageViewConvertFormat) {
 
     // Fill Source Y-Pane with incrementing value
     uint8_t *src_data = image_src.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { src_data[i] = i; };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { src_data[y * image_src.getLinesize() + x] = y * 8 + x; };
+    };
 
     // Fill Destination Y-Pane with 0s
     image_dst.zero();
@@ -90,7 +97,9 @@ TEST(TestImage, CopyImageViewConvertFormat) {
 
     /* Validate: Destination Y values equal source Y-Plane */
     uint8_t *dst_data = image_dst.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { EXPECT_EQ(dst_data[3*i], src_data[i]); };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { EXPECT_EQ(dst_data[y * image_dst.getLinesize() + 3 * x], y * 8 + x); };
+    };
 }
 
 TEST(TestImage, CopyConstructorSameFormat) {
@@ -100,7 +109,9 @@ TEST(TestImage, CopyConstructorSameFormat) {
 
     // Fill Source Y-Pane with incrementing value
     uint8_t *src_data = image_src.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { src_data[i] = i; };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { src_data[y * image_src.getLinesize() + x] = y * 8 + x; };
+    };
 
     /* Execute */
     Image image_dst = Image(view_src);
@@ -109,7 +120,9 @@ TEST(TestImage, CopyConstructorSameFormat) {
     EXPECT_EQ(image_dst.getFormat(), PixelFormat::YUV422P);
     /* Validate: Destination Y-Plane equals source Y-Plane */
     uint8_t *dst_data = image_dst.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { EXPECT_EQ(dst_data[i], src_data[i]); };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { EXPECT_EQ(dst_data[y * image_dst.getLinesize() + x], y * 8 + x); };
+    };
 }
 
 TEST(TestImage, CopyConstructorConvertFormat) {
@@ -119,7 +132,9 @@ TEST(TestImage, CopyConstructorConvertFormat) {
 
     // Fill Source Y-Pane with incrementing value
     uint8_t *src_data = image_src.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { src_data[i] = i; };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { src_data[y * image_src.getLinesize() + x] = y * 8 + x; };
+    };
 
     /* Execute */
     Image image_dst = Image(view_src, PixelFormat::YUV);
@@ -128,7 +143,9 @@ TEST(TestImage, CopyConstructorConvertFormat) {
     EXPECT_EQ(image_dst.getFormat(), PixelFormat::YUV);
     /* Validate: Destination Y-Plane equals source Y-Plane */
     uint8_t *dst_data = image_dst.getData();
-    for (uint8_t i = 0; i < 8*8; i++) { EXPECT_EQ(dst_data[3*i], src_data[i]); };
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 8; x++) { EXPECT_EQ(dst_data[y * image_dst.getLinesize() + 3 * x], y * 8 + x); };
+    };
 }
 
 TEST(TestImage, YUV422toYUV) {
@@ -164,3 +181,328 @@ TEST(TestImage, YUV422toYUV422P) {
     EXPECT_EQ(image.getFormat(), PixelFormat::YUV422P);
 }
 
+TEST(TestImage, YUV420PExactSize) {
+    /* Setup */
+    Image image = {1280, 720, PixelFormat::YUV420P};
+
+    /* Validate: Y plane (1280 x 720) + U & V planes (640 x 360), no padding needed */
+    EXPECT_EQ(image.getSize(), 1280 * 720 * 3 / 2);
+    EXPECT_EQ(image.getLinesize(0), 1280);
+    EXPECT_EQ(image.getLinesize(1), 640);
+    EXPECT_EQ(image.getLinesize(2), 640);
+}
+
+TEST(TestImage, PlanesAndStridesAligned) {
+    /* Setup */
+    Image image = {100, 30, PixelFormat::YUV422P};
+
+    /* Validate */
+    for (int plane = 0; plane < 3; plane++) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(image.getData(plane)) % IMAGE_ALIGNMENT, 0);
+        EXPECT_EQ(image.getLinesize(plane) % IMAGE_ALIGNMENT, 0);
+    }
+    EXPECT_GE(image.getLinesize(0), 100);
+    EXPECT_GE(image.getLinesize(1), 50);
+}
+
+TEST(TestImage, ViewHonorsStrides) {
+    /* Setup */
+    Image image = {100, 4, PixelFormat::YUV422};
+    ImageView view = image.view();
+
+    /* Validate */
+    EXPECT_EQ(view.getLinesize(), image.getLinesize());
+    EXPECT_EQ(view.getLinesize() % IMAGE_ALIGNMENT, 0);
+    EXPECT_EQ(view.getData(), image.getData());
+}
+
+TEST(TestImage, YUV422toYUV420PAveragesChroma) {
+    /* Setup: 40 pixels wide (vector loop + tail), odd height (last row pair is incomplete). */
+    Image image_src = {40, 3, PixelFormat::YUV422};
+    for (int y = 0; y < 3; y++) {
+        uint8_t *row = image_src.getData() + y * image_src.getLinesize();
+        for (int x = 0; x < 40; x += 2) {
+            row[2 * x + 0] = static_cast<uint8_t>(x + y);      // Y1
+            row[2 * x + 1] = static_cast<uint8_t>(10 * y + 1); // U
+            row[2 * x + 2] = static_cast<uint8_t>(x + y + 1);  // Y2
+            row[2 * x + 3] = static_cast<uint8_t>(x);          // V
+        }
+    }
+    Image image_dst = {40, 3, PixelFormat::YUV420P};
+    ImageView view_src = image_src.view();
+    ImageView view_dst = image_dst.view();
+
+    /* Execute */
+    view_dst.copyFrom(view_src);
+
+    /* Validate: Y is copied, U & V are the rounded average of both rows. */
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 40; x++) { EXPECT_EQ(image_dst.getData(0)[y * image_dst.getLinesize(0) + x], x + y); }
+    }
+    for (int x = 0; x < 20; x++) {
+        EXPECT_EQ(image_dst.getData(1)[x], (1 + 11 + 1) / 2);
+        EXPECT_EQ(image_dst.getData(1)[image_dst.getLinesize(1) + x], 21);
+        EXPECT_EQ(image_dst.getData(2)[x], 2 * x);
+    }
+}
+
+TEST(TestImage, YUV422PtoYUV420PAveragesChroma) {
+    /* Setup: odd height (the last chroma row is not averaged). */
+    Image image_src = {6, 3, PixelFormat::YUV422P};
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 6; x++) { image_src.getData(0)[y * image_src.getLinesize(0) + x] = static_cast<uint8_t>(x + y); }
+        for (int x = 0; x < 3; x++) {
+            image_src.getData(1)[y * image_src.getLinesize(1) + x] = static_cast<uint8_t>(10 * y);
+            image_src.getData(2)[y * image_src.getLinesize(2) + x] = static_cast<uint8_t>(x);
+        }
+    }
+    Image image_dst = {6, 3, PixelFormat::YUV420P};
+    ImageView view_src = image_src.view();
+    ImageView view_dst = image_dst.view();
+
+    /* Execute */
+    view_dst.copyFrom(view_src);
+
+    /* Validate */
+    for (int y = 0; y < 3; y++) {
+        for (int x = 0; x < 6; x++) { EXPECT_EQ(image_dst.getData(0)[y * image_dst.getLinesize(0) + x], x + y); }
+    }
+    for (int x = 0; x < 3; x++) {
+        EXPECT_EQ(image_dst.getData(1)[x], 5);
+        EXPECT_EQ(image_dst.getData(1)[image_dst.getLinesize(1) + x], 20);
+        EXPECT_EQ(image_dst.getData(2)[x], x);
+    }
+}
+
+TEST(TestImage, YUV420PtoYUV) {
+    /* Setup */
+    Image image_src = {34, 4, PixelFormat::YUV420P};
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 34; x++) { image_src.getData(0)[y * image_src.getLinesize(0) + x] = static_cast<uint8_t>(x * y); }
+    }
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 17; x++) {
+            image_src.getData(1)[y * image_src.getLinesize(1) + x] = static_cast<uint8_t>(x + y);
+            image_src.getData(2)[y * image_src.getLinesize(2) + x] = static_cast<uint8_t>(100 - x);
+        }
+    }
+
+    ImageView view_src = image_src.view();
+
+    /* Execute */
+    Image image_dst = Image(view_src, PixelFormat::YUV);
+
+    /* Validate */
+    for (int y = 0; y < 4; y++) {
+        uint8_t *row = image_dst.getData() + y * image_dst.getLinesize();
+        for (int x = 0; x < 34; x++) {
+            EXPECT_EQ(row[3 * x + 0], x * y);
+            EXPECT_EQ(row[3 * x + 1], x / 2 + y / 2);
+            EXPECT_EQ(row[3 * x + 2], 100 - x / 2);
+        }
+    }
+}
+
+TEST(TestImage, SubViewSharesData) {
+    /* Setup: side-by-side image, left half 10, right half 20. */
+    Image image = {64, 4, PixelFormat::YUV420P};
+    for (int plane = 0; plane < 3; plane++) {
+        int width  = plane ? 32 : 64;
+        int height = plane ? 2 : 4;
+        for (int y = 0; y < height; y++) {
+            for (int x = 0; x < width; x++) { image.getData(plane)[y * image.getLinesize(plane) + x] = (x < width / 2) ? 10 : 20; }
+        }
+    }
+    ImageView view = image.view();
+
+    /* Execute */
+    ImageView right = view.subView(32, 0, 32, 4);
+    Image right_copy = Image(right);
+
+    /* Validate: same strides, offset data, and only right half values. */
+    EXPECT_EQ(right.getLinesize(0), view.getLinesize(0));
+    EXPECT_EQ(right.getData(0), image.getData(0) + 32);
+    EXPECT_EQ(right.getData(1), image.getData(1) + 16);
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 32; x++) { EXPECT_EQ(right_copy.getData(0)[y * right_copy.getLinesize(0) + x], 20); }
+    }
+    for (int x = 0; x < 16; x++) { EXPECT_EQ(right_copy.getData(2)[x], 20); }
+}
+
+TEST(TestImage, SubViewRejectsInvalidRegions) {
+    /* Setup */
+    Image image = {64, 4, PixelFormat::YUV422};
+    ImageView view = image.view();
+
+    /* Validate */
+    EXPECT_THROW(view.subView(33, 0, 16, 4), std::invalid_argument);  // Splits a YUYV pair.
+    EXPECT_THROW(view.subView(48, 0, 32, 4), std::invalid_argument);  // Out of bounds.
+    EXPECT_NO_THROW(view.subView(32, 1, 32, 3));
+}
+
+TEST(TestImage, DEPTH16CopyIsLossless) {
+    /* Setup: a packed source (stride = width), with values using all 16 bits. */
+    const int width = 5, height = 3;
+    std::vector<uint16_t> source(width * height);
+    for (size_t idx = 0; idx < source.size(); idx++) { source[idx] = static_cast<uint16_t>(idx * 4099); }
+    ImageView source_view = ImageView({reinterpret_cast<uint8_t*>(source.data())}, {width * 2}, width, height, PixelFormat::DEPTH16);
+
+    /* Execute */
+    Image image = Image(source_view);
+
+    /* Validate: aligned rows, identical values. */
+    EXPECT_EQ(image.getLinesize(0) % IMAGE_ALIGNMENT, 0);
+    for (int y = 0; y < height; y++) {
+        uint16_t const* row = reinterpret_cast<uint16_t const*>(image.getData(0) + y * image.getLinesize(0));
+        for (int x = 0; x < width; x++) { EXPECT_EQ(row[x], source[y * width + x]); }
+    }
+}
+
+TEST(TestImage, YUV422toGREYKeepsLuma) {
+    /* Setup: Y = 2 * x, U = 10, V = 20 (wide enough for the vectorized path). */
+    const int width = 38, height = 2;
+    Image image_yuv422 = {width, height, PixelFormat::YUV422};
+    for (int y = 0; y < height; y++) {
+        uint8_t* row = image_yuv422.getData(0) + y * image_yuv422.getLinesize(0);
+        for (int x = 0; x < width; x++) { row[2 * x] = static_cast<uint8_t>(2 * x); row[2 * x + 1] = (x % 2) ? 20 : 10; }
+    }
+
+    /* Execute */
+    image_yuv422.to(PixelFormat::GREY);
+
+    /* Validate: one byte per pixel, only luma. */
+    EXPECT_EQ(image_yuv422.getLinesize(0) % IMAGE_ALIGNMENT, 0);
+    EXPECT_LT(image_yuv422.getLinesize(0), 2 * width);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) { EXPECT_EQ(image_yuv422.getData(0)[y * image_yuv422.getLinesize(0) + x], 2 * x); }
+    }
+}
+
+TEST(TestImage, YUV420PtoRGBMatchesReference) {
+    /* Setup: limited range white (left) and BT.601 red (right). */
+    const int width = 38, height = 2;
+    Image image_yuv = {width, height, PixelFormat::YUV420P};
+    for (int x = 0; x < width; x++) { image_yuv.getData(0)[x] = image_yuv.getData(0)[image_yuv.getLinesize(0) + x] = (x < 20) ? 235 : 81; }
+    for (int x = 0; x < width / 2; x++) {
+        image_yuv.getData(1)[x] = (x < 10) ? 128 : 90;
+        image_yuv.getData(2)[x] = (x < 10) ? 128 : 240;
+    }
+    ImageView view_yuv = image_yuv.view();
+
+    for (PixelFormat format: {PixelFormat::RGB24, PixelFormat::RGBA}) {
+        /* Execute */
+        Image image_rgb = Image(view_yuv, format, ColorSpace::BT601);
+
+        /* Validate */
+        int channels = (format == PixelFormat::RGBA) ? 4 : 3;
+        for (int y = 0; y < height; y++) {
+            uint8_t* row = image_rgb.getData(0) + y * image_rgb.getLinesize(0);
+            for (int x = 0; x < width; x++) {
+                uint8_t* pixel = row + channels * x;
+                int expected[3] = {255, (x < 20) ? 255 : 0, (x < 20) ? 255 : 0};
+                for (int c = 0; c < 3; c++) { EXPECT_LE(std::abs(pixel[c] - expected[c]), 2) << "x " << x << ", channel " << c; }
+                if (channels == 4) { EXPECT_EQ(pixel[3], 255); }
+            }
+        }
+    }
+}
+
+TEST(TestImage, RGBAtoYUVRoundTrip) {
+    /* Setup: colors constant per 2x2 block, so chroma subsampling loses nothing. */
+    const int width = 38, height = 6;
+    Image image_rgba = {width, height, PixelFormat::RGBA};
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            uint8_t* pixel = image_rgba.getData(0) + y * image_rgba.getLinesize(0) + 4 * x;
+            pixel[0] = static_cast<uint8_t>(40 + 9 * (x / 2));
+            pixel[1] = static_cast<uint8_t>(200 - 30 * (y / 2));
+            pixel[2] = static_cast<uint8_t>(60 + 5 * (x / 2) + 20 * (y / 2));
+            pixel[3] = 255;
+        }
+    }
+    ImageView view_rgba = image_rgba.view();
+
+    for (ColorSpace color_space: {ColorSpace::BT601, ColorSpace::BT709}) {
+        for (PixelFormat format: {PixelFormat::YUV420P, PixelFormat::YUV422P, PixelFormat::NV12, PixelFormat::YUV422}) {
+            /* Execute */
+            Image image_yuv = Image(view_rgba, format, color_space);
+            image_yuv.to(PixelFormat::RGBA, color_space);
+
+            /* Validate */
+            for (int y = 0; y < height; y++) {
+                for (int x = 0; x < width; x++) {
+                    uint8_t* expected = image_rgba.getData(0) + y * image_rgba.getLinesize(0) + 4 * x;
+                    uint8_t* actual   = image_yuv.getData(0) + y * image_yuv.getLinesize(0) + 4 * x;
+                    for (int c = 0; c < 4; c++) { 
+                        EXPECT_LE(std::abs(actual[c] - expected[c]), 4) << "format " << static_cast<int>(format) << ", x " << x << ", y " << y << ", channel " << c; 
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(TestImage, NV12RoundTripIsExact) {
+    /* Setup */
+    const int width = 38, height = 6;
+    Image image_yuv = {width, height, PixelFormat::YUV420P};
+    for (size_t idx = 0; idx < image_yuv.getSize(); idx++) { image_yuv.getData(0)[idx] = static_cast<uint8_t>(idx * 7); }
+    ImageView view_yuv = image_yuv.view();
+
+    /* Execute */
+    Image image_nv12 = Image(view_yuv, PixelFormat::NV12);
+    ImageView view_nv12 = image_nv12.view();
+    Image image_back = Image(view_nv12, PixelFormat::YUV420P);
+
+    /* Validate */
+    for (int plane = 0; plane < 3; plane++) {
+        int plane_width  = plane ? width / 2 : width;
+        int plane_height = plane ? height / 2 : height;
+        for (int y = 0; y < plane_height; y++) {
+            for (int x = 0; x < plane_width; x++) {
+                EXPECT_EQ(image_back.getData(plane)[y * image_back.getLinesize(plane) + x], image_yuv.getData(plane)[y * image_yuv.getLinesize(plane) + x]);
+            }
+        }
+    }
+    EXPECT_EQ(image_nv12.getData(1)[1], image_yuv.getData(2)[0]);  // Interleaved as UV pairs.
+}
+
+TEST(TestImage, GREYtoYUV420PHasNeutralChroma) {
+    /* Setup */
+    Image image = {6, 4, PixelFormat::GREY};
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 6; x++) { image.getData(0)[y * image.getLinesize(0) + x] = 100; }
+    }
+
+    /* Execute */
+    image.to(PixelFormat::YUV420P);
+
+    /* Validate */
+    EXPECT_EQ(image.getData(0)[image.getLinesize(0) + 5], 100);
+    for (int plane = 1; plane < 3; plane++) {
+        for (int y = 0; y < 2; y++) {
+            for (int x = 0; x < 3; x++) { EXPECT_EQ(image.getData(plane)[y * image.getLinesize(plane) + x], 128); }
+        }
+    }
+}
+
+TEST(TestImage, YUV422CopyKeepsLastChromaOfUnevenWidth) {
+    /* Setup */
+    const int width = 5, height = 2;
+    Image image_src = {width, height, PixelFormat::YUV422};
+    for (size_t idx = 0; idx < image_src.getSize(); idx++) { image_src.getData(0)[idx] = static_cast<uint8_t>(idx + 1); }
+    ImageView view_src = image_src.view();
+
+    /* Execute */
+    Image image_dst = {width, height, PixelFormat::YUV422};
+    image_dst.zero();
+    ImageView view_dst = image_dst.view();
+    view_dst.copyFrom(view_src);
+
+    /* Validate: the last pixel's pair (YUYV) is copied whole, including its V. */
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < 12; x++) {
+            EXPECT_EQ(image_dst.getData(0)[y * image_dst.getLinesize(0) + x], image_src.getData(0)[y * image_src.getLinesize(0) + x]);
+        }
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file test_image_scaling.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Unit tests for the (fused conversion &) image scaling functionality.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  //
+
+/* Standard C++ Libraries */
+#include <vector>
+
+/* Custom C++ Libraries */
+#include "video/image.h"
+#include "video/simd.h"
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestImageScaling, Average2x2MatchesScalar) {
+    /* Setup: odd width, to also cover the scalar tail after the vector loop. */
+    const int width = 37;
+    std::vector<uint8_t> row0(2 * width), row1(2 * width), dst(width);
+    for (int idx = 0; idx < 2 * width; idx++) {
+        row0[idx] = static_cast<uint8_t>(idx * 7);
+        row1[idx] = static_cast<uint8_t>(255 - idx * 3);
+    }
+
+    /* Execute */
+    simd::average2x2(row0.data(), row1.data(), dst.data(), width);
+
+    /* Validate */
+    for (int x = 0; x < width; x++) {
+        int sum = row0[2 * x] + row0[2 * x + 1] + row1[2 * x] + row1[2 * x + 1];
+        EXPECT_EQ(dst[x], (sum + 2) / 4);
+    }
+}
+
+TEST(TestImageScaling, Average4x4MatchesScalar) {
+    /* Setup */
+    const int width = 21;
+    std::vector<uint8_t> data[4];
+    const uint8_t *rows[4];
+    for (int row = 0; row < 4; row++) {
+        data[row].resize(4 * width);
+        for (int idx = 0; idx < 4 * width; idx++) { data[row][idx] = static_cast<uint8_t>(idx * 13 + row * 71); }
+        rows[row] = data[row].data();
+    }
+    std::vector<uint8_t> dst(width);
+
+    /* Execute */
+    simd::average4x4(rows, dst.data(), width);
+
+    /* Validate */
+    for (int x = 0; x < width; x++) {
+        int sum = 0;
+        for (int row = 0; row < 4; row++) {
+            for (int col = 0; col < 4; col++) { sum += data[row][4 * x + col]; }
+        }
+        EXPECT_EQ(dst[x], (sum + 8) / 16);
+    }
+}
+
+TEST(TestImageScaling, BoxHalvesPlanar) {
+    /* Setup */
+    Image image_src = {64, 32, PixelFormat::YUV420P};
+    Image image_dst = {32, 16, PixelFormat::YUV420P};
+    for (int y = 0; y < 32; y++) {
+        for (int x = 0; x < 64; x++) { image_src.getData(0)[y * image_src.getLinesize(0) + x] = static_cast<uint8_t>(x + y); }
+    }
+    for (int plane = 1; plane < 3; plane++) {
+        for (int y = 0; y < 16; y++) {
+            for (int x = 0; x < 32; x++) { image_src.getData(plane)[y * image_src.getLinesize(plane) + x] = 100; }
+        }
+    }
+    ImageView view_src = image_src.view();
+    ImageView view_dst = image_dst.view();
+
+    /* Execute */
+    view_dst.scaleFrom(view_src);
+
+    /* Validate: average of (2x + 2y) + (2x+1 + 2y) + (2x + 2y+1) + (2x+1 + 2y+1) = 2x + 2y + 1 */
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 32; x++) { EXPECT_EQ(image_dst.getData(0)[y * image_dst.getLinesize(0) + x], 2 * x + 2 * y + 1); }
+    }
+    for (int y = 0; y < 8; y++) {
+        for (int x = 0; x < 16; x++) { EXPECT_EQ(image_dst.getData(1)[y * image_dst.getLinesize(1) + x], 100); }
+    }
+}
+
+TEST(TestImageScaling, BoxQuartersPackedToPlanar) {
+    /* Setup: YUYV with constant chroma, and Y = x. */
+    Image image_src = {64, 16, PixelFormat::YUV422};
+    for (int y = 0; y < 16; y++) {
+        uint8_t *row = image_src.getData() + y * image_src.getLinesize();
+        for (int x = 0; x < 64; x += 2) {
+            row[2 * x + 0] = static_cast<uint8_t>(x);
+            row[2 * x + 1] = 50;
+            row[2 * x + 2] = static_cast<uint8_t>(x + 1);
+            row[2 * x + 3] = 200;
+        }
+    }
+    Image image_dst = {16, 4, PixelFormat::YUV420P};
+    ImageView view_src = image_src.view();
+    ImageView view_dst = image_dst.view();
+
+    /* Execute */
+    view_dst.scaleFrom(view_src);
+
+    /* Validate: average of 4x .. 4x+3 = 4x + 1.5, rounded up. */
+    for (int y = 0; y < 4; y++) {
+        for (int x = 0; x < 16; x++) { EXPECT_EQ(image_dst.getData(0)[y * image_dst.getLinesize(0) + x], 4 * x + 2); }
+    }
+    for (int y = 0; y < 2; y++) {
+        for (int x = 0; x < 8; x++) {
+            EXPECT_EQ(image_dst.getData(1)[y * image_dst.getLinesize(1) + x], 50);
+            EXPECT_EQ(image_dst.getData(2)[y * image_dst.getLinesize(2) + x], 200);
+        }
+    }
+}
+
+TEST(TestImageScaling, BilinearKeepsConstantImage) {
+    /* Setup: a non-integer (0.75) factor. */
+    Image image_src = {64, 48, PixelFormat::YUV422P};
+    for (int plane = 0; plane < 3; plane++) {
+        for (int y = 0; y < 48; y++) {
+            for (int x = 0; x < (plane ? 32 : 64); x++) { image_src.getData(plane)[y * image_src.getLinesize(plane) + x] = 77; }
+        }
+    }
+    Image image_dst = {48, 36, PixelFormat::YUV422P};
+    ImageView view_src = image_src.view();
+    ImageView view_dst = image_dst.view();
+
+    /* Execute */
+    view_dst.scaleFrom(view_src, ScaleFilter::BILINEAR);
+
+    /* Validate */
+    for (int plane = 0; plane < 3; plane++) {
+        for (int y = 0; y < 36; y++) {
+            for (int x = 0; x < (plane ? 24 : 48); x++) { EXPECT_EQ(image_dst.getData(plane)[y * image_dst.getLinesize(plane) + x], 77); }
+        }
+    }
+}
+
+TEST(TestImageScaling, DEPTH16HalvesWithoutMixingDepths) {
+    /* Setup: every pixel holds a unique depth. */
+    Image image_src = {8, 4, PixelFormat::DEPTH16};
+    for (int y = 0; y < 4; y++) {
+        uint16_t* row = reinterpret_cast<uint16_t*>(image_src.getData(0) + y * image_src.getLinesize(0));
+        for (int x = 0; x < 8; x++) { row[x] = static_cast<uint16_t>(1000 * y + x); }
+    }
+    Image image_dst = {4, 2, PixelFormat::DEPTH16};
+    ImageView view_src = image_src.view();
+    ImageView view_dst = image_dst.view();
+
+    /* Execute */
+    view_dst.scaleFrom(view_src, ScaleFilter::BILINEAR);
+
+    /* Validate: picks the second pixel of every 2x2 block (nearest to its center), never an average. */
+    for (int y = 0; y < 2; y++) {
+        uint16_t const* row = reinterpret_cast<uint16_t const*>(image_dst.getData(0) + y * image_dst.getLinesize(0));
+        for (int x = 0; x < 4; x++) { EXPECT_EQ(row[x], 1000 * (2 * y + 1) + (2 * x + 1)); }
+    }
+}
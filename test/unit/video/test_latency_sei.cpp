@@ -0,0 +1,152 @@
+/**
+ * @file test_latency_sei.cpp
+ * @author Kevin Orbie
+ * 
+ * @brief Unit tests for embedding frame timing in an H.264 bitstream.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  // 
+
+/* Standard C++ Libraries */
+#include <vector>
+
+/* Custom C++ Libraries */
+#include "video/latency_sei.h"
+
+
+/* ============= Tests Declaration ============= */
+static LatencyStamp exampleStamp() {
+    LatencyStamp stamp = {};
+    stamp.sequence        = 0x00000001;           // Contains zero bytes, requiring emulation prevention.
+    stamp.capture_us      = 0x0000000000000102;
+    stamp.encode_start_us = 1234567890123;
+    stamp.encode_end_us   = 1234567895000;
+    stamp.send_us         = -5;
+    return stamp;
+}
+
+TEST(TestLatencySEI, RoundTrip) {
+    /* Setup */
+    LatencyStamp stamp = exampleStamp();
+
+    /* Execute */
+    std::vector<uint8_t> nal = buildLatencySEI(stamp);
+    LatencyStamp decoded = {};
+    bool found = extractLatencySEI(nal.data(), nal.size(), decoded);
+
+    /* Validate */
+    EXPECT_TRUE(found);
+    EXPECT_EQ(decoded.sequence, stamp.sequence);
+    EXPECT_EQ(decoded.capture_us, stamp.capture_us);
+    EXPECT_EQ(decoded.encode_start_us, stamp.encode_start_us);
+    EXPECT_EQ(decoded.encode_end_us, stamp.encode_end_us);
+    EXPECT_EQ(decoded.send_us, stamp.send_us);
+}
+
+TEST(TestLatencySEI, NoStartCodeEmulation) {
+    /* Setup */
+    LatencyStamp stamp = {};  // All zeros.
+
+    /* Execute */
+    std::vector<uint8_t> nal = buildLatencySEI(stamp);
+
+    /* Validate: after the start code, no 00 00 00, 00 00 01 or 00 00 02 may appear (00 00 03 is the escape). */
+    for (size_t idx = 4; idx + 2 < nal.size(); idx++) {
+        EXPECT_FALSE(nal[idx] == 0 && nal[idx + 1] == 0 && nal[idx + 2] <= 2) << "at byte " << idx;
+    }
+}
+
+TEST(TestLatencySEI, InsertedBeforeFirstSlice) {
+    /* Setup: SPS, PPS & IDR slice. */
+    std::vector<uint8_t> access_unit = {
+        0x00, 0x00, 0x00, 0x01, 0x67, 0x64, 0x00, 0x1f,  // SPS
+        0x00, 0x00, 0x00, 0x01, 0x68, 0xee, 0x3c, 0x80,  // PPS
+        0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00,  // IDR slice
+    };
+
+    /* Execute */
+    size_t position = findLatencySEIPosition(access_unit.data(), access_unit.size());
+    std::vector<uint8_t> sei = buildLatencySEI(exampleStamp());
+    access_unit.insert(access_unit.begin() + position, sei.begin(), sei.end());
+
+    LatencyStamp decoded = {};
+    bool found = extractLatencySEI(access_unit.data(), access_unit.size(), decoded);
+
+    /* Validate */
+    EXPECT_EQ(position, 16);
+    EXPECT_TRUE(found);
+    EXPECT_EQ(decoded.encode_start_us, exampleStamp().encode_start_us);
+}
+
+TEST(TestLatencySEI, IgnoresOtherSEI) {
+    /* Setup: x264 like user data SEI with another UUID, followed by a slice. */
+    std::vector<uint8_t> access_unit = {0x00, 0x00, 0x00, 0x01, 0x06, 0x05, 0x11};
+    for (int idx = 0; idx < 17; idx++) {
+        access_unit.push_back(0x42);
+    }
+    access_unit.insert(access_unit.end(), {0x80, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x00});
+
+    /* Execute */
+    LatencyStamp decoded = {};
+    bool found = extractLatencySEI(access_unit.data(), access_unit.size(), decoded);
+
+    /* Validate */
+    EXPECT_FALSE(found);
+}
+
+TEST(TestLatencySEI, DisposableOnlyWithoutReferences) {
+    /* Setup: a non-reference P slice (nal_ref_idc 0), and a reference P slice. */
+    std::vector<uint8_t> disposable = {0x00, 0x00, 0x00, 0x01, 0x01, 0x9a, 0x00};
+    std::vector<uint8_t> reference  = {0x00, 0x00, 0x00, 0x01, 0x01, 0x9a, 0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x00};
+    std::vector<uint8_t> no_slices  = {0x00, 0x00, 0x00, 0x01, 0x09, 0xf0};  // Access unit delimiter only.
+
+    /* Execute & Validate */
+    EXPECT_TRUE(isDisposableAccessUnit(disposable.data(), disposable.size()));
+    EXPECT_FALSE(isDisposableAccessUnit(reference.data(), reference.size()));
+    EXPECT_FALSE(isDisposableAccessUnit(no_slices.data(), no_slices.size()));
+}
+
+TEST(TestLatencySEI, RecoveryPointIsRandomAccess) {
+    /* Setup: a latency SEI, then an SEI NAL with another message followed by a recovery point, then a P slice. */
+    std::vector<uint8_t> access_unit = buildLatencySEI(exampleStamp());
+    access_unit.insert(access_unit.end(), {
+        0x00, 0x00, 0x00, 0x01, 0x06,
+        0x01, 0x02, 0x11, 0x22,  // Picture timing (payload type 1, size 2).
+        0x06, 0x01, 0x84,        // Recovery point (payload type 6, size 1).
+        0x80,
+        0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x00,
+    });
+    std::vector<uint8_t> idr      = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00};
+    std::vector<uint8_t> p_slice  = {0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x00};
+
+    /* Execute & Validate */
+    EXPECT_TRUE(isRandomAccessPoint(access_unit.data(), access_unit.size()));
+    EXPECT_TRUE(isRandomAccessPoint(idr.data(), idr.size()));
+    EXPECT_FALSE(isRandomAccessPoint(p_slice.data(), p_slice.size()));
+}
+
+TEST(TestLatencySEI, SplitsOneChunkPerSlice) {
+    /* Setup: SPS, PPS, two IDR slices (first_mb 0 & 40), an SEI and a third slice. */
+    std::vector<uint8_t> access_unit = {
+        0x00, 0x00, 0x00, 0x01, 0x67, 0x64, 0x00, 0x1f,  // SPS
+        0x00, 0x00, 0x00, 0x01, 0x68, 0xee, 0x3c, 0x80,  // PPS
+        0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x80,  // IDR slice, first_mb_in_slice 0
+        0x00, 0x00, 0x01, 0x65, 0x02, 0x94, 0x80,        // IDR slice, first_mb_in_slice 40
+        0x00, 0x00, 0x01, 0x06, 0x06, 0x01, 0x84, 0x80,  // SEI
+        0x00, 0x00, 0x00, 0x01, 0x65, 0x01, 0x4a, 0x80,  // IDR slice, first_mb_in_slice 80
+    };
+
+    /* Execute */
+    std::vector<size_t> chunks = splitSlices(access_unit.data(), access_unit.size());
+
+    /* Validate */
+    ASSERT_EQ(chunks.size(), 3);
+    EXPECT_EQ(chunks[0], 0);
+    EXPECT_EQ(chunks[1], 24);
+    EXPECT_EQ(chunks[2], 31);
+    EXPECT_FALSE(isSliceContinuation(access_unit.data(), access_unit.size()));
+    EXPECT_TRUE(isSliceContinuation(access_unit.data() + chunks[1], chunks[2] - chunks[1]));
+    EXPECT_TRUE(isSliceContinuation(access_unit.data() + chunks[2], access_unit.size() - chunks[2]));
+}
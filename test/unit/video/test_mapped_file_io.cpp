@@ -0,0 +1,156 @@
+/**
+ * @file test_mapped_file_io.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Unit tests for serving a memory-mapped file to libavformat.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  //
+
+/* Standard C Libraries */
+#include <stdlib.h>  // mkstemp()
+#include <unistd.h>  // write(), close(), unlink()
+#include <stdio.h>   // SEEK_SET, SEEK_CUR, SEEK_END
+
+/* Standard C++ Libraries */
+#include <vector>
+#include <string>
+
+/* Custom C++ Libraries */
+#include "video/mapped_file_io.h"
+
+
+/* ================== Helpers ================== */
+/**
+ * @brief A temporary file with the bytes 0, 1, 2, ... (removed when it goes out of scope).
+ */
+class TempFile {
+   public:
+    TempFile(size_t size) {
+        char path[] = "/tmp/test_mapped_file_io_XXXXXX";
+        int fd = mkstemp(path);
+        path_ = path;
+
+        std::vector<uint8_t> data(size);
+        for (size_t idx = 0; idx < size; idx++) { data[idx] = static_cast<uint8_t>(idx); }
+        EXPECT_EQ(write(fd, data.data(), size), static_cast<ssize_t>(size));
+        close(fd);
+    };
+    ~TempFile() { unlink(path_.c_str()); };
+
+    std::string const& path() const { return path_; };
+
+   private:
+    std::string path_;
+};
+
+/* The callbacks libavformat reads through (without the AVIOContext's own buffering). */
+static int readPacket(MappedFileIO &io, uint8_t *buffer, int size) {
+    return io.context()->read_packet(io.context()->opaque, buffer, size);
+}
+
+static int64_t seek(MappedFileIO &io, int64_t offset, int whence) {
+    return io.context()->seek(io.context()->opaque, offset, whence);
+}
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestMappedFileIO, ReadsTheFileInOrder) {
+    /* Setup */
+    TempFile file = TempFile(1000);
+    MappedFileIO io = MappedFileIO(file.path());
+    uint8_t buffer[600] = {};
+
+    /* Execute & Validate */
+    ASSERT_EQ(readPacket(io, buffer, 600), 600);
+    EXPECT_EQ(buffer[0], 0);
+    EXPECT_EQ(buffer[599], static_cast<uint8_t>(599));
+
+    ASSERT_EQ(readPacket(io, buffer, 600), 400);  // Only the rest of the file.
+    EXPECT_EQ(buffer[0], static_cast<uint8_t>(600));
+    EXPECT_EQ(buffer[399], static_cast<uint8_t>(999));
+}
+
+TEST(TestMappedFileIO, SignalsEndOfFile) {
+    /* Setup */
+    TempFile file = TempFile(16);
+    MappedFileIO io = MappedFileIO(file.path());
+    uint8_t buffer[32] = {};
+
+    /* Execute & Validate */
+    EXPECT_EQ(readPacket(io, buffer, 32), 16);
+    EXPECT_EQ(readPacket(io, buffer, 32), AVERROR_EOF);
+
+    EXPECT_EQ(seek(io, 0, SEEK_END), 16);
+    EXPECT_EQ(readPacket(io, buffer, 32), AVERROR_EOF);
+}
+
+TEST(TestMappedFileIO, SeeksFromEveryOrigin) {
+    /* Setup */
+    TempFile file = TempFile(256);
+    MappedFileIO io = MappedFileIO(file.path());
+    uint8_t value = 0;
+
+    /* Execute & Validate */
+    EXPECT_EQ(seek(io, 100, SEEK_SET), 100);
+    ASSERT_EQ(readPacket(io, &value, 1), 1);
+    EXPECT_EQ(value, 100);
+
+    EXPECT_EQ(seek(io, -51, SEEK_CUR), 50);  // From 101.
+    ASSERT_EQ(readPacket(io, &value, 1), 1);
+    EXPECT_EQ(value, 50);
+
+    EXPECT_EQ(seek(io, -6, SEEK_END), 250);
+    ASSERT_EQ(readPacket(io, &value, 1), 1);
+    EXPECT_EQ(value, 250);
+
+    EXPECT_EQ(seek(io, 10, SEEK_SET | AVSEEK_FORCE), 10);
+    ASSERT_EQ(readPacket(io, &value, 1), 1);
+    EXPECT_EQ(value, 10);
+}
+
+TEST(TestMappedFileIO, ReportsSizeWithoutMoving) {
+    /* Setup */
+    TempFile file = TempFile(300);
+    MappedFileIO io = MappedFileIO(file.path());
+    uint8_t value = 0;
+    seek(io, 42, SEEK_SET);
+
+    /* Execute */
+    int64_t size = seek(io, 0, AVSEEK_SIZE);
+
+    /* Validate */
+    EXPECT_EQ(size, 300);
+    ASSERT_EQ(readPacket(io, &value, 1), 1);
+    EXPECT_EQ(value, 42);  // The read position is unchanged.
+}
+
+TEST(TestMappedFileIO, RejectsSeeksOutsideTheFile) {
+    /* Setup */
+    TempFile file = TempFile(64);
+    MappedFileIO io = MappedFileIO(file.path());
+    uint8_t value = 0;
+    seek(io, 8, SEEK_SET);
+
+    /* Execute & Validate */
+    EXPECT_LT(seek(io, -1, SEEK_SET), 0);
+    EXPECT_LT(seek(io, 65, SEEK_SET), 0);
+    EXPECT_LT(seek(io, 1, SEEK_END), 0);
+
+    ASSERT_EQ(readPacket(io, &value, 1), 1);
+    EXPECT_EQ(value, 8);  // The read position is unchanged.
+}
+
+TEST(TestMappedFileIO, OnlyMapsLocalFiles) {
+    /* Setup */
+    TempFile file = TempFile(4);
+
+    /* Execute & Validate */
+    EXPECT_TRUE(MappedFileIO::isLocalFile(file.path()));
+    EXPECT_FALSE(MappedFileIO::isLocalFile("udp://127.0.0.1:8999"));
+    EXPECT_FALSE(MappedFileIO::isLocalFile("/tmp"));  // A directory.
+    EXPECT_FALSE(MappedFileIO::isLocalFile("/tmp/does_not_exist_mapped_file_io"));
+}
@@ -0,0 +1,114 @@
+/**
+ * @file test_synthetic_frame_provider.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Unit tests for generating synthetic frames.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  //
+
+/* Standard C++ Libraries */
+// None
+
+/* Custom C++ Libraries */
+#include "video/synthetic_frame_provider.h"
+
+
+/* ================== Helpers ================== */
+static SyntheticConfig makeConfig(PixelFormat format, double fps, SyntheticConfig::Motion motion=SyntheticConfig::Motion::BOXES) {
+    SyntheticConfig config;
+    config.width  = 320;
+    config.height = 240;
+    config.fps    = fps;
+    config.format = format;
+    config.motion = motion;
+    config.boxes  = 3;
+    return config;
+}
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestSyntheticFrameProvider, CounterRoundTripsInEveryFormat) {
+    const PixelFormat formats[] = {
+        PixelFormat::YUV, PixelFormat::YUV420P, PixelFormat::YUV422, PixelFormat::YUV422P, PixelFormat::GREY,
+        PixelFormat::DEPTH16, PixelFormat::RGB24, PixelFormat::RGBA, PixelFormat::NV12
+    };
+
+    for (PixelFormat format: formats) {
+        /* Setup */
+        SyntheticFrameProvider provider = SyntheticFrameProvider(makeConfig(format, 0.0, SyntheticConfig::Motion::NOISE));
+
+        for (int call = 0; call < 3; call++) {
+            /* Execute */
+            Frame frame = provider.getFrame(0.0, format);
+            uint32_t sequence = 0;
+            bool valid = SyntheticFrameProvider::readCounter(frame.image, sequence);
+
+            /* Validate */
+            EXPECT_EQ(frame.image.getFormat(), format);
+            EXPECT_TRUE(valid) << "format " << static_cast<int>(format);
+            EXPECT_EQ(sequence, frame.sequence) << "format " << static_cast<int>(format);
+        }
+    }
+}
+
+TEST(TestSyntheticFrameProvider, CounterSurvivesConversion) {
+    /* Setup */
+    SyntheticFrameProvider provider = SyntheticFrameProvider(makeConfig(PixelFormat::YUV422, 0.0));
+
+    /* Execute */
+    Frame frame = provider.getFrame(0.0, PixelFormat::YUV420P);
+    uint32_t sequence = 0;
+    bool valid = SyntheticFrameProvider::readCounter(frame.image, sequence);
+
+    /* Validate */
+    EXPECT_EQ(frame.image.getFormat(), PixelFormat::YUV420P);
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(sequence, frame.sequence);
+}
+
+TEST(TestSyntheticFrameProvider, PacesFramesAtTheFrameRate) {
+    /* Setup */
+    SyntheticFrameProvider provider = SyntheticFrameProvider(makeConfig(PixelFormat::YUV422, 10.0));
+
+    /* Execute & Validate */
+    EXPECT_EQ(provider.getFrame(0.00, PixelFormat::YUV422).sequence, 1u);
+    EXPECT_EQ(provider.getFrame(0.05, PixelFormat::YUV422).sequence, 1u);  // Not due yet: the same frame.
+    EXPECT_EQ(provider.getFrame(0.10, PixelFormat::YUV422).sequence, 2u);
+    EXPECT_EQ(provider.getFrame(0.45, PixelFormat::YUV422).sequence, 5u);  // Skips the frames that were missed.
+}
+
+TEST(TestSyntheticFrameProvider, UnpacedGeneratesFrameEveryCall) {
+    /* Setup */
+    SyntheticFrameProvider provider = SyntheticFrameProvider(makeConfig(PixelFormat::YUV422, 0.0));
+
+    /* Execute & Validate */
+    for (uint32_t expected = 1; expected <= 5; expected++) {
+        Frame frame = provider.getFrame(0.0, PixelFormat::YUV422);
+        EXPECT_EQ(frame.sequence, expected);
+        EXPECT_NE(frame.source_id, 0u);
+        EXPECT_NE(frame.timestamp, 0);
+    }
+}
+
+TEST(TestSyntheticFrameProvider, CorruptedCounterFailsChecksum) {
+    /* Setup */
+    SyntheticFrameProvider provider = SyntheticFrameProvider(makeConfig(PixelFormat::GREY, 0.0));
+    Frame frame = provider.getFrame(0.0, PixelFormat::GREY);
+
+    /* Execute: flip the first bit of the counter. */
+    Image image = frame.image;
+    for (int yidx = 0; yidx < SYNTHETIC_COUNTER_HEIGHT; yidx++) {
+        uint8_t* row = image.getData(0) + yidx * image.getLinesize(0);
+        for (int xidx = 0; xidx < image.getWidth() / SYNTHETIC_COUNTER_BITS; xidx++) {
+            row[xidx] = 255 - row[xidx];
+        }
+    }
+    uint32_t sequence = 0;
+
+    /* Validate */
+    EXPECT_FALSE(SyntheticFrameProvider::readCounter(image, sequence));
+}
@@ -0,0 +1,193 @@
+/**
+ * @file test_video_recorder.cpp
+ * @author Kevin Orbie
+ *
+ * @brief Unit tests for remuxing encoded packets into rolling segment files.
+ */
+
+/* ================== Include ================== */
+/* Setup Google Testing Inferastructure */
+#include <gtest/gtest.h>  //
+
+/* Standard C Libraries */
+#include <stdlib.h>  // mkdtemp()
+#include <string.h>  // memset()
+#include <unistd.h>  // unlink(), rmdir()
+#include <dirent.h>  // opendir(), readdir()
+
+/* Standard C++ Libraries */
+#include <vector>
+#include <string>
+
+/* Custom C++ Libraries */
+#include "video/video_recorder.h"
+
+
+/* ================== Helpers ================== */
+static const AVRational TIME_BASE = {1, 1000};  // Milliseconds.
+
+/**
+ * @brief A temporary directory for the segments (removed, with its files, when it goes out of scope).
+ */
+class TempDirectory {
+   public:
+    TempDirectory() {
+        char path[] = "/tmp/test_video_recorder_XXXXXX";
+        EXPECT_NE(mkdtemp(path), nullptr);
+        path_ = path;
+    };
+    ~TempDirectory() {
+        for (std::string const& file: files()) { unlink((path_ + "/" + file).c_str()); }
+        rmdir(path_.c_str());
+    };
+
+    std::vector<std::string> files() const {
+        std::vector<std::string> names;
+        DIR *dir = opendir(path_.c_str());
+        if (!dir) { return names; }
+        for (struct dirent *entry = readdir(dir); entry; entry = readdir(dir)) {
+            if (entry->d_name[0] != '.') { names.push_back(entry->d_name); }
+        }
+        closedir(dir);
+        return names;
+    };
+
+    std::string const& path() const { return path_; };
+
+   private:
+    std::string path_;
+};
+
+/* Codec parameters of a synthetic video stream. */
+static void setStream(VideoRecorder &recorder, int width, int height) {
+    AVCodecContext *context = avcodec_alloc_context3(NULL);
+    ASSERT_NE(context, nullptr);
+    context->codec_type = AVMEDIA_TYPE_VIDEO;
+    context->codec_id   = AV_CODEC_ID_MPEG4;
+    context->pix_fmt    = AV_PIX_FMT_YUV420P;
+    context->width      = width;
+    context->height     = height;
+    context->time_base  = TIME_BASE;
+
+    recorder.setStream(0, context);
+    avcodec_free_context(&context);
+}
+
+/* Queue a synthetic (reference counted) packet with the given timestamp & flags. */
+static void writePacket(VideoRecorder &recorder, int64_t timestamp_ms, bool keyframe) {
+    AVPacket *packet = av_packet_alloc();
+    ASSERT_NE(packet, nullptr);
+    ASSERT_EQ(av_new_packet(packet, 64), 0);
+    memset(packet->data, 0, packet->size);
+    packet->pts   = timestamp_ms;
+    packet->dts   = timestamp_ms;
+    packet->flags = keyframe ? AV_PKT_FLAG_KEY : 0;
+
+    recorder.write(0, packet, TIME_BASE);
+    av_packet_free(&packet);
+}
+
+
+/* ============= Tests Declaration ============= */
+
+TEST(TestVideoRecorder, StartsSegmentAtFirstKeyframe) {
+    /* Setup */
+    TempDirectory directory;
+    VideoRecorder recorder = VideoRecorder(directory.path(), 60.0, "nut");
+    setStream(recorder, 64, 48);
+
+    /* Execute */
+    writePacket(recorder, 0, false);  // Not recordable without a keyframe first.
+    writePacket(recorder, 33, true);
+    writePacket(recorder, 66, false);
+    recorder.iteration();
+    recorder.iteration();
+
+    /* Validate */
+    EXPECT_EQ(recorder.dropped(), 1u);
+    EXPECT_EQ(recorder.segments(), 1u);
+}
+
+TEST(TestVideoRecorder, RotatesOnChangedParameters) {
+    /* Setup */
+    TempDirectory directory;
+    VideoRecorder recorder = VideoRecorder(directory.path(), 60.0, "nut");
+    setStream(recorder, 64, 48);
+    writePacket(recorder, 0, true);
+    writePacket(recorder, 33, false);
+    recorder.iteration();
+    recorder.iteration();
+
+    /* Execute */
+    setStream(recorder, 32, 24);
+    writePacket(recorder, 66, false);  // Still encoded with the old parameters, dropped.
+    writePacket(recorder, 100, true);
+    recorder.iteration();
+    recorder.cleanup();
+
+    /* Validate: a second segment, even when started within the same second. */
+    EXPECT_EQ(recorder.dropped(), 1u);
+    EXPECT_EQ(recorder.segments(), 2u);
+    EXPECT_EQ(directory.files().size(), 2u);
+}
+
+TEST(TestVideoRecorder, KeepsSegmentForUnchangedParameters) {
+    /* Setup */
+    TempDirectory directory;
+    VideoRecorder recorder = VideoRecorder(directory.path(), 60.0, "nut");
+    setStream(recorder, 64, 48);
+    writePacket(recorder, 0, true);
+    recorder.iteration();
+
+    /* Execute */
+    setStream(recorder, 64, 48);
+    writePacket(recorder, 33, false);
+    writePacket(recorder, 66, true);
+    recorder.cleanup();
+
+    /* Validate */
+    EXPECT_EQ(recorder.dropped(), 0u);
+    EXPECT_EQ(recorder.segments(), 1u);
+}
+
+TEST(TestVideoRecorder, RotatesAfterSegmentDuration) {
+    /* Setup */
+    TempDirectory directory;
+    VideoRecorder recorder = VideoRecorder(directory.path(), 1.0, "nut");
+    setStream(recorder, 64, 48);
+
+    /* Execute */
+    writePacket(recorder, 0, true);
+    writePacket(recorder, 1500, false);  // Only rotates at a keyframe.
+    writePacket(recorder, 2000, true);
+    recorder.cleanup();
+
+    /* Validate */
+    EXPECT_EQ(recorder.segments(), 2u);
+}
+
+TEST(TestVideoRecorder, DropsUpToNextKeyframeWhenFull) {
+    /* Setup: fill the queue, without a writer draining it. */
+    TempDirectory directory;
+    VideoRecorder recorder = VideoRecorder(directory.path(), 60.0, "nut");
+    setStream(recorder, 64, 48);
+    writePacket(recorder, 0, true);
+    for (int64_t idx = 1; idx < RECORDER_QUEUE_SIZE; idx++) {
+        writePacket(recorder, idx * 33, false);
+    }
+    ASSERT_EQ(recorder.dropped(), 0u);
+
+    /* Execute & Validate */
+    int64_t timestamp = RECORDER_QUEUE_SIZE * 33;
+    writePacket(recorder, timestamp, false);  // Queue full.
+    EXPECT_EQ(recorder.dropped(), 1u);
+
+    recorder.iteration();  // Space again, but the rest of the GOP is still dropped.
+    recorder.iteration();
+    writePacket(recorder, timestamp += 33, false);
+    EXPECT_EQ(recorder.dropped(), 2u);
+
+    writePacket(recorder, timestamp += 33, true);  // Recording resumes at the keyframe.
+    writePacket(recorder, timestamp += 33, false);
+    EXPECT_EQ(recorder.dropped(), 2u);
+}